@@ -0,0 +1,181 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Base64.hpp"
+
+#include <cstring>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+const char* const ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr v_uint8 INVALID = 0xFF;
+constexpr v_uint8 BLANK = 0xFE;
+constexpr v_uint8 PADDING = 0xFD;
+
+struct Tables {
+
+  /* two chars per 12 bits of input */
+  char pairs[4096][2];
+
+  /* 6-bit value per char or one of INVALID, BLANK, PADDING */
+  v_uint8 values[256];
+
+  Tables() {
+    for(v_int32 i = 0; i < 4096; i ++) {
+      pairs[i][0] = ALPHABET[i >> 6];
+      pairs[i][1] = ALPHABET[i & 0x3F];
+    }
+    std::memset(values, INVALID, sizeof(values));
+    for(v_uint8 i = 0; i < 64; i ++) {
+      values[static_cast<v_uint8>(ALPHABET[i])] = i;
+    }
+    values[static_cast<v_uint8>(' ')] = BLANK;
+    values[static_cast<v_uint8>('\t')] = BLANK;
+    values[static_cast<v_uint8>('\r')] = BLANK;
+    values[static_cast<v_uint8>('\n')] = BLANK;
+    values[static_cast<v_uint8>('=')] = PADDING;
+  }
+
+};
+
+const Tables& getTables() {
+  static const Tables tables;
+  return tables;
+}
+
+}
+
+v_buff_size Base64::encode(const char* data, v_buff_size size, char* out) {
+
+  const auto& tables = getTables();
+  auto bytes = reinterpret_cast<const v_uint8*>(data);
+  auto begin = out;
+
+  v_buff_size i = 0;
+  for(; i + 3 <= size; i += 3) {
+    v_uint32 value = (v_uint32(bytes[i]) << 16) | (v_uint32(bytes[i + 1]) << 8) | v_uint32(bytes[i + 2]);
+    std::memcpy(out, tables.pairs[value >> 12], 2);
+    std::memcpy(out + 2, tables.pairs[value & 0xFFF], 2);
+    out += 4;
+  }
+
+  auto rest = size - i;
+  if(rest > 0) {
+    v_uint32 value = v_uint32(bytes[i]) << 16;
+    if(rest == 2) {
+      value |= v_uint32(bytes[i + 1]) << 8;
+    }
+    std::memcpy(out, tables.pairs[value >> 12], 2);
+    if(rest == 2) {
+      out[2] = ALPHABET[(value >> 6) & 0x3F];
+    } else {
+      out[2] = '=';
+    }
+    out[3] = '=';
+    out += 4;
+  }
+
+  return out - begin;
+
+}
+
+v_buff_size Base64::decode(const char* text, v_buff_size size, char* out) {
+
+  const auto& values = getTables().values;
+  auto chars = reinterpret_cast<const v_uint8*>(text);
+  auto begin = out;
+
+  v_uint32 quad = 0;
+  v_int32 count = 0;
+  v_int32 padding = 0;
+
+  v_buff_size i = 0;
+  while(i < size) {
+
+    /* fast path - whole quads of alphabet chars */
+    if(count == 0 && padding == 0) {
+      while(i + 4 <= size) {
+        auto v0 = values[chars[i]];
+        auto v1 = values[chars[i + 1]];
+        auto v2 = values[chars[i + 2]];
+        auto v3 = values[chars[i + 3]];
+        if((v0 | v1 | v2 | v3) & 0xC0) {
+          break;
+        }
+        v_uint32 value = (v_uint32(v0) << 18) | (v_uint32(v1) << 12) | (v_uint32(v2) << 6) | v_uint32(v3);
+        out[0] = static_cast<char>(value >> 16);
+        out[1] = static_cast<char>(value >> 8);
+        out[2] = static_cast<char>(value);
+        out += 3;
+        i += 4;
+      }
+      if(i >= size) {
+        break;
+      }
+    }
+
+    /* slow path - one char at a time */
+    auto v = values[chars[i ++]];
+
+    if(v == BLANK) {
+      continue;
+    }
+
+    if(v == PADDING) {
+      /* at most two padding chars - at the end of a quad */
+      if(count < 2) {
+        return -1;
+      }
+      padding ++;
+      v = 0;
+    } else if(v == INVALID || padding > 0) {
+      return -1;
+    }
+
+    quad = (quad << 6) | v;
+    count ++;
+
+    if(count == 4) {
+      out[0] = static_cast<char>(quad >> 16);
+      if(padding < 2) out[1] = static_cast<char>(quad >> 8);
+      if(padding < 1) out[2] = static_cast<char>(quad);
+      out += 3 - padding;
+      quad = 0;
+      count = 0;
+    }
+
+  }
+
+  if(count != 0) {
+    return -1;
+  }
+
+  return out - begin;
+
+}
+
+}}
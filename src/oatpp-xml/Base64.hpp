@@ -0,0 +1,81 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_BASE64_HPP
+#define OATPP_XML_BASE64_HPP
+
+#include "oatpp/Types.hpp"
+
+namespace oatpp { namespace xml {
+
+/**
+ * Base64 codec for binary element content - standard alphabet with `=` padding. <br>
+ * Encoding writes four chars per three bytes with two 12-bit table lookups.
+ * Decoding converts four chars per step and takes the slow path only at whitespace and padding,
+ * so line-wrapped base64 is accepted.
+ */
+class Base64 {
+public:
+
+  /**
+   * Get size of the encoded data.
+   * @param size - size of the binary data.
+   * @return
+   */
+  static v_buff_size getEncodedSize(v_buff_size size) {
+    return (size + 2) / 3 * 4;
+  }
+
+  /**
+   * Get max size of the decoded data.
+   * @param size - size of the base64 text.
+   * @return
+   */
+  static v_buff_size getMaxDecodedSize(v_buff_size size) {
+    return size / 4 * 3;
+  }
+
+  /**
+   * Encode data.
+   * @param data - binary data.
+   * @param size - size of the data.
+   * @param out - out buffer of at least &l:Base64::getEncodedSize (); bytes.
+   * @return - size of the encoded data.
+   */
+  static v_buff_size encode(const char* data, v_buff_size size, char* out);
+
+  /**
+   * Decode base64 text. Whitespace is skipped.
+   * @param text - base64 text.
+   * @param size - size of the text.
+   * @param out - out buffer of at least &l:Base64::getMaxDecodedSize (); bytes.
+   * @return - size of the decoded data or `-1` if text is not valid base64.
+   */
+  static v_buff_size decode(const char* text, v_buff_size size, char* out);
+
+};
+
+}}
+
+#endif //OATPP_XML_BASE64_HPP
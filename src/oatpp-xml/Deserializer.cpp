@@ -24,55 +24,284 @@
 
 #include "Deserializer.hpp"
 
+#include "./Base64.hpp"
+#include "./NumberFormat.hpp"
+#include "./Scanner.hpp"
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+
 namespace oatpp { namespace xml {
 
-oatpp::String Deserializer::parseElementName(State& state) {
-  auto data = state.caret->getCurrData();
-  auto size = state.caret->getDataSize() - state.caret->getPosition();
-  for(v_buff_size i = 0; i < size; i ++) {
-    auto c = data[i];
-    if(i > 0 && (c == '/' || c == '>' || c == ' ' || c == '?' || c == '\t' || c == '\n' || c == '\r' || c == '\f')) {
-      state.caret->inc(i);
-      return oatpp::String(data, i);
+namespace {
+
+template<typename T>
+bool setSigned(data::mapping::Tree& tree, const char* text, v_buff_size size) {
+  v_int64 value;
+  if(!NumberFormat::parseInt64(text, size, value) ||
+     value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max())
+  {
+    return false;
+  }
+  tree.setPrimitive<T>(static_cast<T>(value));
+  return true;
+}
+
+template<typename T>
+bool setUnsigned(data::mapping::Tree& tree, const char* text, v_buff_size size) {
+  v_uint64 value;
+  if(!NumberFormat::parseUInt64(text, size, value) || value > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  tree.setPrimitive<T>(static_cast<T>(value));
+  return true;
+}
+
+bool isBlankChar(char c) {
+  return c == ' ' || c == '\r' || c == '\n' || c == '\t' || c == '\f';
+}
+
+/* position right after the terminator */
+v_buff_size skipTo(const char* data, v_buff_size position, v_buff_size size, const char* text, v_buff_size textSize) {
+  auto offset = Scanner::findText(data + position, size - position, text, textSize);
+  return offset < 0 ? -1 : position + offset + textSize;
+}
+
+/* threads parsing chunks of big documents - started on first use and kept for the following calls */
+class ChunkWorkers {
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<std::function<void()>> m_tasks;
+  std::vector<std::thread> m_threads;
+  bool m_stopped = false;
+private:
+
+  void run() {
+    while(true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return !m_tasks.empty() || m_stopped; });
+        if(m_tasks.empty()) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      }
+      task();
     }
-    bool validChar = c >= 'a' && c <= 'z' ||
-                     c >= 'A' && c <= 'Z' ||
-                     c >= '0' && c <= '9' ||
-                     c == ':' || c == '.' || c == '_' || c == '-' ||
-                     c > 127;
-    if(!validChar) {
-      state.errorStack.push("[oatpp::xml::Deserializer::parseElementName()]: Invalid element name '" + oatpp::String(data, i + 1) + "'");
-      return nullptr;
+  }
+
+public:
+
+  ~ChunkWorkers() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopped = true;
+    }
+    m_condition.notify_all();
+    for(auto& thread : m_threads) {
+      thread.join();
     }
   }
-  state.errorStack.push("[oatpp::xml::Deserializer::parseElementName()]: Invalid element name");
-  return nullptr;
+
+  /* task must not throw. The pool grows to the biggest threadsCount requested */
+  void submit(std::function<void()> task, size_t threadsCount) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      while(m_threads.size() < threadsCount) {
+        m_threads.emplace_back(&ChunkWorkers::run, this);
+      }
+      m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+  }
+
+  static ChunkWorkers& getInstance() {
+    static ChunkWorkers workers;
+    return workers;
+  }
+
+};
+
 }
 
-oatpp::String Deserializer::parseAttributeName(State& state) {
+Deserializer::Nodes& Deserializer::Context::pushNodes() {
+  if(m_depth == m_nodesStack.size()) {
+    m_nodesStack.emplace_back();
+  }
+  return m_nodesStack[m_depth ++];
+}
+
+void Deserializer::Context::popNodes() {
+  auto& nodes = m_nodesStack[-- m_depth];
+  nodes.clear();
+  if(nodes.capacity() > MAX_RETAINED_NODES) {
+    Nodes().swap(nodes);
+  }
+}
+
+void Deserializer::Context::reset() {
+  while(m_depth > 0) {
+    popNodes();
+  }
+}
+
+bool Deserializer::checkText(State& state, const char* text, v_buff_size textSize, v_buff_size position) {
+  if(state.config->maxTextSize > 0 && textSize > state.config->maxTextSize) {
+    state.error.set(Error::Code::TEXT_SIZE_LIMIT_EXCEEDED, position);
+    return false;
+  }
+  return checkUtf8(state, text, textSize);
+}
+
+bool Deserializer::checkUtf8(State& state, const char* text, v_buff_size textSize) {
+  if(!state.config->validateUtf8) {
+    return true;
+  }
+  auto offset = Scanner::findInvalidUtf8(text, textSize);
+  if(offset >= 0) {
+    state.error.set(Error::Code::INVALID_UTF8_SEQUENCE, static_cast<v_buff_size>(text - state.caret->getData()) + offset);
+    return false;
+  }
+  return true;
+}
+
+bool Deserializer::countNode(State& state) {
+  state.nodesCount ++;
+  if(state.config->maxNodes > 0 && state.nodesCount > state.config->maxNodes) {
+    state.error.set(Error::Code::NODES_LIMIT_EXCEEDED, state.caret->getPosition());
+    return false;
+  }
+  return true;
+}
+
+bool Deserializer::findTerminator(State& state, const char* text, v_buff_size textSize) {
+  auto position = state.caret->getPosition();
+  auto offset = Scanner::findText(state.caret->getData() + position, state.caret->getDataSize() - position, text, textSize);
+  if(offset < 0) {
+    state.caret->setPosition(state.caret->getDataSize());
+    return false;
+  }
+  state.caret->setPosition(position + offset);
+  return true;
+}
+
+bool Deserializer::skipNode(State& state) {
+
+  const char* terminator;
+  v_buff_size startSize;
+  Error::Code errorCode;
+
+  if(state.config->skipComments && state.caret->isAtText("<!--", 4, false)) {
+    terminator = "-->";
+    startSize = 4;
+    errorCode = Error::Code::UNTERMINATED_COMMENT;
+  } else if(state.config->skipPIs && state.caret->isAtText("<?", 2, false)) {
+    terminator = "?>";
+    startSize = 2;
+    errorCode = Error::Code::UNTERMINATED_PI;
+  } else {
+    return false;
+  }
+
+  auto start = state.caret->getPosition();
+  state.caret->inc(startSize);
+  auto label = state.caret->putLabel();
+
+  auto terminatorSize = static_cast<v_buff_size>(std::strlen(terminator));
+  if(!findTerminator(state, terminator, terminatorSize)) {
+    state.error.set(errorCode, start);
+    return true;
+  }
+
+  if(checkUtf8(state, state.caret->getData() + label.getStartPosition(), label.getSize())) {
+    state.caret->inc(terminatorSize);
+  }
+  return true;
+
+}
+
+bool Deserializer::isSpilled(State& state, v_buff_size textSize) {
+  return state.config->spillThreshold > 0 && textSize > state.config->spillThreshold;
+}
+
+oatpp::String Deserializer::spill(State& state, const char* text, v_buff_size textSize, bool unescape, v_buff_size position) {
+
+  const auto& sink = state.config->spillSink ? state.config->spillSink : FileSpillSink::getDefault();
+
+  oatpp::String handle;
+  bool written;
+
+  try {
+    auto stream = sink->open(handle);
+    if(unescape) {
+      written = Utils::unescapeText(stream.get(), text, textSize);
+    } else {
+      written = stream->writeSimple(text, textSize) == textSize;
+    }
+  } catch (std::exception&) {
+    written = false;
+  }
+
+  if(!written || !handle) {
+    state.error.set(Error::Code::SPILL_FAILED, position);
+    return nullptr;
+  }
+
+  return handle;
+
+}
+
+v_buff_size Deserializer::scanName(State& state, bool isAttribute) {
   auto data = state.caret->getCurrData();
   auto size = state.caret->getDataSize() - state.caret->getPosition();
+  auto maxSize = state.config->maxNameLength;
+  auto errorCode = isAttribute ? Error::Code::INVALID_ATTRIBUTE_NAME : Error::Code::INVALID_ELEMENT_NAME;
+  if(maxSize > 0 && size > maxSize + 1) {
+    size = maxSize + 1;
+  }
+  bool hasNonAscii = false;
   for(v_buff_size i = 0; i < size; i ++) {
     auto c = data[i];
-    if(i > 0 && (c == '=' || c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f')) {
-      state.caret->inc(i);
-      return oatpp::String(data, i);
+    if(i > 0) {
+      bool isTerminator = isAttribute ? c == '=' : (c == '/' || c == '>' || c == '?');
+      if(isTerminator || isBlankChar(c)) {
+        if(hasNonAscii && !checkUtf8(state, data, i)) {
+          return 0;
+        }
+        state.caret->inc(i);
+        return i;
+      }
     }
+    bool isNonAscii = static_cast<v_uint8>(c) >= 0x80;
+    hasNonAscii = hasNonAscii || isNonAscii;
     bool validChar = c >= 'a' && c <= 'z' ||
                      c >= 'A' && c <= 'Z' ||
                      c >= '0' && c <= '9' ||
                      c == ':' || c == '.' || c == '_' || c == '-' ||
-                     c > 127;
+                     isNonAscii;
     if(!validChar) {
-      state.errorStack.push("[oatpp::xml::Deserializer::parseAttributeName()]: Invalid attribute name '" + oatpp::String(data, i + 1) + "'");
-      return nullptr;
+      state.error.set(errorCode, state.caret->getPosition() + i);
+      return 0;
     }
   }
-  state.errorStack.push("[oatpp::xml::Deserializer::parseAttributeName()]: Invalid attribute name");
-  return nullptr;
+  if(size > maxSize && maxSize > 0) {
+    state.error.set(Error::Code::NAME_LENGTH_LIMIT_EXCEEDED, state.caret->getPosition());
+    return 0;
+  }
+  state.error.set(errorCode, state.caret->getDataSize());
+  return 0;
 }
 
-oatpp::String Deserializer::parseAttributeValue(State& state) {
+bool Deserializer::scanAttributeValue(State& state, const char*& value, v_buff_size& valueSize) {
 
   char enclosingChar;
 
@@ -81,79 +310,232 @@ oatpp::String Deserializer::parseAttributeValue(State& state) {
   } else if(state.caret->isAtChar('"')) {
     enclosingChar = '"';
   } else {
-    state.errorStack.push(R"([oatpp::xml::Deserializer::parseElementName()]: "'" or '"' is missing)");
-    return nullptr;
+    state.error.set(Error::Code::ATTRIBUTE_QUOTE_EXPECTED, state.caret->getPosition());
+    return false;
   }
 
+  auto start = state.caret->getPosition();
   state.caret->inc(1);
 
   auto label = state.caret->putLabel();
 
   if(!state.caret->findChar(enclosingChar)) {
-    state.errorStack.push(R"([oatpp::xml::Deserializer::parseElementName()]: Unterminated attribute value)");
-    return nullptr;
+    state.error.set(Error::Code::UNTERMINATED_ATTRIBUTE_VALUE, start);
+    return false;
+  }
+
+  if(!checkText(state, state.caret->getData() + label.getStartPosition(), label.getSize(), start)) {
+    return false;
   }
 
-  auto result = Utils::unescapeText(label.toString(), state.errorStack);
+  value = state.caret->getData() + label.getStartPosition();
+  valueSize = label.getSize();
   state.caret->inc(1);
-  return result;
+  return true;
 
 }
 
-void Deserializer::parseAttributes(State& state) {
+oatpp::String Deserializer::parseElementName(State& state) {
+  auto data = state.caret->getCurrData();
+  auto size = scanName(state, false);
+  if(size == 0) {
+    return nullptr;
+  }
+  return oatpp::String(data, size);
+}
+
+oatpp::String Deserializer::parseAttributeName(State& state) {
+  auto data = state.caret->getCurrData();
+  auto size = scanName(state, true);
+  if(size == 0) {
+    return nullptr;
+  }
+  return oatpp::String(data, size);
+}
+
+oatpp::String Deserializer::parseAttributeValue(State& state) {
+  const char* value;
+  v_buff_size valueSize;
+  if(!scanAttributeValue(state, value, valueSize)) {
+    return nullptr;
+  }
+  return Utils::unescapeText(oatpp::String(value, valueSize), state.errorStack);
+}
+
+bool Deserializer::parseAttribute(State& state, v_buff_size& count, oatpp::String& key, oatpp::String& value) {
 
   auto& caret = state.caret;
-  while(caret->canContinue()) {
+  if(!caret->canContinue()) {
+    return false;
+  }
 
-    caret->skipBlankChars();
-    if(caret->isAtChar('/') || caret->isAtChar('>')) {
-      return;
-    }
+  caret->skipBlankChars();
+  if(caret->isAtChar('/') || caret->isAtChar('>')) {
+    return false;
+  }
 
-    auto key = parseAttributeName(state);
-    if(!state.errorStack.empty()) {
-      state.errorStack.push("[oatpp::xml::Deserializer::parseAttributes()]");
-      return;
-    }
+  count ++;
+  if(state.config->maxAttributes > 0 && count > state.config->maxAttributes) {
+    state.error.set(Error::Code::ATTRIBUTES_LIMIT_EXCEEDED, caret->getPosition());
+    return false;
+  }
 
-    caret->skipBlankChars();
-    if(!caret->canContinueAtChar('=', 1)) {
-      state.errorStack.push("[oatpp::xml::Deserializer::parseAttributes()]: '=' is missing for '" + key + "'");
-      return;
+  key = parseAttributeName(state);
+  if(state.error.isSet()) {
+    return false;
+  }
+
+  caret->skipBlankChars();
+  if(!caret->canContinueAtChar('=', 1)) {
+    state.error.set(Error::Code::ATTRIBUTE_EQUALS_EXPECTED, caret->getPosition());
+    state.error.pushAttribute(key);
+    return false;
+  }
+
+  caret->skipBlankChars();
+  value = parseAttributeValue(state);
+
+  if(state.error.isSet()) {
+    state.error.pushAttribute(key);
+    return false;
+  }
+
+  return true;
+
+}
+
+void Deserializer::parseAttributes(State& state) {
+  oatpp::String key;
+  oatpp::String value;
+  v_buff_size count = 0;
+  while(parseAttribute(state, count, key, value)) {
+    state.tree->attributes()[key] = value;
+  }
+}
+
+oatpp::String Deserializer::resolveName(State& state, const oatpp::String& qname, bool useDefaultNamespace, v_buff_size position) {
+
+  auto data = qname->data();
+  auto size = static_cast<v_buff_size>(qname->size());
+
+  v_buff_size colon = 0;
+  while(colon < size && data[colon] != ':') {
+    colon ++;
+  }
+
+  oatpp::String uri;
+  const char* localName = data;
+  v_buff_size localNameSize = size;
+
+  if(colon < size) {
+    uri = state.namespaces->resolve(data, colon);
+    if(!uri) {
+      state.error.set(Error::Code::UNBOUND_NAMESPACE_PREFIX, position);
+      return nullptr;
     }
+    localName = data + colon + 1;
+    localNameSize = size - colon - 1;
+  } else if(useDefaultNamespace) {
+    uri = state.namespaces->resolve("", 0);
+  }
 
-    caret->skipBlankChars();
-    auto value = parseAttributeValue(state);
+  if(!uri || uri->empty()) {
+    return localNameSize == size ? qname : oatpp::String(localName, localNameSize);
+  }
 
-    if(!state.errorStack.empty()) {
-      state.errorStack.push("[oatpp::xml::Deserializer::parseAttributes()]: key='" + key + "'");
-      return;
+  if(state.config->namespaceMode == NamespaceMode::EXPANDED_NAME) {
+    return NamespaceScope::makeExpandedName(uri, localName, localNameSize);
+  }
+
+  return localNameSize == size ? qname : oatpp::String(localName, localNameSize);
+
+}
+
+void Deserializer::parseNamespacedAttributes(State& state, oatpp::String& name, std::optional<NamespaceScope>& scope, v_buff_size position) {
+
+  /*
+   * Attributes before the first prefixed one resolve to themselves and are stored as-is.
+   * The rest is deferred until all namespace declarations of the element are known.
+   */
+  std::vector<std::pair<oatpp::String, oatpp::String>> deferred;
+  auto& attributes = state.tree->attributes();
+
+  oatpp::String key;
+  oatpp::String value;
+  v_buff_size count = 0;
+  while(parseAttribute(state, count, key, value)) {
+    bool declaration = NamespaceScope::isDeclaration(key);
+    if(declaration) {
+      if(!scope) {
+        scope.emplace(*state.namespaces);
+      }
+      scope->declare(key->size() == 5 ? oatpp::String("") : oatpp::String(key->data() + 6, key->size() - 6), value);
     }
+    if(deferred.empty() && (declaration || std::memchr(key->data(), ':', key->size()) == nullptr)) {
+      attributes[key] = value;
+    } else {
+      deferred.emplace_back(key, value);
+    }
+  }
 
-    state.tree->attributes()[key] = value;
+  if(state.error.isSet()) {
+    return;
+  }
+
+  if(scope) {
+    state.namespaces = &scope.value();
+  }
 
+  name = resolveName(state, name, true, position);
+  if(state.error.isSet()) {
+    return;
+  }
+
+  for(auto& attribute : deferred) {
+    if(NamespaceScope::isDeclaration(attribute.first)) {
+      attributes[attribute.first] = attribute.second;
+      continue;
+    }
+    auto attributeName = resolveName(state, attribute.first, false, position);
+    if(state.error.isSet()) {
+      state.error.pushAttribute(attribute.first);
+      return;
+    }
+    if(attributes.get(attributeName)) {
+      state.error.set(Error::Code::DUPLICATE_ATTRIBUTE, position);
+      state.error.pushAttribute(attribute.first);
+      return;
+    }
+    attributes[attributeName] = attribute.second;
   }
 
 }
 
 void Deserializer::parsePINode(State& state, oatpp::String& name) {
 
+  auto start = state.caret->getPosition();
+
   if(!state.caret->isAtText("<?", 2, true)) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parsePINode()]: '<?' expected");
+    state.error.set(Error::Code::PI_START_EXPECTED, start);
     return;
   }
 
-  name = "?" + parseElementName(state);
-  if(!state.errorStack.empty()) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parsePINode()]");
+  name = parseElementName(state);
+  if(state.error.isSet()) {
     return;
   }
+  name = "?" + name;
 
   state.caret->skipBlankChars();
   auto label = state.caret->putLabel();
 
-  if(!state.caret->findText("?>", 2)) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parsePINode()]: unterminated PI node");
+  if(!findTerminator(state, "?>", 2)) {
+    state.error.set(Error::Code::UNTERMINATED_PI, start);
+    state.error.pushElement(name);
+    return;
+  }
+
+  if(!checkText(state, state.caret->getData() + label.getStartPosition(), label.getSize(), start)) {
     return;
   }
 
@@ -164,15 +546,21 @@ void Deserializer::parsePINode(State& state, oatpp::String& name) {
 
 void Deserializer::parseCommentNode(State& state, oatpp::String& name) {
 
+  auto start = state.caret->getPosition();
+
   if(!state.caret->isAtText("<!--", 4, true)) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseCommentNode()]: '<!--' expected");
+    state.error.set(Error::Code::COMMENT_START_EXPECTED, start);
     return;
   }
 
   auto label = state.caret->putLabel();
 
-  if(!state.caret->findText("-->", 3)) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseCommentNode()]: unterminated comment");
+  if(!findTerminator(state, "-->", 3)) {
+    state.error.set(Error::Code::UNTERMINATED_COMMENT, start);
+    return;
+  }
+
+  if(!checkText(state, state.caret->getData() + label.getStartPosition(), label.getSize(), start)) {
     return;
   }
 
@@ -183,26 +571,121 @@ void Deserializer::parseCommentNode(State& state, oatpp::String& name) {
 }
 
 void Deserializer::parseCDataNode(State& state, oatpp::String& name) {
+
+  auto start = state.caret->getPosition();
+
   if(!state.caret->isAtText("<![CDATA[", 9, true)) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseCDataNode()]: '<![CDATA[' expected");
+    state.error.set(Error::Code::CDATA_START_EXPECTED, start);
     return;
   }
 
   auto label = state.caret->putLabel();
 
-  if(!state.caret->findText("]]>", 3)) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseCDataNode()]: unterminated CDATA node");
+  if(!findTerminator(state, "]]>", 3)) {
+    state.error.set(Error::Code::UNTERMINATED_CDATA, start);
+    return;
+  }
+
+  if(!checkText(state, state.caret->getData() + label.getStartPosition(), label.getSize(), start)) {
+    return;
+  }
+
+  if(isSpilled(state, label.getSize())) {
+    auto handle = spill(state, state.caret->getData() + label.getStartPosition(), label.getSize(), false, start);
+    if(!handle) {
+      return;
+    }
+    state.tree->setString(handle);
+    state.caret->inc(3);
+    name = "!SPILL";
     return;
   }
 
   state.tree->setString(label.toString());
   state.caret->inc(3);
-  name = "!CDATA";
+  name = state.config->mergeCData ? "!TEXT" : "!CDATA";
 }
 
-void Deserializer::parseElementContent(State& state, const oatpp::String& name) {
+bool Deserializer::parseBinaryLeaf(data::mapping::Tree& tree, const char* text, v_buff_size size) {
+
+  /* decode straight from the document - text with entities takes the string path */
+  oatpp::String data(Base64::getMaxDecodedSize(size));
+  auto dataSize = Base64::decode(text, size, &(*data)[0]);
+  if(dataSize < 0) {
+    return false;
+  }
+  data->resize(static_cast<size_t>(dataSize));
+
+  tree.setPairs({});
+  auto& pairs = tree.getPairs();
+  pairs.emplace_back("!BASE64", data::mapping::Tree());
+  pairs.back().second.setString(data);
+
+  return true;
+
+}
+
+bool Deserializer::parseTypedLeaf(data::mapping::Tree& tree, data::mapping::Tree::Type type, const char* text, v_buff_size size) {
 
-  std::vector<std::pair<oatpp::String, data::mapping::Tree>> nodes;
+  while(size > 0 && isBlankChar(text[0])) {
+    text ++;
+    size --;
+  }
+  while(size > 0 && isBlankChar(text[size - 1])) {
+    size --;
+  }
+
+  typedef data::mapping::Tree::Type Type;
+
+  switch (type) {
+
+    case Type::INT_8: return setSigned<v_int8>(tree, text, size);
+    case Type::UINT_8: return setUnsigned<v_uint8>(tree, text, size);
+    case Type::INT_16: return setSigned<v_int16>(tree, text, size);
+    case Type::UINT_16: return setUnsigned<v_uint16>(tree, text, size);
+    case Type::INT_32: return setSigned<v_int32>(tree, text, size);
+    case Type::UINT_32: return setUnsigned<v_uint32>(tree, text, size);
+    case Type::INT_64: return setSigned<v_int64>(tree, text, size);
+    case Type::UINT_64: return setUnsigned<v_uint64>(tree, text, size);
+
+    case Type::FLOAT_32: {
+      v_float32 value;
+      if(!NumberFormat::parseFloat32(text, size, value)) {
+        return false;
+      }
+      tree.setPrimitive<v_float32>(value);
+      return true;
+    }
+
+    case Type::FLOAT_64: {
+      v_float64 value;
+      if(!NumberFormat::parseFloat64(text, size, value)) {
+        return false;
+      }
+      tree.setPrimitive<v_float64>(value);
+      return true;
+    }
+
+    case Type::BOOL: {
+      if((size == 4 && std::memcmp(text, "true", 4) == 0) || (size == 1 && text[0] == '1')) {
+        tree.setPrimitive<bool>(true);
+        return true;
+      }
+      if((size == 5 && std::memcmp(text, "false", 5) == 0) || (size == 1 && text[0] == '0')) {
+        tree.setPrimitive<bool>(false);
+        return true;
+      }
+      return false;
+    }
+
+    default:
+      return false;
+
+  }
+
+}
+
+void Deserializer::parseElementContent(State& state, const oatpp::String& name, Nodes& nodes) {
 
   auto data = state.caret->getData();
   auto size = state.caret->getDataSize();
@@ -210,6 +693,41 @@ void Deserializer::parseElementContent(State& state, const oatpp::String& name)
   bool hasText = false;
   auto label = state.caret->putLabel();
 
+  /* last node is text followed only by skipped nodes - next text and merged CDATA are appended to it */
+  bool afterText = false;
+
+  /* text of a typed leaf is kept raw until we know it's the only node */
+  auto leafType = data::mapping::Tree::Type::UNDEFINED;
+  if(state.config->parseTypedLeaves && state.hints) {
+    leafType = state.hints->getLeafType();
+  }
+  v_buff_size leafStart = 0;
+  v_buff_size leafSize = -1;
+
+  /* merged pieces are collected here and set to the text node once the run of merged pieces ends */
+  std::string merged;
+  v_buff_size mergedIndex = -1;
+
+  auto appendText = [&](const oatpp::String& text) {
+    if(mergedIndex < 0) {
+      if(leafSize >= 0) {
+        nodes[0].second.setString(Utils::unescapeText(oatpp::String(data + leafStart, leafSize), state.errorStack));
+        leafSize = -1;
+      }
+      mergedIndex = static_cast<v_buff_size>(nodes.size()) - 1;
+      const auto& current = nodes.back().second.getString();
+      merged.assign(current->data(), current->size());
+    }
+    merged.append(text->data(), text->size());
+  };
+
+  auto flushText = [&]() {
+    if(mergedIndex >= 0) {
+      nodes[static_cast<size_t>(mergedIndex)].second.setString(oatpp::String(merged.data(), static_cast<v_buff_size>(merged.size())));
+      mergedIndex = -1;
+    }
+  };
+
   v_buff_size i = state.caret->getPosition();
   while( i < size) {
 
@@ -226,50 +744,88 @@ void Deserializer::parseElementContent(State& state, const oatpp::String& name)
 
       state.caret->setPosition(i);
 
-      if(hasText) {
-        auto text = Utils::unescapeText(label.toString(), state.errorStack);
-        if(!state.errorStack.empty()) {
-          state.errorStack.push("[oatpp::xml::Deserializer::parseElementContent()]");
+      /* blank text is kept only when it's appended to the previous text */
+      if(hasText || (afterText && label.getSize() > 0)) {
+        if(!checkText(state, data + label.getStartPosition(), label.getSize(), label.getStartPosition())) {
           return;
         }
-        data::mapping::Tree node;
-        node.setString(text);
-        nodes.emplace_back("!TEXT", std::move(node));
+        if(isSpilled(state, label.getSize())) {
+          if(!countNode(state)) {
+            return;
+          }
+          auto handle = spill(state, data + label.getStartPosition(), label.getSize(), true, label.getStartPosition());
+          if(!handle) {
+            return;
+          }
+          flushText();
+          nodes.emplace_back("!SPILL", data::mapping::Tree());
+          nodes.back().second.setString(handle);
+          afterText = false;
+        } else if(afterText) {
+          appendText(Utils::unescapeText(label.toString(), state.errorStack));
+        } else {
+          if(!countNode(state)) {
+            return;
+          }
+          if(leafType != data::mapping::Tree::Type::UNDEFINED && nodes.empty()) {
+            leafStart = label.getStartPosition();
+            leafSize = label.getSize();
+            nodes.emplace_back("!TEXT", data::mapping::Tree());
+          } else {
+            auto text = Utils::unescapeText(label.toString(), state.errorStack);
+            nodes.emplace_back("!TEXT", data::mapping::Tree());
+            nodes.back().second.setString(text);
+          }
+          afterText = true;
+        }
       }
 
       if(state.caret->isAtText("</", 2, true)) {
         if(!state.caret->isAtText(name->c_str(), static_cast<v_buff_size>(name->size()), true)) {
-          state.errorStack.push("[oatpp::xml::Deserializer::parseElementContent()]: Invalid closing for tag '" + name + "'");
+          state.error.set(Error::Code::INVALID_CLOSING_TAG, i);
           return;
         }
         state.caret->skipBlankChars();
         if(!state.caret->canContinueAtChar('>', 1)) {
-          state.errorStack.push("[oatpp::xml::Deserializer::parseElementContent()]: Invalid closing for tag '" + name + "' - '>' expected.");
+          state.error.set(Error::Code::CLOSING_TAG_END_EXPECTED, state.caret->getPosition());
           return;
         }
         break;
       }
 
-      nodes.emplace_back();
+      if(skipNode(state)) {
+        if(state.error.isSet()) {
+          return;
+        }
+      } else {
 
-      State nestedState;
-      nestedState.caret = state.caret;
-      nestedState.config = state.config;
-      nestedState.tree = &nodes[nodes.size() - 1].second;
+        nodes.emplace_back();
+        auto& node = nodes.back();
 
-      oatpp::String nestedName;
-      parseNode(nestedState, nestedName);
+        auto tree = state.tree;
+        state.tree = &node.second;
+        parseNode(state, node.first);
+        state.tree = tree;
 
-      if(!nestedState.errorStack.empty()) {
-        state.errorStack.splice(nestedState.errorStack);
-        state.errorStack.push("[oatpp::xml::Deserializer::parseElementContent()]");
-        return;
-      }
+        if(state.error.isSet()) {
+          return;
+        }
 
-      nodes[nodes.size() - 1].first = nestedName;
+        /* only merged CDATA comes as text */
+        if(node.first == "!TEXT" && afterText) {
+          auto text = node.second.getString();
+          nodes.pop_back();
+          appendText(text);
+        } else {
+          flushText();
+          afterText = node.first == "!TEXT";
+        }
+
+      }
 
       i = state.caret->getPosition();
       label = state.caret->putLabel();
+      hasText = false;
 
     } else {
       i ++;
@@ -277,50 +833,368 @@ void Deserializer::parseElementContent(State& state, const oatpp::String& name)
 
   }
 
+  flushText();
+
+  if(leafSize >= 0) {
+    auto text = data + leafStart;
+    if(nodes.size() == 1 && parseTypedLeaf(*state.tree, leafType, text, leafSize)) {
+      return;
+    }
+    /* mixed content or not a number - keep text as a string */
+    nodes[0].second.setString(Utils::unescapeText(oatpp::String(text, leafSize), state.errorStack));
+  }
+
   if(!nodes.empty()) {
     if(nodes.size() == 1 && nodes[0].first == "!TEXT") {
       state.tree->setString(nodes[0].second.getString());
     } else {
-      state.tree->setPairs(nodes);
+      /* move nodes to the tree - keep the nodes buffer for reuse */
+      state.tree->setPairs({});
+      auto& pairs = state.tree->getPairs();
+      pairs.reserve(nodes.size());
+      for(auto& node : nodes) {
+        pairs.emplace_back(std::move(node));
+      }
+    }
+  }
+
+}
+
+bool Deserializer::parseLeafContent(State& state, const oatpp::String& name) {
+
+  auto data = state.caret->getData();
+  auto size = state.caret->getDataSize();
+  auto start = state.caret->getPosition();
+
+  auto found = static_cast<const char*>(std::memchr(data + start, '<', static_cast<size_t>(size - start)));
+  if(found == nullptr) {
+    return false;
+  }
+
+  /* leaf only if the first tag is the closing tag of this element */
+  auto i = static_cast<v_buff_size>(found - data);
+  auto nameSize = static_cast<v_buff_size>(name->size());
+  auto end = i + 2 + nameSize;
+  if(end >= size || data[i + 1] != '/' || std::memcmp(data + i + 2, name->data(), static_cast<size_t>(nameSize)) != 0) {
+    return false;
+  }
+  if(data[end] != '>' && !isBlankChar(data[end])) {
+    return false;
+  }
+
+  auto text = data + start;
+  auto textSize = i - start;
+
+  bool hasText = false;
+  for(v_buff_size j = 0; j < textSize; j ++) {
+    if(!isBlankChar(text[j])) {
+      hasText = true;
+      break;
+    }
+  }
+
+  if(hasText) {
+    if(!checkText(state, text, textSize, start) || !countNode(state)) {
+      return true;
+    }
+    if(isSpilled(state, textSize)) {
+      auto handle = spill(state, text, textSize, true, start);
+      if(!handle) {
+        return true;
+      }
+      state.tree->setPairs({});
+      state.tree->getPairs().emplace_back("!SPILL", data::mapping::Tree());
+      state.tree->getPairs().back().second.setString(handle);
+    } else {
+      bool typed = false;
+      if(state.hints) {
+        if(state.hints->isBinary()) {
+          typed = parseBinaryLeaf(*state.tree, text, textSize);
+        } else if(state.config->parseTypedLeaves) {
+          typed = parseTypedLeaf(*state.tree, state.hints->getLeafType(), text, textSize);
+        }
+      }
+      if(!typed) {
+        state.tree->setString(Utils::unescapeText(oatpp::String(text, textSize), state.errorStack));
+      }
     }
   }
 
+  state.caret->setPosition(end);
+  state.caret->skipBlankChars();
+  if(!state.caret->canContinueAtChar('>', 1)) {
+    state.error.set(Error::Code::CLOSING_TAG_END_EXPECTED, state.caret->getPosition());
+  }
+
+  return true;
+
+}
+
+bool Deserializer::splitContent(State& state, v_buff_size chunksCount, Chunks& chunks) {
+
+  auto data = state.caret->getData();
+  auto size = state.caret->getDataSize();
+  auto i = state.caret->getPosition();
+
+  v_buff_size depth = 0;
+  v_buff_size chunkSize = 0;
+  v_buff_size nextBoundary = 0;
+
+  /* light scan - only tags are looked at, text is skipped with memchr */
+  while(i < size) {
+
+    auto found = static_cast<const char*>(std::memchr(data + i, '<', static_cast<size_t>(size - i)));
+    if(found == nullptr) {
+      return false;
+    }
+    i = static_cast<v_buff_size>(found - data);
+
+    auto rest = size - i;
+    bool isElementEnd = false;
+
+    if(rest >= 4 && std::memcmp(found, "<!--", 4) == 0) {
+      i = skipTo(data, i + 4, size, "-->", 3);
+    } else if(rest >= 9 && std::memcmp(found, "<![CDATA[", 9) == 0) {
+      i = skipTo(data, i + 9, size, "]]>", 3);
+    } else if(rest >= 2 && found[1] == '?') {
+      i = skipTo(data, i + 2, size, "?>", 2);
+    } else if(rest >= 2 && found[1] == '!') {
+      return false;
+    } else if(rest >= 2 && found[1] == '/') {
+      if(depth == 0) {
+        return false;
+      }
+      i = skipTo(data, i + 2, size, ">", 1);
+      depth --;
+      if(depth == 0) {
+        /* whole document scanned */
+        return !chunks.boundaries.empty();
+      }
+      isElementEnd = true;
+    } else {
+      auto offset = Scanner::findTagEnd(data + i + 1, size - i - 1);
+      i = offset < 0 ? -1 : i + 1 + offset;
+      if(i > 1 && data[i - 2] == '/') {
+        isElementEnd = true;
+      } else if(i > 0) {
+        depth ++;
+        if(depth == 1) {
+          chunks.contentStart = i;
+          chunkSize = (size - i) / chunksCount;
+          nextBoundary = i + chunkSize;
+        }
+      }
+    }
+
+    if(i < 0) {
+      return false;
+    }
+
+    if(isElementEnd && depth == 1 && i >= nextBoundary) {
+      chunks.boundaries.push_back(i);
+      if(static_cast<v_buff_size>(chunks.boundaries.size()) + 1 == chunksCount) {
+        /* the last chunk runs to the end of the document */
+        return true;
+      }
+      nextBoundary = i + chunkSize;
+    }
+
+  }
+
+  return false;
+
+}
+
+void Deserializer::parseChunks(State& state, const oatpp::String& name) {
+
+  const auto& chunks = *state.chunks;
+  auto count = chunks.boundaries.size() + 1;
+
+  std::vector<data::mapping::Tree> trees(count);
+  std::vector<Error> errors(count);
+  std::vector<v_buff_size> positions(count);
+
+  auto parseChunk = [&](size_t index) {
+
+    auto start = index == 0 ? chunks.contentStart : chunks.boundaries[index - 1];
+    auto end = index + 1 < count ? chunks.boundaries[index] : state.caret->getDataSize();
+
+    /* positions stay relative to the whole document - errors are reported as if parsed serially */
+    utils::parser::Caret caret(state.caret->getData(), end);
+    caret.setPosition(start);
+
+    Context context;
+    State chunkState;
+    chunkState.config = state.config;
+    chunkState.caret = &caret;
+    chunkState.tree = &trees[index];
+    chunkState.context = &context;
+    chunkState.depth = state.depth;
+    chunkState.namespaces = state.namespaces;
+    chunkState.hints = state.hints;
+
+    /* the last chunk ends with the closing tag of the root, others end right after a child element */
+    Nodes nodes;
+    parseElementContent(chunkState, name, nodes);
+
+    errors[index] = std::move(chunkState.error);
+    positions[index] = caret.getPosition();
+
+  };
+
+  /* exceptions are caught in the worker and rethrown in the calling thread once all chunks are done */
+  std::vector<std::exception_ptr> exceptions(count);
+  auto runChunk = [&](size_t index) {
+    try {
+      parseChunk(index);
+    } catch (...) {
+      exceptions[index] = std::current_exception();
+    }
+  };
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t pending = count - 1;
+
+  auto& workers = ChunkWorkers::getInstance();
+  for(size_t index = 1; index < count; index ++) {
+    workers.submit([&, index] {
+      runChunk(index);
+      /* notify under the lock - the caller may leave as soon as it sees the last chunk done */
+      std::lock_guard<std::mutex> lock(mutex);
+      pending --;
+      condition.notify_one();
+    }, count - 1);
+  }
+
+  runChunk(0);
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&pending] { return pending == 0; });
+  }
+
+  for(auto& exception : exceptions) {
+    if(exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  for(size_t index = 0; index < count; index ++) {
+    if(errors[index].isSet()) {
+      state.error = std::move(errors[index]);
+      state.caret->setPosition(positions[index]);
+      return;
+    }
+  }
+
+  state.tree->setPairs({});
+  auto& pairs = state.tree->getPairs();
+  for(auto& tree : trees) {
+    switch(tree.getType()) {
+      case data::mapping::Tree::Type::PAIRS:
+        for(auto& pair : tree.getPairs()) {
+          pairs.emplace_back(std::move(pair));
+        }
+        break;
+      case data::mapping::Tree::Type::STRING:
+        /* chunk with text only - the tail of the root content */
+        pairs.emplace_back("!TEXT", std::move(tree));
+        break;
+      default:
+        break;
+    }
+  }
+
+  state.caret->setPosition(positions[count - 1]);
+
+}
+
+void Deserializer::parseElementContent(State& state, const oatpp::String& name) {
+  if(state.chunks && state.caret->getPosition() == state.chunks->contentStart) {
+    parseChunks(state, name);
+    return;
+  }
+  /* most elements are leaves - <a>text</a> - parse them without the nodes buffer */
+  if(parseLeafContent(state, name)) {
+    return;
+  }
+  if(state.context) {
+    auto& nodes = state.context->pushNodes();
+    parseElementContent(state, name, nodes);
+    state.context->popNodes();
+  } else {
+    Nodes nodes;
+    parseElementContent(state, name, nodes);
+  }
 }
 
 void Deserializer::parseElementNode(State& state, oatpp::String& name) {
 
   if(!state.caret->isAtText("<", 1, true)) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseElementNode()]: '<' expected");
+    state.error.set(Error::Code::ELEMENT_START_EXPECTED, state.caret->getPosition());
     return;
   }
 
-  name = parseElementName(state);
-  if(!state.errorStack.empty()) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseElementNode()]");
+  if(state.config->maxDepth > 0 && state.depth >= state.config->maxDepth) {
+    state.error.set(Error::Code::DEPTH_LIMIT_EXCEEDED, state.caret->getPosition() - 1);
+    return;
+  }
+
+  auto position = state.caret->getPosition();
+  auto qname = parseElementName(state);
+  if(state.error.isSet()) {
     return;
   }
 
-  parseAttributes(state);
-  if(!state.errorStack.empty()) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseElementNode()]: tag='" + name + "'");
+  name = qname;
+
+  auto parentNamespaces = state.namespaces;
+  std::optional<NamespaceScope> scope;
+
+  if(state.config->namespaceMode == NamespaceMode::NONE) {
+    parseAttributes(state);
+  } else {
+    if(parentNamespaces == nullptr) {
+      state.namespaces = &NamespaceScope::getRoot();
+    }
+    parseNamespacedAttributes(state, name, scope, position);
+  }
+
+  if(state.error.isSet()) {
+    state.namespaces = parentNamespaces;
+    state.error.pushElement(qname);
     return;
   }
 
   if(state.caret->isAtChar('/')) {
     if(!(state.caret->canContinueAtChar('/', 1) && state.caret->canContinueAtChar('>', 1))) {
-      state.errorStack.push("[oatpp::xml::Deserializer::parseElementNode()]: tag='" + name + "' - '/>' expected");
+      state.error.set(Error::Code::EMPTY_ELEMENT_END_EXPECTED, state.caret->getPosition());
+      state.error.pushElement(qname);
     }
+    state.namespaces = parentNamespaces;
     return;
   }
 
   if(!state.caret->canContinueAtChar('>', 1)) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseElementNode()]: tag='" + name + "' - '>' expected");
+    state.error.set(Error::Code::ELEMENT_END_EXPECTED, state.caret->getPosition());
+    state.namespaces = parentNamespaces;
+    state.error.pushElement(qname);
     return;
   }
 
-  parseElementContent(state, name);
-  if(!state.errorStack.empty()) {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseElementNode()]: tag='" + name + "'");
+  auto parentHints = state.hints;
+  if(parentHints) {
+    state.hints = parentHints->getChild(name);
+  }
+
+  state.depth ++;
+  parseElementContent(state, qname);
+  state.depth --;
+  state.namespaces = parentNamespaces;
+  state.hints = parentHints;
+  if(state.error.isSet()) {
+    state.error.pushElement(qname);
     return;
   }
 
@@ -328,6 +1202,10 @@ void Deserializer::parseElementNode(State& state, oatpp::String& name) {
 
 void Deserializer::parseNode(State& state, oatpp::String& name) {
 
+  if(!countNode(state)) {
+    return;
+  }
+
   if(state.caret->isAtText("<?", 2, false)) {
     parsePINode(state, name);
   } else if(state.caret->isAtText("<!--", 4, false)) {
@@ -337,7 +1215,7 @@ void Deserializer::parseNode(State& state, oatpp::String& name) {
   } else if( state.caret->isAtChar('<')) {
     parseElementNode(state, name);
   } else {
-    state.errorStack.push("[oatpp::xml::Deserializer::parseNode()]: '<' expected");
+    state.error.set(Error::Code::ELEMENT_START_EXPECTED, state.caret->getPosition());
     return;
   }
 
@@ -345,35 +1223,69 @@ void Deserializer::parseNode(State& state, oatpp::String& name) {
 
 void Deserializer::deserialize(oatpp::xml::Deserializer::State &state) {
 
-  state.tree->setPairs({});
-  auto& pairs = state.tree->getPairs();
+  if(state.context) {
+    state.context->reset();
+  }
+
+  state.depth = 0;
+  state.nodesCount = 0;
+  state.namespaces = nullptr;
+
+  auto maxSize = state.config->maxDocumentSize;
+  if(maxSize > 0 && state.caret->getDataSize() - state.caret->getPosition() > maxSize) {
+    state.error.set(Error::Code::DOCUMENT_SIZE_LIMIT_EXCEEDED, state.caret->getPosition() + maxSize);
+    state.error.renderTo(state.errorStack, "oatpp::xml::Deserializer", state.caret->getData(), state.caret->getDataSize());
+    return;
+  }
+
+  auto tree = state.tree;
+
+  tree->setPairs({});
+  auto& pairs = tree->getPairs();
 
   state.caret->skipBlankChars();
 
+  /* node count limit needs a single counter - always parsed serially */
+  Chunks chunks;
+  auto threads = state.config->parallelThreads;
+  if(threads > 1 && state.config->maxNodes == 0 &&
+     state.caret->getDataSize() - state.caret->getPosition() >= state.config->parallelThreshold &&
+     splitContent(state, threads, chunks))
+  {
+    state.chunks = &chunks;
+  }
+
   while (state.caret->canContinue()) {
 
-    data::mapping::Tree nestedNode;
+    if(skipNode(state)) {
+      if(state.error.isSet()) {
+        state.error.renderTo(state.errorStack, "oatpp::xml::Deserializer", state.caret->getData(), state.caret->getDataSize());
+        break;
+      }
+      state.caret->skipBlankChars();
+      continue;
+    }
 
-    State nestedState;
-    nestedState.caret = state.caret;
-    nestedState.config = state.config;
-    nestedState.tree = &nestedNode;
+    pairs.emplace_back();
+    auto& node = pairs.back();
 
-    oatpp::String nestedName;
-    parseNode(nestedState, nestedName);
+    state.tree = &node.second;
+    parseNode(state, node.first);
+    state.tree = tree;
 
-    if(!nestedState.errorStack.empty()) {
-      state.errorStack.splice(nestedState.errorStack);
-      state.errorStack.push("[oatpp::xml::Deserializer::deserialize()]");
-      return;
+    if(state.error.isSet()) {
+      pairs.pop_back();
+      /* render error only once - when it leaves the deserializer */
+      state.error.renderTo(state.errorStack, "oatpp::xml::Deserializer", state.caret->getData(), state.caret->getDataSize());
+      break;
     }
 
-    pairs.emplace_back(nestedName, std::move(nestedNode));
-
     state.caret->skipBlankChars();
 
   }
 
+  state.chunks = nullptr;
+
 }
 
 
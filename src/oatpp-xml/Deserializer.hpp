@@ -25,6 +25,10 @@
 #ifndef OATPP_XML_DESERIALIZER_HPP
 #define OATPP_XML_DESERIALIZER_HPP
 
+#include "./Error.hpp"
+#include "./NamespaceScope.hpp"
+#include "./SpillSink.hpp"
+#include "./TypeHints.hpp"
 #include "./Utils.hpp"
 
 #include "oatpp/data/mapping/ObjectMapper.hpp"
@@ -33,9 +37,45 @@
 #include "oatpp/utils/parser/Caret.hpp"
 #include "oatpp/Types.hpp"
 
+#include <deque>
+#include <optional>
+#include <vector>
+
 namespace oatpp { namespace xml {
 
+class PullReader;
+
 class Deserializer {
+  friend PullReader;
+public:
+
+  /**
+   * Namespace processing mode.
+   */
+  enum class NamespaceMode : v_int32 {
+
+    /**
+     * No namespace processing. Names are kept as-is, ex.: `soap:Envelope`.
+     */
+    NONE = 0,
+
+    /**
+     * Names are resolved and reduced to local names, ex.: `Envelope`. <br>
+     * DTO fields are matched by local names regardless of the prefix used in the document.
+     * Attributes reduced to the same local name, ex.: `a:id` and `b:id`, are reported as &id:oatpp::xml::Error::Code::DUPLICATE_ATTRIBUTE;.
+     */
+    LOCAL_NAME = 1,
+
+    /**
+     * Names are resolved to expanded names - `{uri}localName`, ex.: `{http://schemas.xmlsoap.org/soap/envelope/}Envelope`. <br>
+     * DTO fields are matched by (URI, local name) pairs - use expanded names as DTO field names.
+     * Unprefixed attributes and names without a namespace are kept as-is.
+     * See &id:oatpp::xml::NamespaceScope::splitExpandedName;.
+     */
+    EXPANDED_NAME = 2
+
+  };
+
 public:
 
   /**
@@ -44,17 +84,207 @@ public:
   class Config : public oatpp::base::Countable {
   public:
 
+    /**
+     * Max nesting depth of elements. `0` - no limit.<br>
+     * Elements are parsed recursively - set a limit when parsing untrusted input.
+     */
+    v_buff_size maxDepth = 0;
+
+    /**
+     * Max total count of nodes (elements, text, CDATA, comments, PIs) in the document. `0` - no limit.
+     */
+    v_buff_size maxNodes = 0;
+
+    /**
+     * Max count of attributes per element. `0` - no limit.
+     */
+    v_buff_size maxAttributes = 0;
+
+    /**
+     * Max length of element and attribute names. `0` - no limit.
+     */
+    v_buff_size maxNameLength = 0;
+
+    /**
+     * Max size of text, CDATA, comment, PI data and attribute value (raw, before unescaping). `0` - no limit.
+     */
+    v_buff_size maxTextSize = 0;
+
+    /**
+     * Max size of the document. `0` - no limit.
+     */
+    v_buff_size maxDocumentSize = 0;
+
+    /**
+     * Namespace processing mode. See &l:Deserializer::NamespaceMode;. <br>
+     * `xmlns` declarations are kept in attributes as-is.
+     */
+    NamespaceMode namespaceMode = NamespaceMode::NONE;
+
+    /**
+     * Parse text of numeric and boolean leaf elements straight into typed tree values
+     * when the target type is known - see &l:Deserializer::State::hints;. <br>
+     * Text which doesn't parse as the expected type is kept as a string.
+     */
+    bool parseTypedLeaves = false;
+
+    /**
+     * Text and CDATA content bigger than this (raw, before unescaping) is written to the &l:Deserializer::Config::spillSink;
+     * instead of being kept in memory. The tree gets a `!SPILL` node with the content handle in place of
+     * the `!TEXT`/`!CDATA` node. `0` - keep all content in memory. <br>
+     * The serializer writes `!SPILL` nodes back as text - see &id:oatpp::xml::Serializer::Config::spillSink;.
+     */
+    v_buff_size spillThreshold = 0;
+
+    /**
+     * Sink for spilled content. `nullptr` - &id:oatpp::xml::FileSpillSink; in the system temp directory.
+     */
+    std::shared_ptr<SpillSink> spillSink;
+
+    /**
+     * Count of threads to parse big documents with. Content of the root element is split at child element boundaries,
+     * chunks are parsed in parallel and merged into the tree in document order. `0`, `1` - parse in the calling thread. <br>
+     * The calling thread parses the first chunk, the rest go to a shared pool of threads which is started on first use and kept.
+     * Not used when &l:Deserializer::Config::maxNodes; is set. Custom &l:Deserializer::Config::spillSink; must be thread-safe.
+     */
+    v_int32 parallelThreads = 0;
+
+    /**
+     * Min size of the document to parse in parallel. See &l:Deserializer::Config::parallelThreads;.
+     */
+    v_buff_size parallelThreshold = 4 * 1024 * 1024;
+
+    /**
+     * Validate UTF-8 of names, text, CDATA, comments, PI data and attribute values. <br>
+     * Each span is validated right after it's delimited, while it's still in cache.
+     * Invalid input fails with `INVALID_UTF8_SEQUENCE` at the offset of the first byte of the invalid sequence.
+     */
+    bool validateUtf8 = false;
+
+    /**
+     * Skip comments - they are passed over with a terminator search, no tree nodes are created. <br>
+     * Text around a skipped comment is merged into one `!TEXT` node.
+     */
+    bool skipComments = false;
+
+    /**
+     * Skip processing instructions, including the `<?xml ...?>` declaration. See &l:Deserializer::Config::skipComments;.
+     */
+    bool skipPIs = false;
+
+    /**
+     * Put CDATA content to the tree as text - merged with the adjacent text into one `!TEXT` node. <br>
+     * Element which has only text and CDATA content becomes a string leaf. Spilled CDATA is kept as a `!SPILL` node.
+     * Not used by &id:oatpp::xml::PullReader;.
+     */
+    bool mergeCData = false;
+
+  };
+
+public:
+
+  /**
+   * Child nodes of an element collected during parsing.
+   */
+  typedef std::vector<std::pair<oatpp::String, data::mapping::Tree>> Nodes;
+
+  /**
+   * Content of the root element split for parallel parsing. See &l:Deserializer::Config::parallelThreads;.
+   */
+  struct Chunks {
+
+    /**
+     * Position of the root element content.
+     */
+    v_buff_size contentStart = 0;
+
+    /**
+     * Positions where chunks start - right after the end of a root's child element.
+     */
+    std::vector<v_buff_size> boundaries;
+
   };
 
 public:
 
+  /**
+   * Reusable parser context. <br>
+   * Keeps per-level scratch buffers between &l:Deserializer::deserialize (); calls,
+   * so that repeated parsing of small documents doesn't allocate them again. <br>
+   * Context is NOT thread-safe - use one context per thread.
+   */
+  class Context {
+    friend Deserializer;
+  public:
+    /**
+     * Max capacity of a per-level nodes buffer which is retained between calls.
+     * Bigger buffers are released so that a single huge document doesn't pin memory.
+     */
+    static constexpr v_buff_usize MAX_RETAINED_NODES = 1024;
+  private:
+    std::deque<Nodes> m_nodesStack;
+    v_buff_usize m_depth = 0;
+  private:
+    Nodes& pushNodes();
+    void popNodes();
+  public:
+
+    /**
+     * Reset context before parsing a new document.
+     */
+    void reset();
+
+  };
+
+public:
+
+  /**
+   * Parser state. <br>
+   * `parse*` methods report errors to `error`.
+   * &l:Deserializer::deserialize (); renders `error` to `errorStack` once parsing failed.
+   */
   struct State {
     const Config* config;
     data::mapping::Tree* tree;
     utils::parser::Caret* caret;
     data::mapping::ErrorStack errorStack;
+    Context* context = nullptr;
+    Error error;
+    v_buff_size depth = 0;
+    v_buff_size nodesCount = 0;
+    const NamespaceScope* namespaces = nullptr;
+    /**
+     * Expected types of the document elements. `nullptr` - unknown, all text is kept as strings. <br>
+     * Base64 text of binary leaves is decoded to `!BASE64` nodes.
+     * Numeric and boolean leaves are parsed when &l:Deserializer::Config::parseTypedLeaves; is set.
+     */
+    const TypeHints::Node* hints = nullptr;
+    /**
+     * Split of the root element content. Set by &l:Deserializer::deserialize (); when parsing in parallel.
+     */
+    const Chunks* chunks = nullptr;
   };
 
+private:
+  static bool checkText(State& state, const char* text, v_buff_size textSize, v_buff_size position);
+  static bool checkUtf8(State& state, const char* text, v_buff_size textSize);
+  static bool countNode(State& state);
+  static bool findTerminator(State& state, const char* text, v_buff_size textSize);
+  static bool skipNode(State& state);
+  static bool isSpilled(State& state, v_buff_size textSize);
+  static oatpp::String spill(State& state, const char* text, v_buff_size textSize, bool unescape, v_buff_size position);
+  static v_buff_size scanName(State& state, bool isAttribute);
+  static bool scanAttributeValue(State& state, const char*& value, v_buff_size& valueSize);
+  static bool parseAttribute(State& state, v_buff_size& count, oatpp::String& key, oatpp::String& value);
+  static oatpp::String resolveName(State& state, const oatpp::String& qname, bool useDefaultNamespace, v_buff_size position);
+  static void parseNamespacedAttributes(State& state, oatpp::String& name, std::optional<NamespaceScope>& scope, v_buff_size position);
+  static bool parseBinaryLeaf(data::mapping::Tree& tree, const char* text, v_buff_size size);
+  static bool parseTypedLeaf(data::mapping::Tree& tree, data::mapping::Tree::Type type, const char* text, v_buff_size size);
+  static bool parseLeafContent(State& state, const oatpp::String& name);
+  static void parseElementContent(State& state, const oatpp::String& name, Nodes& nodes);
+  static bool splitContent(State& state, v_buff_size chunksCount, Chunks& chunks);
+  static void parseChunks(State& state, const oatpp::String& name);
+
 public:
 
   static oatpp::String parseElementName(State& state);
@@ -0,0 +1,475 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Document.hpp"
+
+#include "./PullReader.hpp"
+#include "./Utils.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+template<typename T>
+v_int64 getIntegerValue(const data::mapping::Tree& tree) {
+  return static_cast<v_int64>(tree.getPrimitive<T>());
+}
+
+bool equals(const data::share::StringKeyLabel& label, const char* text) {
+  auto size = static_cast<v_buff_size>(std::strlen(text));
+  return label.getSize() == size && std::memcmp(label.getData(), text, static_cast<size_t>(size)) == 0;
+}
+
+}
+
+Document::Document() {
+  clear();
+}
+
+Document::Chars Document::store(const char* data, v_buff_size size) {
+  Chars chars{};
+  if(size > std::numeric_limits<v_uint32>::max() ||
+     m_strings.size() + static_cast<size_t>(size) > std::numeric_limits<v_uint32>::max())
+  {
+    throw std::runtime_error("[oatpp::xml::Document::store()]: Error. Document string pool is full.");
+  }
+  chars.size = static_cast<v_uint32>(size);
+  if(size == 0) {
+    return chars;
+  }
+  if(size <= INLINE_SIZE) {
+    std::memcpy(chars.data, data, static_cast<size_t>(size));
+  } else {
+    chars.offset = static_cast<v_uint32>(m_strings.size());
+    m_strings.append(data, static_cast<size_t>(size));
+  }
+  return chars;
+}
+
+data::share::StringKeyLabel Document::view(const Chars& chars) const {
+  if(chars.size <= INLINE_SIZE) {
+    return data::share::StringKeyLabel(nullptr, chars.data, chars.size);
+  }
+  return data::share::StringKeyLabel(nullptr, m_strings.data() + chars.offset, chars.size);
+}
+
+Document::Index Document::addNode(Index parent, Index previousSibling, const char* name, v_buff_size nameSize) {
+
+  if(m_nodes.size() >= std::numeric_limits<Index>::max()) {
+    throw std::runtime_error("[oatpp::xml::Document::addNode()]: Error. Too many nodes.");
+  }
+
+  Node node{};
+  node.name = store(name, nameSize);
+  node.type = data::mapping::Tree::Type::UNDEFINED;
+  m_nodes.push_back(node);
+
+  auto index = static_cast<Index>(m_nodes.size() - 1);
+  if(previousSibling == NONE) {
+    m_nodes[parent].firstChild = index;
+  } else {
+    m_nodes[previousSibling].nextSibling = index;
+  }
+  return index;
+
+}
+
+void Document::setText(Index node, const char* text, v_buff_size size) {
+  auto chars = store(text, size);
+  m_nodes[node].value.text = chars;
+  m_nodes[node].type = data::mapping::Tree::Type::STRING;
+}
+
+void Document::appendText(Index node, const char* text, v_buff_size size) {
+
+  auto& chars = m_nodes[node].value.text;
+  auto mergedSize = static_cast<v_buff_size>(chars.size) + size;
+
+  if(mergedSize <= INLINE_SIZE) {
+    std::memcpy(chars.data + chars.size, text, static_cast<size_t>(size));
+    chars.size = static_cast<v_uint32>(mergedSize);
+    return;
+  }
+
+  /* text stored last grows in place - each merged piece is copied once */
+  if(chars.size > INLINE_SIZE && chars.offset + chars.size == m_strings.size()) {
+    if(m_strings.size() + static_cast<size_t>(size) > std::numeric_limits<v_uint32>::max()) {
+      throw std::runtime_error("[oatpp::xml::Document::appendText()]: Error. Document string pool is full.");
+    }
+    m_strings.append(text, static_cast<size_t>(size));
+    chars.size = static_cast<v_uint32>(mergedSize);
+    return;
+  }
+
+  /* otherwise the text is moved to the end of the pool once. Old text may be in the pool which is about to grow - copy it first */
+  auto current = view(chars);
+  std::string merged(static_cast<const char*>(current.getData()), static_cast<size_t>(current.getSize()));
+  merged.append(text, static_cast<size_t>(size));
+  setText(node, merged.data(), static_cast<v_buff_size>(merged.size()));
+
+}
+
+bool Document::parse(const char* data, v_buff_size size, const Deserializer::Config& config, Error& error) {
+
+  struct Level {
+    Index node;
+    Index lastChild;
+  };
+
+  clear();
+  m_nodes[ROOT].type = data::mapping::Tree::Type::PAIRS;
+
+  PullReader reader(data, size, config);
+  std::vector<Level> stack;
+  stack.push_back({ROOT, NONE});
+
+  /* unescaped text and attribute values - the buffer is reused between nodes */
+  data::stream::BufferOutputStream buffer(256);
+  auto unescape = [&](const data::share::StringKeyLabel& raw) {
+    auto text = static_cast<const char*>(raw.getData());
+    if(std::memchr(text, '&', static_cast<size_t>(raw.getSize())) == nullptr) {
+      return raw;
+    }
+    buffer.setCurrentPosition(0);
+    Utils::unescapeText(&buffer, text, raw.getSize());
+    return data::share::StringKeyLabel(nullptr, reinterpret_cast<const char*>(buffer.getData()), buffer.getCurrentPosition());
+  };
+
+  /* text after a skipped node or merged CDATA is appended to the previous text node */
+  auto addText = [&](Level& level, const data::share::StringKeyLabel& text) {
+    if(level.lastChild != NONE && equals(getName(level.lastChild), "!TEXT")) {
+      appendText(level.lastChild, static_cast<const char*>(text.getData()), text.getSize());
+      return;
+    }
+    auto node = addNode(level.node, level.lastChild, "!TEXT", 5);
+    setText(node, static_cast<const char*>(text.getData()), text.getSize());
+    level.lastChild = node;
+  };
+
+  auto addStringNode = [&](Level& level, const char* name, v_buff_size nameSize, const data::share::StringKeyLabel& text) {
+    auto node = addNode(level.node, level.lastChild, name, nameSize);
+    setText(node, static_cast<const char*>(text.getData()), text.getSize());
+    level.lastChild = node;
+  };
+
+  while(true) {
+
+    switch(reader.next()) {
+
+      case PullReader::Token::START_ELEMENT: {
+        auto& level = stack.back();
+        auto name = reader.getName();
+        auto node = addNode(level.node, level.lastChild, static_cast<const char*>(name.getData()), name.getSize());
+        level.lastChild = node;
+        const auto& attributes = reader.getAttributes();
+        if(!attributes.empty()) {
+          m_nodes[node].firstAttribute = static_cast<v_uint32>(m_attributes.size());
+          m_nodes[node].attributesCount = static_cast<v_uint32>(attributes.size());
+          for(const auto& attribute : attributes) {
+            Attribute item;
+            item.name = store(static_cast<const char*>(attribute.name.getData()), attribute.name.getSize());
+            auto value = unescape(attribute.rawValue);
+            item.value = store(static_cast<const char*>(value.getData()), value.getSize());
+            m_attributes.push_back(item);
+          }
+        }
+        stack.push_back({node, NONE});
+        break;
+      }
+
+      case PullReader::Token::END_ELEMENT: {
+        auto level = stack.back();
+        stack.pop_back();
+        auto& node = m_nodes[level.node];
+        if(level.lastChild == NONE) {
+          break;
+        }
+        /* text only - element becomes a string leaf, the text node is dropped */
+        if(node.firstChild == level.lastChild && equals(getName(level.lastChild), "!TEXT")) {
+          node.value.text = m_nodes[level.lastChild].value.text;
+          node.type = data::mapping::Tree::Type::STRING;
+          node.firstChild = NONE;
+          if(level.lastChild == m_nodes.size() - 1) {
+            m_nodes.pop_back();
+          }
+          break;
+        }
+        node.type = data::mapping::Tree::Type::PAIRS;
+        break;
+      }
+
+      case PullReader::Token::TEXT:
+        addText(stack.back(), unescape(reader.getRawText()));
+        break;
+
+      case PullReader::Token::CDATA:
+        if(config.mergeCData) {
+          addText(stack.back(), reader.getRawText());
+        } else {
+          addStringNode(stack.back(), "!CDATA", 6, reader.getRawText());
+        }
+        break;
+
+      case PullReader::Token::COMMENT:
+        addStringNode(stack.back(), "!COMMENT", 8, reader.getRawText());
+        break;
+
+      case PullReader::Token::PI: {
+        auto target = reader.getName();
+        std::string name = "?";
+        name.append(static_cast<const char*>(target.getData()), static_cast<size_t>(target.getSize()));
+        addStringNode(stack.back(), name.data(), static_cast<v_buff_size>(name.size()), reader.getRawText());
+        break;
+      }
+
+      case PullReader::Token::END_DOCUMENT:
+        /* documents are kept around - don't keep the growth reserve */
+        m_nodes.shrink_to_fit();
+        m_attributes.shrink_to_fit();
+        m_strings.shrink_to_fit();
+        return true;
+
+      default:
+        error = reader.getError();
+        clear();
+        return false;
+
+    }
+
+  }
+
+}
+
+void Document::readTree(Index node, const data::mapping::Tree& tree) {
+
+  const auto& attributes = tree.attributes();
+  if(attributes.size() > 0) {
+    m_nodes[node].firstAttribute = static_cast<v_uint32>(m_attributes.size());
+    m_nodes[node].attributesCount = static_cast<v_uint32>(attributes.size());
+    for(v_uint32 i = 0; i < attributes.size(); i ++) {
+      auto attribute = attributes[i];
+      const auto& value = attribute.second.get();
+      Attribute item;
+      item.name = store(attribute.first->data(), static_cast<v_buff_size>(attribute.first->size()));
+      item.value = value ? store(value->data(), static_cast<v_buff_size>(value->size())) : store(nullptr, 0);
+      m_attributes.push_back(item);
+    }
+  }
+
+  auto type = tree.getType();
+
+  switch(type) {
+
+    case data::mapping::Tree::Type::UNDEFINED:
+    case data::mapping::Tree::Type::NULL_VALUE:
+      break;
+
+    case data::mapping::Tree::Type::INTEGER: m_nodes[node].value.integer = tree.getInteger(); break;
+    case data::mapping::Tree::Type::FLOAT: m_nodes[node].value.floatValue = tree.getFloat(); break;
+
+    case data::mapping::Tree::Type::BOOL: m_nodes[node].value.integer = getIntegerValue<bool>(tree); break;
+    case data::mapping::Tree::Type::INT_8: m_nodes[node].value.integer = getIntegerValue<v_int8>(tree); break;
+    case data::mapping::Tree::Type::UINT_8: m_nodes[node].value.integer = getIntegerValue<v_uint8>(tree); break;
+    case data::mapping::Tree::Type::INT_16: m_nodes[node].value.integer = getIntegerValue<v_int16>(tree); break;
+    case data::mapping::Tree::Type::UINT_16: m_nodes[node].value.integer = getIntegerValue<v_uint16>(tree); break;
+    case data::mapping::Tree::Type::INT_32: m_nodes[node].value.integer = getIntegerValue<v_int32>(tree); break;
+    case data::mapping::Tree::Type::UINT_32: m_nodes[node].value.integer = getIntegerValue<v_uint32>(tree); break;
+    case data::mapping::Tree::Type::INT_64: m_nodes[node].value.integer = getIntegerValue<v_int64>(tree); break;
+    case data::mapping::Tree::Type::UINT_64: m_nodes[node].value.integer = getIntegerValue<v_uint64>(tree); break;
+
+    case data::mapping::Tree::Type::FLOAT_32: m_nodes[node].value.floatValue = tree.getPrimitive<v_float32>(); break;
+    case data::mapping::Tree::Type::FLOAT_64: m_nodes[node].value.floatValue = tree.getPrimitive<v_float64>(); break;
+
+    case data::mapping::Tree::Type::STRING: {
+      const auto& text = tree.getString();
+      m_nodes[node].value.text = text ? store(text->data(), static_cast<v_buff_size>(text->size())) : store(nullptr, 0);
+      break;
+    }
+
+    case data::mapping::Tree::Type::PAIRS: {
+      Index previous = NONE;
+      for(const auto& pair : tree.getPairs()) {
+        auto child = addNode(node, previous, pair.first->data(), static_cast<v_buff_size>(pair.first->size()));
+        readTree(child, pair.second);
+        previous = child;
+      }
+      break;
+    }
+
+    default:
+      throw std::runtime_error("[oatpp::xml::Document::fromTree()]: Error. Unsupported node type.");
+
+  }
+
+  m_nodes[node].type = type;
+
+}
+
+Document Document::fromTree(const data::mapping::Tree& tree) {
+  Document document;
+  document.readTree(ROOT, tree);
+  return document;
+}
+
+void Document::writeTree(Index node, data::mapping::Tree& tree) const {
+
+  const auto& item = m_nodes[node];
+
+  for(v_uint32 i = 0; i < item.attributesCount; i ++) {
+    const auto& attribute = m_attributes[item.firstAttribute + i];
+    tree.attributes()[view(attribute.name).toString()] = view(attribute.value).toString();
+  }
+
+  switch(item.type) {
+
+    case data::mapping::Tree::Type::UNDEFINED: break;
+    case data::mapping::Tree::Type::NULL_VALUE: tree.setNull(); break;
+
+    case data::mapping::Tree::Type::INTEGER: tree.setInteger(item.value.integer); break;
+    case data::mapping::Tree::Type::FLOAT: tree.setFloat(item.value.floatValue); break;
+
+    case data::mapping::Tree::Type::BOOL: tree.setPrimitive<bool>(item.value.integer != 0); break;
+    case data::mapping::Tree::Type::INT_8: tree.setPrimitive<v_int8>(static_cast<v_int8>(item.value.integer)); break;
+    case data::mapping::Tree::Type::UINT_8: tree.setPrimitive<v_uint8>(static_cast<v_uint8>(item.value.integer)); break;
+    case data::mapping::Tree::Type::INT_16: tree.setPrimitive<v_int16>(static_cast<v_int16>(item.value.integer)); break;
+    case data::mapping::Tree::Type::UINT_16: tree.setPrimitive<v_uint16>(static_cast<v_uint16>(item.value.integer)); break;
+    case data::mapping::Tree::Type::INT_32: tree.setPrimitive<v_int32>(static_cast<v_int32>(item.value.integer)); break;
+    case data::mapping::Tree::Type::UINT_32: tree.setPrimitive<v_uint32>(static_cast<v_uint32>(item.value.integer)); break;
+    case data::mapping::Tree::Type::INT_64: tree.setPrimitive<v_int64>(item.value.integer); break;
+    case data::mapping::Tree::Type::UINT_64: tree.setPrimitive<v_uint64>(static_cast<v_uint64>(item.value.integer)); break;
+
+    case data::mapping::Tree::Type::FLOAT_32: tree.setPrimitive<v_float32>(static_cast<v_float32>(item.value.floatValue)); break;
+    case data::mapping::Tree::Type::FLOAT_64: tree.setPrimitive<v_float64>(item.value.floatValue); break;
+
+    case data::mapping::Tree::Type::STRING: tree.setString(view(item.value.text).toString()); break;
+
+    case data::mapping::Tree::Type::PAIRS: {
+      tree.setPairs({});
+      auto& pairs = tree.getPairs();
+      for(auto child = item.firstChild; child != NONE; child = m_nodes[child].nextSibling) {
+        pairs.emplace_back(view(m_nodes[child].name).toString(), data::mapping::Tree());
+        writeTree(child, pairs.back().second);
+      }
+      break;
+    }
+
+    default:
+      break;
+
+  }
+
+}
+
+void Document::toTree(data::mapping::Tree& tree) const {
+  writeTree(ROOT, tree);
+}
+
+void Document::clear() {
+  m_nodes.clear();
+  m_attributes.clear();
+  m_strings.clear();
+  Node root{};
+  root.type = data::mapping::Tree::Type::UNDEFINED;
+  m_nodes.push_back(root);
+}
+
+Document::Index Document::getFirstChild(Index node) const {
+  return m_nodes[node].firstChild;
+}
+
+Document::Index Document::getNextSibling(Index node) const {
+  return m_nodes[node].nextSibling;
+}
+
+Document::Index Document::findChild(Index node, const char* name) const {
+  for(auto child = m_nodes[node].firstChild; child != NONE; child = m_nodes[child].nextSibling) {
+    if(equals(view(m_nodes[child].name), name)) {
+      return child;
+    }
+  }
+  return NONE;
+}
+
+data::share::StringKeyLabel Document::getName(Index node) const {
+  return view(m_nodes[node].name);
+}
+
+data::mapping::Tree::Type Document::getType(Index node) const {
+  return m_nodes[node].type;
+}
+
+data::share::StringKeyLabel Document::getString(Index node) const {
+  if(m_nodes[node].type != data::mapping::Tree::Type::STRING) {
+    return data::share::StringKeyLabel();
+  }
+  return view(m_nodes[node].value.text);
+}
+
+v_int64 Document::getInteger(Index node) const {
+  return m_nodes[node].value.integer;
+}
+
+v_float64 Document::getFloat(Index node) const {
+  return m_nodes[node].value.floatValue;
+}
+
+v_uint32 Document::getAttributesCount(Index node) const {
+  return m_nodes[node].attributesCount;
+}
+
+data::share::StringKeyLabel Document::getAttributeName(Index node, v_uint32 index) const {
+  return view(m_attributes[m_nodes[node].firstAttribute + index].name);
+}
+
+data::share::StringKeyLabel Document::getAttributeValue(Index node, v_uint32 index) const {
+  return view(m_attributes[m_nodes[node].firstAttribute + index].value);
+}
+
+data::share::StringKeyLabel Document::getAttributeValue(Index node, const char* name) const {
+  const auto& item = m_nodes[node];
+  for(v_uint32 i = 0; i < item.attributesCount; i ++) {
+    const auto& attribute = m_attributes[item.firstAttribute + i];
+    if(equals(view(attribute.name), name)) {
+      return view(attribute.value);
+    }
+  }
+  return data::share::StringKeyLabel();
+}
+
+v_buff_size Document::getNodesCount() const {
+  return static_cast<v_buff_size>(m_nodes.size());
+}
+
+v_buff_size Document::getMemoryUsage() const {
+  return static_cast<v_buff_size>(m_nodes.capacity() * sizeof(Node) +
+                                  m_attributes.capacity() * sizeof(Attribute) +
+                                  m_strings.capacity());
+}
+
+}}
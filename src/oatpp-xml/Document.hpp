@@ -0,0 +1,219 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_DOCUMENT_HPP
+#define OATPP_XML_DOCUMENT_HPP
+
+#include "./Deserializer.hpp"
+#include "./Error.hpp"
+
+#include "oatpp/data/mapping/Tree.hpp"
+#include "oatpp/data/share/MemoryLabel.hpp"
+#include "oatpp/Types.hpp"
+
+#include <string>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Compact read-only representation of a parsed document. <br>
+ * Nodes are kept in one contiguous array and linked by first-child/next-sibling indices.
+ * Names and values up to &l:Document::INLINE_SIZE; bytes are stored in the node itself, longer ones - in one string pool.
+ * Attributes are stored in a separate array - only for elements which have them. <br>
+ * The root node is the document (`PAIRS` of top-level nodes), elements are `UNDEFINED` (empty), `STRING` (text only)
+ * or `PAIRS` of child nodes named `!TEXT`, `!CDATA`, `!COMMENT`, `?target` or by the element name. <br>
+ * &l:Document::parse (); gives the same layout as &id:oatpp::xml::Deserializer; only with the default
+ * &id:oatpp::xml::Deserializer::NamespaceMode::NONE;, without typed leaves and spilling - see its notes.
+ * &l:Document::fromTree (); keeps any tree as-is. <br>
+ * Names, strings and attribute values are views of the document memory - valid until the document is changed. <br>
+ * &id:oatpp::xml::ParseCache; keeps parsed trees in this form. &id:oatpp::xml::ObjectMapper; maps from
+ * &id:oatpp::data::mapping::Tree; - convert with &l:Document::toTree (); where a tree is needed.
+ */
+class Document {
+public:
+
+  typedef v_uint32 Index;
+
+  /**
+   * Index of the document node.
+   */
+  static constexpr Index ROOT = 0;
+
+  /**
+   * No node. The document node is never a child or a sibling, so its index is used as "none".
+   */
+  static constexpr Index NONE = 0;
+
+  /**
+   * Max size of a string stored in place.
+   */
+  static constexpr v_uint32 INLINE_SIZE = 12;
+
+private:
+
+  struct Chars {
+    v_uint32 size;
+    union {
+      char data[INLINE_SIZE];
+      v_uint32 offset;
+    };
+  };
+
+  struct Node {
+    Chars name;
+    union {
+      Chars text;
+      v_int64 integer;
+      v_float64 floatValue;
+    } value;
+    Index firstChild;
+    Index nextSibling;
+    v_uint32 firstAttribute;
+    v_uint32 attributesCount;
+    data::mapping::Tree::Type type;
+  };
+
+  struct Attribute {
+    Chars name;
+    Chars value;
+  };
+
+private:
+  std::vector<Node> m_nodes;
+  std::vector<Attribute> m_attributes;
+  std::string m_strings;
+private:
+  Chars store(const char* data, v_buff_size size);
+  data::share::StringKeyLabel view(const Chars& chars) const;
+  Index addNode(Index parent, Index previousSibling, const char* name, v_buff_size nameSize);
+  void setText(Index node, const char* text, v_buff_size size);
+  void appendText(Index node, const char* text, v_buff_size size);
+  void readTree(Index node, const data::mapping::Tree& tree);
+  void writeTree(Index node, data::mapping::Tree& tree) const;
+public:
+
+  /**
+   * Constructor. Empty document - the document node only.
+   */
+  Document();
+
+  /**
+   * Parse document straight into the compact representation - no &id:oatpp::data::mapping::Tree; is built. <br>
+   * Parsed with &id:oatpp::xml::PullReader;, so only limits, `skipComments`, `skipPIs` and `mergeCData` of the config
+   * are applied. `namespaceMode`, `parseTypedLeaves` and `spillThreshold` are ignored - names keep their prefixes,
+   * `xmlns` attributes are kept, all leaves are `STRING`s and text is kept in memory whatever its size.
+   * For such configs the layout differs from the tree of &id:oatpp::xml::Deserializer;. <br>
+   * Merged text (skipped nodes, `mergeCData`) grows in place, each piece is copied once.
+   * @param data - document.
+   * @param size - size of the document.
+   * @param config - &id:oatpp::xml::Deserializer::Config;.
+   * @param error - out error. Error path is the element path.
+   * @return - `false` on error.
+   */
+  bool parse(const char* data, v_buff_size size, const Deserializer::Config& config, Error& error);
+
+  /**
+   * Create document from tree.
+   * @param tree
+   * @return
+   * @throws - `std::runtime_error` if tree has `VECTOR` or `MAP` nodes - they are not produced from XML.
+   */
+  static Document fromTree(const data::mapping::Tree& tree);
+
+  /**
+   * Convert document to tree.
+   * @param tree - out tree.
+   */
+  void toTree(data::mapping::Tree& tree) const;
+
+  /**
+   * Remove all nodes - the document node only is left.
+   */
+  void clear();
+
+  Index getFirstChild(Index node) const;
+  Index getNextSibling(Index node) const;
+
+  /**
+   * Find the first child node with the given name.
+   * @param node
+   * @param name
+   * @return - child index or &l:Document::NONE;.
+   */
+  Index findChild(Index node, const char* name) const;
+
+  data::share::StringKeyLabel getName(Index node) const;
+  data::mapping::Tree::Type getType(Index node) const;
+
+  /**
+   * Get text of a `STRING` node.
+   * @param node
+   * @return
+   */
+  data::share::StringKeyLabel getString(Index node) const;
+
+  /**
+   * Get value of an integer or `BOOL` node.
+   * @param node
+   * @return
+   */
+  v_int64 getInteger(Index node) const;
+
+  /**
+   * Get value of a floating point node.
+   * @param node
+   * @return
+   */
+  v_float64 getFloat(Index node) const;
+
+  v_uint32 getAttributesCount(Index node) const;
+  data::share::StringKeyLabel getAttributeName(Index node, v_uint32 index) const;
+  data::share::StringKeyLabel getAttributeValue(Index node, v_uint32 index) const;
+
+  /**
+   * Get attribute value by name.
+   * @param node
+   * @param name
+   * @return - value or a label with `nullptr` data if there is no such attribute.
+   */
+  data::share::StringKeyLabel getAttributeValue(Index node, const char* name) const;
+
+  /**
+   * Count of nodes, including the document node.
+   * @return
+   */
+  v_buff_size getNodesCount() const;
+
+  /**
+   * Heap memory held by the document.
+   * @return
+   */
+  v_buff_size getMemoryUsage() const;
+
+};
+
+}}
+
+#endif //OATPP_XML_DOCUMENT_HPP
@@ -0,0 +1,216 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Error.hpp"
+#include "Scanner.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/* error messages must be valid UTF-8 even if the input is not - invalid bytes are written as \xNN */
+void writeExcerpt(data::stream::BufferOutputStream& ss, const char* data, v_buff_size size) {
+  static const char* const HEX = "0123456789ABCDEF";
+  while(size > 0) {
+    auto invalid = Scanner::findInvalidUtf8(data, size);
+    if(invalid < 0) {
+      ss.writeSimple(data, size);
+      return;
+    }
+    ss.writeSimple(data, invalid);
+    auto byte = static_cast<v_uint8>(data[invalid]);
+    char escaped[4] = {'\\', 'x', HEX[byte >> 4], HEX[byte & 0x0F]};
+    ss.writeSimple(escaped, 4);
+    data += invalid + 1;
+    size -= invalid + 1;
+  }
+}
+
+}
+
+void Error::clear() {
+  m_code = Code::NONE;
+  m_position = -1;
+  m_path.clear();
+}
+
+void Error::pushElement(const oatpp::String& name) {
+  m_path.push_back({name, -1, false});
+}
+
+void Error::pushAttribute(const oatpp::String& name) {
+  m_path.push_back({name, -1, true});
+}
+
+void Error::pushIndex(v_int64 index) {
+  m_path.push_back({nullptr, index, false});
+}
+
+Error::Code Error::getCode() const {
+  return m_code;
+}
+
+v_buff_size Error::getPosition() const {
+  return m_position;
+}
+
+const std::vector<Error::Frame>& Error::getFrames() const {
+  return m_path;
+}
+
+oatpp::String Error::getPath() const {
+  data::stream::BufferOutputStream ss(128);
+  for(auto it = m_path.rbegin(); it != m_path.rend(); it ++) {
+    if(it->index >= 0) {
+      ss.writeSimple("[", 1);
+      ss.writeAsString(it->index);
+      ss.writeSimple("]", 1);
+    } else {
+      ss.writeSimple(it->attribute ? "/@" : "/");
+      if(it->name) {
+        ss.writeSimple(it->name);
+      }
+    }
+  }
+  return ss.toString();
+}
+
+bool Error::getLineColumn(const char* data, v_buff_size dataSize, v_buff_size& line, v_buff_size& column) const {
+
+  if(data == nullptr || m_position < 0 || m_position > dataSize) {
+    return false;
+  }
+
+  line = 1;
+  column = 1;
+  for(v_buff_size i = 0; i < m_position; i ++) {
+    if(data[i] == '\n') {
+      line ++;
+      column = 1;
+    } else {
+      column ++;
+    }
+  }
+
+  return true;
+
+}
+
+oatpp::String Error::toString(const char* source, const char* data, v_buff_size dataSize) const {
+
+  data::stream::BufferOutputStream ss(256);
+
+  ss.writeSimple("[", 1);
+  ss.writeSimple(source);
+  ss.writeSimple("]: ", 3);
+  ss.writeSimple(getMessage(m_code));
+
+  v_buff_size line, column;
+  if(getLineColumn(data, dataSize, line, column)) {
+    ss.writeSimple(" at line ");
+    ss.writeAsString(static_cast<v_int64>(line));
+    ss.writeSimple(", column ");
+    ss.writeAsString(static_cast<v_int64>(column));
+    ss.writeSimple(" (offset ");
+    ss.writeAsString(static_cast<v_int64>(m_position));
+    ss.writeSimple(")");
+
+    /* show a short fragment of the input at the error position */
+    v_buff_size fragmentSize = dataSize - m_position;
+    if(fragmentSize > 16) {
+      fragmentSize = Scanner::trimToCodePoint(&data[m_position], 16);
+    }
+    if(fragmentSize > 0) {
+      ss.writeSimple(" near '");
+      writeExcerpt(ss, &data[m_position], fragmentSize);
+      ss.writeSimple("'");
+    }
+  } else if(m_position >= 0) {
+    ss.writeSimple(" at offset ");
+    ss.writeAsString(static_cast<v_int64>(m_position));
+  }
+
+  if(!m_path.empty()) {
+    ss.writeSimple(", path='");
+    ss.writeSimple(getPath());
+    ss.writeSimple("'");
+  }
+
+  return ss.toString();
+
+}
+
+void Error::renderTo(data::mapping::ErrorStack& errorStack, const char* source, const char* data, v_buff_size dataSize) const {
+  errorStack.push(toString(source, data, dataSize));
+}
+
+const char* Error::getMessage(Code code) {
+  switch (code) {
+    case Code::NONE: return "No error";
+
+    case Code::INVALID_ELEMENT_NAME: return "Invalid element name";
+    case Code::INVALID_ATTRIBUTE_NAME: return "Invalid attribute name";
+    case Code::ATTRIBUTE_EQUALS_EXPECTED: return "'=' expected";
+    case Code::ATTRIBUTE_QUOTE_EXPECTED: return R"("'" or '"' expected)";
+    case Code::UNTERMINATED_ATTRIBUTE_VALUE: return "Unterminated attribute value";
+    case Code::PI_START_EXPECTED: return "'<?' expected";
+    case Code::UNTERMINATED_PI: return "Unterminated PI node";
+    case Code::COMMENT_START_EXPECTED: return "'<!--' expected";
+    case Code::UNTERMINATED_COMMENT: return "Unterminated comment";
+    case Code::CDATA_START_EXPECTED: return "'<![CDATA[' expected";
+    case Code::UNTERMINATED_CDATA: return "Unterminated CDATA node";
+    case Code::ELEMENT_START_EXPECTED: return "'<' expected";
+    case Code::ELEMENT_END_EXPECTED: return "'>' expected";
+    case Code::EMPTY_ELEMENT_END_EXPECTED: return "'/>' expected";
+    case Code::INVALID_CLOSING_TAG: return "Invalid closing tag";
+    case Code::CLOSING_TAG_END_EXPECTED: return "Invalid closing tag - '>' expected";
+    case Code::INVALID_UTF8_SEQUENCE: return "Invalid UTF-8 sequence";
+    case Code::UNSUPPORTED_ENCODING: return "Unsupported document encoding";
+
+    case Code::DOCUMENT_SIZE_LIMIT_EXCEEDED: return "Document size limit exceeded";
+    case Code::DEPTH_LIMIT_EXCEEDED: return "Nesting depth limit exceeded";
+    case Code::NODES_LIMIT_EXCEEDED: return "Nodes count limit exceeded";
+    case Code::ATTRIBUTES_LIMIT_EXCEEDED: return "Attributes count limit exceeded";
+    case Code::NAME_LENGTH_LIMIT_EXCEEDED: return "Name length limit exceeded";
+    case Code::TEXT_SIZE_LIMIT_EXCEEDED: return "Text size limit exceeded";
+
+    case Code::UNBOUND_NAMESPACE_PREFIX: return "Unbound namespace prefix";
+    case Code::DUPLICATE_ATTRIBUTE: return "Attributes resolve to the same name";
+    case Code::SPILL_FAILED: return "Can't write content to the spill sink";
+
+    case Code::INVALID_CHARACTER: return "Invalid character";
+    case Code::INVALID_PI_NAME: return "Invalid PI node name";
+    case Code::STRING_EXPECTED: return "String value expected";
+    case Code::UNKNOWN_SPECIAL_NODE: return "Unknown special node type";
+    case Code::UNKNOWN_NODE_TYPE: return "Unknown node type";
+    case Code::OBJECT_MAPPING_FAILED: return "Object to tree mapping failed";
+
+    default:
+      return "Unknown error";
+  }
+}
+
+}}
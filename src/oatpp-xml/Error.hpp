@@ -0,0 +1,194 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_ERROR_HPP
+#define OATPP_XML_ERROR_HPP
+
+#include "oatpp/data/mapping/ObjectMapper.hpp"
+#include "oatpp/Types.hpp"
+
+namespace oatpp { namespace xml {
+
+/**
+ * Compact XML mapping error. <br>
+ * Only error code, byte offset and element path frames are recorded when the error happens.
+ * Message text, line/column and the element path are built when the error is rendered.
+ */
+class Error {
+public:
+
+  /**
+   * Error code.
+   */
+  enum class Code : v_int32 {
+    NONE = 0,
+
+    INVALID_ELEMENT_NAME,
+    INVALID_ATTRIBUTE_NAME,
+    ATTRIBUTE_EQUALS_EXPECTED,
+    ATTRIBUTE_QUOTE_EXPECTED,
+    UNTERMINATED_ATTRIBUTE_VALUE,
+    PI_START_EXPECTED,
+    UNTERMINATED_PI,
+    COMMENT_START_EXPECTED,
+    UNTERMINATED_COMMENT,
+    CDATA_START_EXPECTED,
+    UNTERMINATED_CDATA,
+    ELEMENT_START_EXPECTED,
+    ELEMENT_END_EXPECTED,
+    EMPTY_ELEMENT_END_EXPECTED,
+    INVALID_CLOSING_TAG,
+    CLOSING_TAG_END_EXPECTED,
+    INVALID_UTF8_SEQUENCE,
+    UNSUPPORTED_ENCODING,
+
+    DOCUMENT_SIZE_LIMIT_EXCEEDED,
+    DEPTH_LIMIT_EXCEEDED,
+    NODES_LIMIT_EXCEEDED,
+    ATTRIBUTES_LIMIT_EXCEEDED,
+    NAME_LENGTH_LIMIT_EXCEEDED,
+    TEXT_SIZE_LIMIT_EXCEEDED,
+
+    UNBOUND_NAMESPACE_PREFIX,
+    DUPLICATE_ATTRIBUTE,
+    SPILL_FAILED,
+
+    INVALID_CHARACTER,
+    INVALID_PI_NAME,
+    STRING_EXPECTED,
+    UNKNOWN_SPECIAL_NODE,
+    UNKNOWN_NODE_TYPE,
+    OBJECT_MAPPING_FAILED
+  };
+
+public:
+
+  /**
+   * Element path frame.
+   */
+  struct Frame {
+    oatpp::String name;
+    v_int64 index;
+    bool attribute;
+  };
+
+private:
+  Code m_code = Code::NONE;
+  v_buff_size m_position = -1;
+  std::vector<Frame> m_path;
+public:
+
+  /**
+   * Set error.
+   * @param code - &l:Error::Code;.
+   * @param position - byte offset in the input or `-1` if not applicable.
+   */
+  void set(Code code, v_buff_size position = -1) {
+    m_code = code;
+    m_position = position;
+  }
+
+  /**
+   * Check if error is set.
+   * @return
+   */
+  bool isSet() const {
+    return m_code != Code::NONE;
+  }
+
+  /**
+   * Clear error.
+   */
+  void clear();
+
+  /**
+   * Add element frame to the path. Frames are added while the error propagates - innermost first.
+   * @param name
+   */
+  void pushElement(const oatpp::String& name);
+
+  /**
+   * Add attribute frame to the path.
+   * @param name
+   */
+  void pushAttribute(const oatpp::String& name);
+
+  /**
+   * Add index frame to the path.
+   * @param index
+   */
+  void pushIndex(v_int64 index);
+
+  Code getCode() const;
+  v_buff_size getPosition() const;
+  const std::vector<Frame>& getFrames() const;
+
+  /**
+   * Get element path, ex.: `/root/items/item[2]/@id`.
+   * @return
+   */
+  oatpp::String getPath() const;
+
+  /**
+   * Compute 1-based line and column of the error position.
+   * @param data - input data the position refers to.
+   * @param dataSize - input data size.
+   * @param line - out line.
+   * @param column - out column.
+   * @return - `false` if position is not set or out of data bounds.
+   */
+  bool getLineColumn(const char* data, v_buff_size dataSize, v_buff_size& line, v_buff_size& column) const;
+
+  /**
+   * Render error to string.
+   * @param source - error source, ex.: `oatpp::xml::Deserializer`.
+   * @param data - input data the position refers to. May be `nullptr`.
+   * @param dataSize - input data size.
+   * @return
+   */
+  oatpp::String toString(const char* source, const char* data = nullptr, v_buff_size dataSize = 0) const;
+
+  /**
+   * Render error to &id:oatpp::data::mapping::ErrorStack;.
+   * @param errorStack
+   * @param source - error source, ex.: `oatpp::xml::Deserializer`.
+   * @param data - input data the position refers to. May be `nullptr`.
+   * @param dataSize - input data size.
+   */
+  void renderTo(data::mapping::ErrorStack& errorStack, const char* source, const char* data = nullptr, v_buff_size dataSize = 0) const;
+
+public:
+
+  /**
+   * Get error message for the code.
+   * @param code
+   * @return
+   */
+  static const char* getMessage(Code code);
+
+};
+
+}}
+
+#endif //OATPP_XML_ERROR_HPP
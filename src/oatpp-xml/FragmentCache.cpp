@@ -0,0 +1,166 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "FragmentCache.hpp"
+
+#include <functional>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+bool FragmentCache::OutputKey::operator==(const OutputKey& other) const {
+  return escapeFlags == other.escapeFlags &&
+         includeNullElements == other.includeNullElements &&
+         useBeautifier == other.useBeautifier &&
+         includeNullFields == other.includeNullFields &&
+         alwaysIncludeRequired == other.alwaysIncludeRequired &&
+         beautifierIndent == other.beautifierIndent &&
+         beautifierNewLine == other.beautifierNewLine;
+}
+
+bool FragmentCache::OutputKey::operator!=(const OutputKey& other) const {
+  return !operator==(other);
+}
+
+bool FragmentCache::Key::operator==(const Key& other) const {
+  return version == other.version && output == other.output && *id == *other.id;
+}
+
+size_t FragmentCache::KeyHash::operator()(const Key& key) const {
+  /* id and version tell fragments apart - output options are left to the equality check */
+  auto hash = static_cast<v_uint64>(std::hash<std::string>()(*key.id));
+  hash ^= (key.version + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+  hash ^= (key.output.escapeFlags + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+  return static_cast<size_t>(hash);
+}
+
+FragmentCache::FragmentCache(v_buff_size maxSize, v_buff_size maxFragmentSize, v_uint32 shardsCount)
+  : m_shards(shardsCount > 0 ? shardsCount : 1)
+  , m_maxFragmentSize(maxFragmentSize)
+  , m_hits(0)
+  , m_misses(0)
+  , m_evictions(0)
+  , m_entries(0)
+  , m_size(0)
+{
+  m_shardCapacity = maxSize / static_cast<v_buff_size>(m_shards.size());
+  /* a fragment never spans shards - each shard must fit the biggest one */
+  if(m_shardCapacity < m_maxFragmentSize) {
+    m_maxFragmentSize = m_shardCapacity;
+  }
+}
+
+FragmentCache::Shard& FragmentCache::getShard(const Key& key) {
+  return m_shards[(KeyHash()(key) >> 16) % m_shards.size()];
+}
+
+data::mapping::Tree FragmentCache::makeNode(const oatpp::String& id, v_uint64 version, data::mapping::Tree content) {
+  content.attributes()["id"] = id;
+  content.attributes()["version"] = oatpp::String(std::to_string(version));
+  return content;
+}
+
+oatpp::String FragmentCache::get(const oatpp::String& id, v_uint64 version, const OutputKey& outputKey) {
+
+  Key key{id, version, outputKey};
+  auto& shard = getShard(key);
+
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if(it != shard.index.end()) {
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      m_hits.fetch_add(1, std::memory_order_relaxed);
+      return it->second->bytes;
+    }
+  }
+
+  m_misses.fetch_add(1, std::memory_order_relaxed);
+  return nullptr;
+
+}
+
+void FragmentCache::put(const oatpp::String& id, v_uint64 version, const OutputKey& outputKey, const oatpp::String& bytes) {
+
+  auto size = static_cast<v_buff_size>(bytes->size());
+  if(!id || size > m_maxFragmentSize) {
+    return;
+  }
+
+  Key key{id, version, outputKey};
+  auto& shard = getShard(key);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto it = shard.index.find(key);
+  if(it != shard.index.end()) {
+    auto& entry = *it->second;
+    shard.size += size - static_cast<v_buff_size>(entry.bytes->size());
+    m_size.fetch_add(size - static_cast<v_buff_size>(entry.bytes->size()), std::memory_order_relaxed);
+    entry.bytes = bytes;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return;
+  }
+
+  while(!shard.entries.empty() && shard.size + size > m_shardCapacity) {
+    auto& last = shard.entries.back();
+    auto lastSize = static_cast<v_buff_size>(last.bytes->size());
+    shard.size -= lastSize;
+    m_size.fetch_sub(lastSize, std::memory_order_relaxed);
+    shard.index.erase(last.key);
+    shard.entries.pop_back();
+    m_evictions.fetch_add(1, std::memory_order_relaxed);
+    m_entries.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  shard.entries.push_front(Entry{key, bytes});
+  shard.index[key] = shard.entries.begin();
+  shard.size += size;
+  m_size.fetch_add(size, std::memory_order_relaxed);
+  m_entries.fetch_add(1, std::memory_order_relaxed);
+
+}
+
+void FragmentCache::clear() {
+  for(auto& shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    m_entries.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+    m_size.fetch_sub(shard.size, std::memory_order_relaxed);
+    shard.index.clear();
+    shard.entries.clear();
+    shard.size = 0;
+  }
+}
+
+FragmentCache::Stats FragmentCache::getStats() const {
+  return Stats{
+    m_hits.load(std::memory_order_relaxed),
+    m_misses.load(std::memory_order_relaxed),
+    m_evictions.load(std::memory_order_relaxed),
+    m_entries.load(std::memory_order_relaxed),
+    m_size.load(std::memory_order_relaxed)
+  };
+}
+
+}}
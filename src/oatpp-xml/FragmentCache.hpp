@@ -0,0 +1,232 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_FRAGMENTCACHE_HPP
+#define OATPP_XML_FRAGMENTCACHE_HPP
+
+#include "oatpp/data/mapping/Tree.hpp"
+#include "oatpp/Types.hpp"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Cache of serialized fragments - subtrees and DTOs which are the same in many documents, ex.: catalog sections, reference data. <br>
+ * A fragment is marked with an id and a version - see &l:FragmentCache::makeNode (); and &id:oatpp::xml::Fragment;.
+ * Its serialized bytes are kept by (id, version, output options), later serializations write them with a single bulk write. <br>
+ * Entries rendered with other serializer options are never returned - changing the options invalidates them,
+ * they are evicted as the least recently used. Bump the version once the fragment content changes. <br>
+ * The cache is split into shards, each with its own lock and LRU list. The total size of cached bytes is bounded. <br>
+ * See &id:oatpp::xml::Serializer::Config::fragmentCache;.
+ */
+class FragmentCache {
+public:
+
+  /**
+   * Cache counters.
+   */
+  struct Stats {
+
+    /**
+     * Count of lookups which returned cached bytes.
+     */
+    v_uint64 hits;
+
+    /**
+     * Count of lookups which found nothing.
+     */
+    v_uint64 misses;
+
+    /**
+     * Count of entries evicted to free space.
+     */
+    v_uint64 evictions;
+
+    /**
+     * Current count of entries.
+     */
+    v_uint64 entries;
+
+    /**
+     * Current size of cached bytes.
+     */
+    v_buff_size size;
+
+  };
+
+  /**
+   * Options which affect the serialized output of a fragment. <br>
+   * Cached bytes are returned only for equal options - they are compared field by field.
+   */
+  struct OutputKey {
+
+    /**
+     * &id:oatpp::xml::Serializer::Config::escapeFlags;.
+     */
+    v_uint32 escapeFlags;
+
+    /**
+     * &id:oatpp::xml::Serializer::Config::includeNullElements;.
+     */
+    bool includeNullElements;
+
+    /**
+     * &id:oatpp::xml::Serializer::Config::useBeautifier;.
+     */
+    bool useBeautifier;
+
+    /**
+     * &id:oatpp::xml::Serializer::Config::beautifierIndent;. Empty if the beautifier is off.
+     */
+    std::string beautifierIndent;
+
+    /**
+     * &id:oatpp::xml::Serializer::Config::beautifierNewLine;. Empty if the beautifier is off.
+     */
+    std::string beautifierNewLine;
+
+    /**
+     * Object mapper `includeNullFields` option. Always `false` for tree fragments.
+     */
+    bool includeNullFields;
+
+    /**
+     * Object mapper `alwaysIncludeRequired` option. Always `false` for tree fragments.
+     */
+    bool alwaysIncludeRequired;
+
+    bool operator==(const OutputKey& other) const;
+    bool operator!=(const OutputKey& other) const;
+
+  };
+
+private:
+
+  struct Key {
+    oatpp::String id;
+    v_uint64 version;
+    OutputKey output;
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    Key key;
+    oatpp::String bytes;
+  };
+
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    v_buff_size size = 0;
+  };
+
+private:
+  Shard& getShard(const Key& key);
+private:
+  std::vector<Shard> m_shards;
+  v_buff_size m_shardCapacity;
+  v_buff_size m_maxFragmentSize;
+  std::atomic<v_uint64> m_hits;
+  std::atomic<v_uint64> m_misses;
+  std::atomic<v_uint64> m_evictions;
+  std::atomic<v_uint64> m_entries;
+  std::atomic<v_buff_size> m_size;
+public:
+
+  /**
+   * Tree node name of a fragment. Content of the node is serialized in place of the node - without tags.
+   */
+  static constexpr const char* const NODE_NAME = "!FRAGMENT";
+
+public:
+
+  /**
+   * Constructor.
+   * @param maxSize - max total size of cached bytes.
+   * @param maxFragmentSize - max size of a fragment to cache. Bigger fragments are serialized every time.
+   * @param shardsCount - count of independently locked shards.
+   */
+  FragmentCache(v_buff_size maxSize = 16 * 1024 * 1024, v_buff_size maxFragmentSize = 1024 * 1024, v_uint32 shardsCount = 16);
+
+  /**
+   * Non-copyable.
+   */
+  FragmentCache(const FragmentCache&) = delete;
+  FragmentCache& operator=(const FragmentCache&) = delete;
+
+  /**
+   * Make a fragment node - put it to `PAIRS` under the &l:FragmentCache::NODE_NAME; name. <br>
+   * Id and version are kept in the `id` and `version` attributes of the node.
+   * @param id - fragment id.
+   * @param version - fragment version.
+   * @param content - fragment content.
+   * @return - fragment node.
+   */
+  static data::mapping::Tree makeNode(const oatpp::String& id, v_uint64 version, data::mapping::Tree content);
+
+  /**
+   * Get serialized fragment. Counts a hit or a miss.
+   * @param id - fragment id.
+   * @param version - fragment version.
+   * @param outputKey - options which affect the output - &l:FragmentCache::OutputKey;.
+   * @return - serialized fragment or `nullptr` if there is none.
+   */
+  oatpp::String get(const oatpp::String& id, v_uint64 version, const OutputKey& outputKey);
+
+  /**
+   * Put serialized fragment. Fragments bigger than `maxFragmentSize` are not cached.
+   * @param id - fragment id.
+   * @param version - fragment version.
+   * @param outputKey - options which affect the output - &l:FragmentCache::OutputKey;.
+   * @param bytes - serialized fragment.
+   */
+  void put(const oatpp::String& id, v_uint64 version, const OutputKey& outputKey, const oatpp::String& bytes);
+
+  /**
+   * Remove all entries. Counters are kept.
+   */
+  void clear();
+
+  /**
+   * Get counters.
+   * @return - &l:FragmentCache::Stats;.
+   */
+  Stats getStats() const;
+
+};
+
+}}
+
+#endif /* OATPP_XML_FRAGMENTCACHE_HPP */
@@ -0,0 +1,295 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "NameIndex.hpp"
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace oatpp { namespace xml {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// NameIndex::Registry
+
+NameIndex::Registry::Registry(v_uint64 minChildren, v_uint64 maxEntries)
+  : m_minChildren(minChildren > 0 ? minChildren : 1)
+  , m_maxEntries(maxEntries > 0 ? maxEntries : 1)
+{}
+
+bool NameIndex::Registry::matches(const Item& item, const data::mapping::Tree& node) {
+  const auto& pairs = node.getPairs();
+  if(item.pairs != pairs.data() || item.count != pairs.size() || pairs.empty()) {
+    return false;
+  }
+  /* same key object - its control block outlives the node while the item refers to it, so it can't be reused */
+  const auto& key = pairs[0].first.getPtr();
+  return !item.firstKey.owner_before(key) && !key.owner_before(item.firstKey);
+}
+
+NameIndex::Registry::Item NameIndex::Registry::makeItem(const data::mapping::Tree& node) {
+  const auto& pairs = node.getPairs();
+  return Item{&node, pairs.data(), pairs.size(), pairs[0].first.getPtr(), std::make_shared<NameIndex>(node)};
+}
+
+const std::shared_ptr<const NameIndex>& NameIndex::Registry::put(Item&& item) {
+
+  auto it = m_indices.find(item.node);
+  if(it != m_indices.end()) {
+    *it->second = std::move(item);
+    m_items.splice(m_items.begin(), m_items, it->second);
+    return it->second->index;
+  }
+
+  while(m_items.size() >= m_maxEntries) {
+    m_indices.erase(m_items.back().node);
+    m_items.pop_back();
+  }
+
+  m_items.push_front(std::move(item));
+  m_indices[m_items.front().node] = m_items.begin();
+  return m_items.front().index;
+
+}
+
+void NameIndex::Registry::buildRecursive(const data::mapping::Tree& node) {
+  if(node.getType() != data::mapping::Tree::Type::PAIRS) {
+    return;
+  }
+  const auto& pairs = node.getPairs();
+  if(pairs.size() >= m_minChildren) {
+    auto it = m_indices.find(&node);
+    if(it == m_indices.end() || !matches(*it->second, node)) {
+      put(makeItem(node));
+    }
+  }
+  for(const auto& pair : pairs) {
+    buildRecursive(pair.second);
+  }
+}
+
+std::shared_ptr<const NameIndex> NameIndex::Registry::get(const data::mapping::Tree& node) {
+
+  if(node.getType() != data::mapping::Tree::Type::PAIRS || node.getPairs().size() < m_minChildren) {
+    return nullptr;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_indices.find(&node);
+    if(it != m_indices.end() && matches(*it->second, node)) {
+      m_items.splice(m_items.begin(), m_items, it->second);
+      return it->second->index;
+    }
+  }
+
+  /* index is built outside of the lock - readers of other nodes aren't blocked */
+  auto item = makeItem(node);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  /* other thread could index the node meanwhile */
+  auto it = m_indices.find(&node);
+  if(it != m_indices.end() && matches(*it->second, node)) {
+    m_items.splice(m_items.begin(), m_items, it->second);
+    return it->second->index;
+  }
+  return put(std::move(item));
+
+}
+
+void NameIndex::Registry::build(const data::mapping::Tree& tree) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  buildRecursive(tree);
+}
+
+void NameIndex::Registry::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_indices.clear();
+  m_items.clear();
+}
+
+v_uint64 NameIndex::Registry::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_items.size();
+}
+
+v_uint64 NameIndex::Registry::getMinChildren() const {
+  return m_minChildren;
+}
+
+v_uint64 NameIndex::Registry::getMaxEntries() const {
+  return m_maxEntries;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// NameIndex
+
+v_uint32 NameIndex::hash(const char* data, v_buff_size size) {
+  /* FNV-1a */
+  v_uint32 result = 2166136261u;
+  for(v_buff_size i = 0; i < size; i ++) {
+    result = (result ^ static_cast<v_uint8>(data[i])) * 16777619u;
+  }
+  return result;
+}
+
+NameIndex::Entry* NameIndex::lookup(const char* name, v_buff_size size, v_uint32 hash) {
+  v_uint32 i = hash & m_mask;
+  while(true) {
+    auto& entry = m_table[i];
+    if(entry.name == NO_NAME) {
+      return &entry;
+    }
+    if(entry.hash == hash && entry.size == size && std::memcmp(m_names.data() + entry.name, name, static_cast<size_t>(size)) == 0) {
+      return &entry;
+    }
+    i = (i + 1) & m_mask;
+  }
+}
+
+const NameIndex::Entry* NameIndex::lookup(const char* name, v_buff_size size, v_uint32 hash) const {
+  return const_cast<NameIndex*>(this)->lookup(name, size, hash);
+}
+
+NameIndex::NameIndex(const data::mapping::Tree& node)
+  : m_mask(0)
+  , m_namesCount(0)
+  , m_childrenCount(0)
+{
+
+  if(node.getType() != data::mapping::Tree::Type::PAIRS) {
+    throw std::runtime_error("[oatpp::xml::NameIndex::NameIndex()]: Error. Node is not PAIRS.");
+  }
+
+  const auto& pairs = node.getPairs();
+  if(pairs.size() > (1u << 30)) {
+    throw std::runtime_error("[oatpp::xml::NameIndex::NameIndex()]: Error. Too many children.");
+  }
+  auto count = static_cast<v_uint32>(pairs.size());
+  m_childrenCount = count;
+
+  /* load factor <= 0.5 even if all names are distinct */
+  v_uint32 capacity = 8;
+  while(capacity < count * 2) {
+    capacity <<= 1;
+  }
+  m_table.assign(capacity, Entry{NO_NAME, 0, 0, 0, 0});
+  m_mask = capacity - 1;
+
+  std::vector<Entry*> entries(count);
+
+  /* count children per name */
+  for(v_uint32 i = 0; i < count; i ++) {
+    const auto& key = pairs[i].first;
+    const char* name = key ? key->data() : "";
+    v_buff_size size = key ? static_cast<v_buff_size>(key->size()) : 0;
+    auto h = hash(name, size);
+    auto entry = lookup(name, size, h);
+    if(entry->name == NO_NAME) {
+      if(m_names.size() + static_cast<size_t>(size) >= NO_NAME) {
+        throw std::runtime_error("[oatpp::xml::NameIndex::NameIndex()]: Error. Names are too long.");
+      }
+      *entry = Entry{static_cast<v_uint32>(m_names.size()), static_cast<v_uint32>(size), h, 0, 0};
+      m_names.append(name, static_cast<size_t>(size));
+      m_namesCount ++;
+    }
+    entry->count ++;
+    entries[i] = entry;
+  }
+
+  /* give each name a run of positions */
+  v_uint32 offset = 0;
+  for(auto& entry : m_table) {
+    if(entry.name != NO_NAME) {
+      entry.first = offset;
+      offset += entry.count;
+      entry.count = 0;
+    }
+  }
+
+  m_positions.resize(count);
+  for(v_uint32 i = 0; i < count; i ++) {
+    auto entry = entries[i];
+    m_positions[entry->first + entry->count ++] = i;
+  }
+
+}
+
+NameIndex::Range NameIndex::find(const char* name, v_buff_size size) const {
+  auto entry = lookup(name, size, hash(name, size));
+  if(entry->name == NO_NAME) {
+    return Range();
+  }
+  return Range{m_positions.data() + entry->first, entry->count};
+}
+
+NameIndex::Range NameIndex::find(const oatpp::String& name) const {
+  if(!name) {
+    return Range();
+  }
+  return find(name->data(), static_cast<v_buff_size>(name->size()));
+}
+
+v_uint32 NameIndex::getNamesCount() const {
+  return m_namesCount;
+}
+
+v_uint32 NameIndex::getChildrenCount() const {
+  return m_childrenCount;
+}
+
+const data::mapping::Tree* NameIndex::findFirst(const data::mapping::Tree& node, const oatpp::String& name, Registry* registry) {
+
+  if(node.getType() != data::mapping::Tree::Type::PAIRS || !name) {
+    return nullptr;
+  }
+
+  const auto& pairs = node.getPairs();
+
+  if(registry) {
+    auto index = registry->get(node);
+    if(index) {
+      auto range = index->find(name);
+      if(range.empty()) {
+        return nullptr;
+      }
+      auto position = range.positions[0];
+      if(position < pairs.size() && pairs[position].first && *pairs[position].first == *name) {
+        return &pairs[position].second;
+      }
+      /* keys were changed in place - fall back to the scan */
+    }
+  }
+
+  for(const auto& pair : pairs) {
+    if(pair.first && *pair.first == *name) {
+      return &pair.second;
+    }
+  }
+
+  return nullptr;
+
+}
+
+}}
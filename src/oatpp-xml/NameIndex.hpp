@@ -0,0 +1,237 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_NAMEINDEX_HPP
+#define OATPP_XML_NAMEINDEX_HPP
+
+#include "oatpp/data/mapping/Tree.hpp"
+#include "oatpp/Types.hpp"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Index of child nodes of a `PAIRS` tree node by name. <br>
+ * Positions of all children with the same name are kept in one contiguous run, in document order,
+ * so both a single field and a repeated element are resolved with one hash lookup. <br>
+ * The index keeps its own copy of the names. Positions refer to the node as it was indexed -
+ * check them against the node if it may have changed since, as &l:NameIndex::findFirst (); does. <br>
+ * Object mapping doesn't build indices - it walks the pairs once and resolves DTO fields with the per-type
+ * &id:oatpp::xml::NameTable;. The index is for user code which looks up many names in wide nodes.
+ */
+class NameIndex {
+public:
+
+  /**
+   * Positions of children with the same name in the parent `PAIRS`.
+   */
+  struct Range {
+
+    const v_uint32* positions = nullptr;
+    v_uint32 count = 0;
+
+    const v_uint32* begin() const {
+      return positions;
+    }
+
+    const v_uint32* end() const {
+      return positions + count;
+    }
+
+    bool empty() const {
+      return count == 0;
+    }
+
+  };
+
+public:
+
+  /**
+   * Registry of indices of tree nodes - for nodes which don't own a place to keep their index. <br>
+   * Index of a node is built on the first keyed access (&l:NameIndex::Registry::get ();), or upfront -
+   * for the whole tree (&l:NameIndex::Registry::build ();). Build it for the tree at its final place -
+   * moving a tree moves its root node. <br>
+   * Only nodes with at least `minChildren` children are indexed - a linear scan is faster for smaller ones. <br>
+   * Indices are keyed by node address and remember the storage and the count of the node pairs and its first key.
+   * An index is rebuilt when they don't match the node anymore, so a destroyed, moved, changed or reallocated node
+   * never gets a stale index.
+   * Renaming keys in place is not detected - clear the registry then. <br>
+   * The registry keeps at most `maxEntries` indices - the least recently used one is evicted to make room,
+   * so indices of destroyed nodes don't pile up in a long-living registry. <br>
+   * Lookups are thread-safe.
+   */
+  class Registry {
+  private:
+
+    /* node pairs the index was built for - the first key ties the item to the lifetime of the node */
+    struct Item {
+      const data::mapping::Tree* node;
+      const void* pairs;
+      v_uint64 count;
+      std::weak_ptr<std::string> firstKey;
+      std::shared_ptr<const NameIndex> index;
+    };
+
+  private:
+    static bool matches(const Item& item, const data::mapping::Tree& node);
+    static Item makeItem(const data::mapping::Tree& node);
+  private:
+    v_uint64 m_minChildren;
+    v_uint64 m_maxEntries;
+    mutable std::mutex m_mutex;
+    /* most recently used first */
+    std::list<Item> m_items;
+    std::unordered_map<const data::mapping::Tree*, std::list<Item>::iterator> m_indices;
+  private:
+    const std::shared_ptr<const NameIndex>& put(Item&& item);
+    void buildRecursive(const data::mapping::Tree& node);
+  public:
+
+    /**
+     * Constructor.
+     * @param minChildren - min count of children of a node to index it.
+     * @param maxEntries - max count of indices kept.
+     */
+    explicit Registry(v_uint64 minChildren = 32, v_uint64 maxEntries = 1024);
+
+    /**
+     * Get index of the node. Index is built if the node is big enough and isn't indexed yet or has changed.
+     * @param node - tree node.
+     * @return - index or `nullptr` if the node isn't `PAIRS` or it's too small.
+     */
+    std::shared_ptr<const NameIndex> get(const data::mapping::Tree& node);
+
+    /**
+     * Index all big enough `PAIRS` nodes of the tree. If there are more than `maxEntries` of them, only the last ones are kept.
+     * @param tree - tree.
+     */
+    void build(const data::mapping::Tree& tree);
+
+    /**
+     * Remove all indices.
+     */
+    void clear();
+
+    /**
+     * Count of indexed nodes.
+     * @return
+     */
+    v_uint64 size() const;
+
+    /**
+     * Min count of children of a node to index it.
+     * @return
+     */
+    v_uint64 getMinChildren() const;
+
+    /**
+     * Max count of indices kept.
+     * @return
+     */
+    v_uint64 getMaxEntries() const;
+
+  };
+
+private:
+
+  /* name of an empty slot */
+  static constexpr v_uint32 NO_NAME = 0xFFFFFFFF;
+
+  struct Entry {
+    v_uint32 name;
+    v_uint32 size;
+    v_uint32 hash;
+    v_uint32 first;
+    v_uint32 count;
+  };
+
+private:
+  static v_uint32 hash(const char* data, v_buff_size size);
+private:
+  Entry* lookup(const char* name, v_buff_size size, v_uint32 hash);
+  const Entry* lookup(const char* name, v_buff_size size, v_uint32 hash) const;
+private:
+  std::vector<Entry> m_table;
+  std::vector<v_uint32> m_positions;
+  std::string m_names;
+  v_uint32 m_mask;
+  v_uint32 m_namesCount;
+  v_uint32 m_childrenCount;
+public:
+
+  /**
+   * Constructor. Index children of the node.
+   * @param node - `PAIRS` tree node.
+   * @throws - `std::runtime_error` if the node isn't `PAIRS`.
+   */
+  explicit NameIndex(const data::mapping::Tree& node);
+
+  /**
+   * Find children by name.
+   * @param name - name.
+   * @param size - name size.
+   * @return - positions of children in the parent `PAIRS`. Empty &l:NameIndex::Range; if there are none.
+   */
+  Range find(const char* name, v_buff_size size) const;
+
+  /**
+   * Find children by name.
+   * @param name - name.
+   * @return - positions of children in the parent `PAIRS`. Empty &l:NameIndex::Range; if there are none.
+   */
+  Range find(const oatpp::String& name) const;
+
+  /**
+   * Count of distinct names.
+   * @return
+   */
+  v_uint32 getNamesCount() const;
+
+  /**
+   * Count of children of the node at the time it was indexed.
+   * @return
+   */
+  v_uint32 getChildrenCount() const;
+
+  /**
+   * Find the first child with the name. Uses the index of the node from the registry if there is one,
+   * linear scan otherwise. The indexed position is checked against the node - its key must be the name.
+   * @param node - `PAIRS` tree node.
+   * @param name - name.
+   * @param registry - registry of indices. May be `nullptr`.
+   * @return - child node or `nullptr` if there is none.
+   */
+  static const data::mapping::Tree* findFirst(const data::mapping::Tree& node, const oatpp::String& name, Registry* registry);
+
+};
+
+}}
+
+#endif /* OATPP_XML_NAMEINDEX_HPP */
@@ -0,0 +1,329 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_NAMETABLE_HPP
+#define OATPP_XML_NAMETABLE_HPP
+
+#include "oatpp/Types.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Immutable name -> value table for a set of names known upfront, ex.: DTO field names. <br>
+ * Built once with a perfect hash (hash-and-displace): a name hash selects a bucket and a base slot,
+ * the per-bucket displacement found at build time moves the base slot to a free one.
+ * The hash packs the length, first, middle and last characters of a name into one word -
+ * a lookup is a few arithmetic instructions, two loads and one name comparison, no comparison chains. <br>
+ * Names which differ only in other characters fall back to a hash of all characters,
+ * and if no perfect hash is found - to linear probing.
+ * @tparam V - value type.
+ */
+template<class V>
+class NameTable {
+private:
+
+  enum class Mode : v_int32 {
+    SAMPLED = 0,
+    FULL = 1
+  };
+
+  struct Slot {
+    std::string name;
+    V value;
+    bool used = false;
+  };
+
+  /**
+   * Seeds tried per table size.
+   */
+  static constexpr v_uint32 MAX_SEEDS = 32;
+
+private:
+
+  static v_uint32 hash(Mode mode, const char* data, v_buff_size size) {
+    if(size == 0) {
+      return 0;
+    }
+    if(mode == Mode::SAMPLED) {
+      return static_cast<v_uint32>(size) ^
+             (static_cast<v_uint32>(static_cast<v_uint8>(data[0])) << 8) ^
+             (static_cast<v_uint32>(static_cast<v_uint8>(data[size >> 1])) << 16) ^
+             (static_cast<v_uint32>(static_cast<v_uint8>(data[size - 1])) << 24);
+    }
+    /* FNV-1a */
+    v_uint32 result = 2166136261u;
+    for(v_buff_size i = 0; i < size; i ++) {
+      result = (result ^ static_cast<v_uint8>(data[i])) * 16777619u;
+    }
+    return result;
+  }
+
+  static v_uint32 getSeed(v_uint32 attempt) {
+    return (0x9E3779B1u + attempt * 0x6A09E667u) | 1u;
+  }
+
+  static bool hasDuplicates(std::vector<v_uint32> hashes) {
+    std::sort(hashes.begin(), hashes.end());
+    return std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end();
+  }
+
+private:
+  std::vector<Slot> m_slots;
+  std::vector<v_uint32> m_displacements;
+  v_uint32 m_bucketSeed = 0;
+  v_uint32 m_bucketShift = 0;
+  v_uint32 m_slotSeed = 0;
+  v_uint32 m_slotShift = 0;
+  Mode m_mode = Mode::SAMPLED;
+  bool m_perfect = true;
+  v_uint64 m_size = 0;
+private:
+
+  v_uint32 getBucket(v_uint32 hashValue) const {
+    return (hashValue * m_bucketSeed) >> m_bucketShift;
+  }
+
+  v_uint32 getBaseSlot(v_uint32 hashValue) const {
+    return (hashValue * m_slotSeed) >> m_slotShift;
+  }
+
+  bool tryPlace(const std::vector<std::pair<std::string, V>>& items, const std::vector<v_uint32>& hashes,
+                v_uint32 slotBits, v_uint32 bucketBits, v_uint32 attempt)
+  {
+
+    m_bucketSeed = getSeed(attempt * 2);
+    m_bucketShift = 32 - bucketBits;
+    m_slotSeed = getSeed(attempt * 2 + 1);
+    m_slotShift = 32 - slotBits;
+
+    v_uint32 slotsCount = 1u << slotBits;
+
+    std::vector<std::vector<size_t>> buckets(static_cast<size_t>(1) << bucketBits);
+    for(size_t i = 0; i < items.size(); i ++) {
+      buckets[getBucket(hashes[i])].push_back(i);
+    }
+
+    /* biggest buckets first - they are the hardest to place */
+    std::vector<v_uint32> order(buckets.size());
+    for(v_uint32 i = 0; i < order.size(); i ++) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](v_uint32 a, v_uint32 b) {
+      return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<bool> taken(slotsCount, false);
+    m_displacements.assign(buckets.size(), 0);
+
+    for(auto b : order) {
+      const auto& bucket = buckets[b];
+      if(bucket.empty()) {
+        break;
+      }
+      bool placed = false;
+      for(v_uint32 d = 0; d < slotsCount && !placed; d ++) {
+        placed = true;
+        for(size_t k = 0; k < bucket.size() && placed; k ++) {
+          auto slot = getBaseSlot(hashes[bucket[k]]) ^ d;
+          placed = !taken[slot];
+          /* two names of the bucket in one slot */
+          for(size_t j = 0; j < k && placed; j ++) {
+            placed = (getBaseSlot(hashes[bucket[j]]) ^ d) != slot;
+          }
+        }
+        if(placed) {
+          m_displacements[b] = d;
+          for(auto i : bucket) {
+            taken[getBaseSlot(hashes[i]) ^ d] = true;
+          }
+        }
+      }
+      if(!placed) {
+        return false;
+      }
+    }
+
+    m_slots.assign(slotsCount, Slot());
+    for(size_t i = 0; i < items.size(); i ++) {
+      auto& slot = m_slots[getBaseSlot(hashes[i]) ^ m_displacements[getBucket(hashes[i])]];
+      slot.name = items[i].first;
+      slot.value = items[i].second;
+      slot.used = true;
+    }
+    return true;
+
+  }
+
+public:
+
+  /**
+   * Default constructor. Empty table.
+   */
+  NameTable() = default;
+
+  /**
+   * Constructor.
+   * @param items - names and values. If a name repeats, the last value is kept.
+   */
+  explicit NameTable(const std::vector<std::pair<std::string, V>>& items) {
+
+    std::vector<std::pair<std::string, V>> unique;
+    std::unordered_map<std::string, size_t> positions;
+    for(const auto& item : items) {
+      auto it = positions.find(item.first);
+      if(it == positions.end()) {
+        positions[item.first] = unique.size();
+        unique.push_back(item);
+      } else {
+        unique[it->second].second = item.second;
+      }
+    }
+
+    m_size = unique.size();
+    if(unique.empty()) {
+      return;
+    }
+
+    std::vector<v_uint32> hashes(unique.size());
+    for(auto mode : {Mode::SAMPLED, Mode::FULL}) {
+      m_mode = mode;
+      for(size_t i = 0; i < unique.size(); i ++) {
+        hashes[i] = hash(mode, unique[i].first.data(), static_cast<v_buff_size>(unique[i].first.size()));
+      }
+      if(!hasDuplicates(hashes)) {
+        break;
+      }
+    }
+
+    /* at least 2 slots and 2 buckets - shift by 32 is undefined */
+    v_uint32 slotBits = 1;
+    while((static_cast<v_uint64>(1) << slotBits) < m_size) {
+      slotBits ++;
+    }
+    v_uint32 bucketBits = slotBits > 2 ? slotBits - 1 : 1;
+
+    if(!hasDuplicates(hashes)) {
+      for(v_uint32 bits = slotBits; bits <= slotBits + 1 && bits < 32; bits ++) {
+        for(v_uint32 attempt = 0; attempt < MAX_SEEDS; attempt ++) {
+          if(tryPlace(unique, hashes, bits, bucketBits, attempt)) {
+            return;
+          }
+        }
+      }
+    }
+
+    /* no perfect hash - linear probing, load factor <= 0.5 */
+    m_perfect = false;
+    m_bucketSeed = getSeed(0);
+    m_bucketShift = 31;
+    m_displacements.assign(2, 0);
+    m_slotSeed = getSeed(1);
+    m_slotShift = 32 - (slotBits + 1);
+    m_slots.assign(static_cast<size_t>(1) << (slotBits + 1), Slot());
+    auto mask = static_cast<v_uint32>(m_slots.size() - 1);
+    for(size_t i = 0; i < unique.size(); i ++) {
+      auto s = getBaseSlot(hashes[i]);
+      while(m_slots[s].used) {
+        s = (s + 1) & mask;
+      }
+      m_slots[s].name = unique[i].first;
+      m_slots[s].value = unique[i].second;
+      m_slots[s].used = true;
+    }
+
+  }
+
+  /**
+   * Find value by name.
+   * @param name - name.
+   * @param size - name size.
+   * @return - pointer to the value or `nullptr` if there is no such name.
+   */
+  const V* find(const char* name, v_buff_size size) const {
+    if(m_slots.empty()) {
+      return nullptr;
+    }
+    auto mask = static_cast<v_uint32>(m_slots.size() - 1);
+    auto h = hash(m_mode, name, size);
+    auto i = getBaseSlot(h) ^ m_displacements[getBucket(h)];
+    while(true) {
+      const auto& slot = m_slots[i];
+      if(!slot.used) {
+        return nullptr;
+      }
+      if(static_cast<v_buff_size>(slot.name.size()) == size && std::memcmp(slot.name.data(), name, static_cast<size_t>(size)) == 0) {
+        return &slot.value;
+      }
+      if(m_perfect) {
+        return nullptr;
+      }
+      i = (i + 1) & mask;
+    }
+  }
+
+  /**
+   * Find value by name.
+   * @param name - name.
+   * @return - pointer to the value or `nullptr` if there is no such name.
+   */
+  const V* find(const std::string& name) const {
+    return find(name.data(), static_cast<v_buff_size>(name.size()));
+  }
+
+  /**
+   * Count of names.
+   * @return
+   */
+  v_uint64 size() const {
+    return m_size;
+  }
+
+  /**
+   * Check if the table is empty.
+   * @return
+   */
+  bool empty() const {
+    return m_size == 0;
+  }
+
+  /**
+   * Check if every name has its own slot - lookup is one probe.
+   * @return
+   */
+  bool isPerfect() const {
+    return m_perfect;
+  }
+
+};
+
+}}
+
+#endif /* OATPP_XML_NAMETABLE_HPP */
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "NamespaceScope.hpp"
+
+#include <cstring>
+
+namespace oatpp { namespace xml {
+
+const char* const NamespaceScope::XML_NAMESPACE_URI = "http://www.w3.org/XML/1998/namespace";
+
+NamespaceScope::NamespaceScope()
+  : m_map(std::make_shared<Map>())
+{
+  oatpp::String prefix = "xml";
+  m_map->insert({data::share::StringKeyLabel(prefix), oatpp::String(XML_NAMESPACE_URI)});
+}
+
+void NamespaceScope::declare(const oatpp::String& prefix, const oatpp::String& uri) {
+  if(m_map.use_count() > 1) {
+    m_map = std::make_shared<Map>(*m_map);
+  }
+  if(prefix->empty() && uri->empty()) {
+    m_map->erase(data::share::StringKeyLabel(prefix));
+    return;
+  }
+  (*m_map)[data::share::StringKeyLabel(prefix)] = uri;
+}
+
+oatpp::String NamespaceScope::resolve(const char* prefix, v_buff_size prefixSize) const {
+  auto it = m_map->find(data::share::StringKeyLabel(nullptr, prefix, prefixSize));
+  if(it != m_map->end()) {
+    return it->second;
+  }
+  return nullptr;
+}
+
+const NamespaceScope& NamespaceScope::getRoot() {
+  static const NamespaceScope root;
+  return root;
+}
+
+bool NamespaceScope::isDeclaration(const oatpp::String& attributeName) {
+  return attributeName->compare(0, 5, "xmlns") == 0 && (attributeName->size() == 5 || (*attributeName)[5] == ':');
+}
+
+oatpp::String NamespaceScope::makeExpandedName(const oatpp::String& uri, const char* localName, v_buff_size localNameSize) {
+  if(!uri || uri->empty()) {
+    return oatpp::String(localName, localNameSize);
+  }
+  oatpp::String result(static_cast<v_buff_size>(uri->size()) + localNameSize + 2);
+  auto data = result->data();
+  data[0] = '{';
+  std::memcpy(data + 1, uri->data(), uri->size());
+  data[uri->size() + 1] = '}';
+  std::memcpy(data + uri->size() + 2, localName, static_cast<size_t>(localNameSize));
+  return result;
+}
+
+void NamespaceScope::splitExpandedName(const oatpp::String& name, oatpp::String& uri, oatpp::String& localName) {
+  if(name && name->size() > 1 && name->data()[0] == '{') {
+    auto end = name->find('}');
+    if(end != std::string::npos) {
+      uri = oatpp::String(name->data() + 1, static_cast<v_buff_size>(end - 1));
+      localName = oatpp::String(name->data() + end + 1, static_cast<v_buff_size>(name->size() - end - 1));
+      return;
+    }
+  }
+  uri = nullptr;
+  localName = name;
+}
+
+}}
@@ -0,0 +1,113 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_NAMESPACESCOPE_HPP
+#define OATPP_XML_NAMESPACESCOPE_HPP
+
+#include "oatpp/data/share/MemoryLabel.hpp"
+#include "oatpp/Types.hpp"
+
+#include <unordered_map>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Namespace declarations visible in an element scope. <br>
+ * Scope maps prefixes to namespace URIs. Child scopes share the parent's map and copy it
+ * only when they declare new prefixes (copy-on-write), so elements without `xmlns` declarations cost nothing.
+ */
+class NamespaceScope {
+public:
+
+  /**
+   * URI of the predefined `xml` prefix.
+   */
+  static const char* const XML_NAMESPACE_URI;
+
+  /**
+   * Prefix to URI map. Empty prefix is the default namespace.
+   */
+  typedef std::unordered_map<data::share::StringKeyLabel, oatpp::String> Map;
+
+private:
+  std::shared_ptr<Map> m_map;
+public:
+
+  /**
+   * Constructor. Creates the root scope with only the `xml` prefix declared.
+   */
+  NamespaceScope();
+
+  /**
+   * Declare prefix. Copies the map if it is shared with another scope.
+   * @param prefix - prefix. Empty prefix - default namespace.
+   * @param uri - namespace URI. Empty URI for the default namespace - undeclare default namespace.
+   */
+  void declare(const oatpp::String& prefix, const oatpp::String& uri);
+
+  /**
+   * Resolve prefix.
+   * @param prefix - prefix data.
+   * @param prefixSize - prefix size.
+   * @return - namespace URI or `nullptr` if prefix is not declared.
+   */
+  oatpp::String resolve(const char* prefix, v_buff_size prefixSize) const;
+
+public:
+
+  /**
+   * Get the root scope.
+   * @return
+   */
+  static const NamespaceScope& getRoot();
+
+  /**
+   * Check if attribute name is a namespace declaration - `xmlns` or `xmlns:prefix`.
+   * @param attributeName
+   * @return
+   */
+  static bool isDeclaration(const oatpp::String& attributeName);
+
+  /**
+   * Make expanded name - `{uri}localName`.
+   * @param uri - namespace URI.
+   * @param localName - local name data.
+   * @param localNameSize - local name size.
+   * @return
+   */
+  static oatpp::String makeExpandedName(const oatpp::String& uri, const char* localName, v_buff_size localNameSize);
+
+  /**
+   * Split expanded name `{uri}localName` to (URI, local name) pair.
+   * @param name - expanded name.
+   * @param uri - out namespace URI. `nullptr` if name has no namespace.
+   * @param localName - out local name.
+   */
+  static void splitExpandedName(const oatpp::String& name, oatpp::String& uri, oatpp::String& localName);
+
+};
+
+}}
+
+#endif //OATPP_XML_NAMESPACESCOPE_HPP
@@ -0,0 +1,257 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "NumberFormat.hpp"
+
+#include <charconv>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+const char DIGIT_PAIRS[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool SWAR_ENABLED = false;
+#else
+constexpr bool SWAR_ENABLED = true;
+#endif
+
+/* eight ASCII digits in a little-endian word */
+bool isEightDigits(v_uint64 word) {
+  return (((word + 0x4646464646464646) | (word - 0x3030303030303030)) & 0x8080808080808080) == 0;
+}
+
+v_uint64 parseEightDigits(v_uint64 word) {
+  word = ((word & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+  word = ((word & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+  return ((word & 0x0000FFFF0000FFFF) * 42949672960001) >> 32;
+}
+
+v_buff_size countDigits(v_uint64 value) {
+  v_buff_size count = 1;
+  while(value >= 10000) {
+    value /= 10000;
+    count += 4;
+  }
+  if(value >= 1000) return count + 3;
+  if(value >= 100) return count + 2;
+  if(value >= 10) return count + 1;
+  return count;
+}
+
+}
+
+v_buff_size NumberFormat::formatUInt64(v_uint64 value, char* data) {
+
+  auto size = countDigits(value);
+  auto p = data + size;
+
+  while(value >= 100) {
+    auto pair = static_cast<size_t>(value % 100) * 2;
+    value /= 100;
+    p -= 2;
+    p[0] = DIGIT_PAIRS[pair];
+    p[1] = DIGIT_PAIRS[pair + 1];
+  }
+
+  if(value >= 10) {
+    auto pair = static_cast<size_t>(value) * 2;
+    p -= 2;
+    p[0] = DIGIT_PAIRS[pair];
+    p[1] = DIGIT_PAIRS[pair + 1];
+  } else {
+    p[-1] = static_cast<char>('0' + value);
+  }
+
+  return size;
+
+}
+
+v_buff_size NumberFormat::formatInt64(v_int64 value, char* data) {
+  if(value < 0) {
+    data[0] = '-';
+    /* negate in unsigned arithmetic - works for INT64_MIN too */
+    return formatUInt64(0 - static_cast<v_uint64>(value), data + 1) + 1;
+  }
+  return formatUInt64(static_cast<v_uint64>(value), data);
+}
+
+bool NumberFormat::parseUInt64(const char* text, v_buff_size size, v_uint64& value) {
+
+  /* up to 19 digits never overflow */
+  if(size <= 0 || size > 20) {
+    return false;
+  }
+
+  v_uint64 result = 0;
+  v_buff_size i = 0;
+
+  if(SWAR_ENABLED) {
+    while(size - i >= 8) {
+      v_uint64 word;
+      std::memcpy(&word, text + i, 8);
+      if(!isEightDigits(word)) {
+        return false;
+      }
+      result = result * 100000000 + parseEightDigits(word);
+      i += 8;
+    }
+  }
+
+  for(; i < size; i ++) {
+    auto digit = static_cast<v_uint64>(static_cast<v_char8>(text[i]) - '0');
+    if(digit > 9) {
+      return false;
+    }
+    if(size == 20 && result > (UINT64_MAX - digit) / 10) {
+      return false;
+    }
+    result = result * 10 + digit;
+  }
+
+  value = result;
+  return true;
+
+}
+
+bool NumberFormat::parseInt64(const char* text, v_buff_size size, v_int64& value) {
+
+  bool negative = false;
+  if(size > 0 && (text[0] == '-' || text[0] == '+')) {
+    negative = text[0] == '-';
+    text ++;
+    size --;
+  }
+
+  v_uint64 magnitude;
+  if(!parseUInt64(text, size, magnitude)) {
+    return false;
+  }
+
+  if(negative) {
+    if(magnitude > static_cast<v_uint64>(INT64_MAX) + 1) {
+      return false;
+    }
+    value = static_cast<v_int64>(0 - magnitude);
+    return true;
+  }
+
+  if(magnitude > static_cast<v_uint64>(INT64_MAX)) {
+    return false;
+  }
+  value = static_cast<v_int64>(magnitude);
+  return true;
+
+}
+
+#if defined(__cpp_lib_to_chars)
+
+bool NumberFormat::parseFloat32(const char* text, v_buff_size size, v_float32& value) {
+  auto result = std::from_chars(text, text + size, value);
+  return result.ec == std::errc() && result.ptr == text + size;
+}
+
+bool NumberFormat::parseFloat64(const char* text, v_buff_size size, v_float64& value) {
+  auto result = std::from_chars(text, text + size, value);
+  return result.ec == std::errc() && result.ptr == text + size;
+}
+
+v_buff_size NumberFormat::formatFloat32(v_float32 value, char* data) {
+  auto result = std::to_chars(data, data + MAX_SIZE, value);
+  return result.ptr - data;
+}
+
+v_buff_size NumberFormat::formatFloat64(v_float64 value, char* data) {
+  auto result = std::to_chars(data, data + MAX_SIZE, value);
+  return result.ptr - data;
+}
+
+#else
+
+/* no floating-point std::to_chars - round-trip, but not always the shortest */
+
+namespace {
+
+bool copyNumber(const char* text, v_buff_size size, char* buffer) {
+  if(size <= 0 || size >= 64) {
+    return false;
+  }
+  std::memcpy(buffer, text, static_cast<size_t>(size));
+  buffer[size] = 0;
+  /* strtod skips leading whitespace and accepts hex - from_chars doesn't */
+  auto c = buffer[0];
+  return c == '-' || c == '.' || (c >= '0' && c <= '9');
+}
+
+}
+
+bool NumberFormat::parseFloat32(const char* text, v_buff_size size, v_float32& value) {
+  char buffer[64];
+  if(!copyNumber(text, size, buffer)) {
+    return false;
+  }
+  char* end;
+  errno = 0;
+  value = std::strtof(buffer, &end);
+  return errno == 0 && end == buffer + size;
+}
+
+bool NumberFormat::parseFloat64(const char* text, v_buff_size size, v_float64& value) {
+  char buffer[64];
+  if(!copyNumber(text, size, buffer)) {
+    return false;
+  }
+  char* end;
+  errno = 0;
+  value = std::strtod(buffer, &end);
+  return errno == 0 && end == buffer + size;
+}
+
+v_buff_size NumberFormat::formatFloat32(v_float32 value, char* data) {
+  return std::snprintf(data, MAX_SIZE, "%.9g", static_cast<double>(value));
+}
+
+v_buff_size NumberFormat::formatFloat64(v_float64 value, char* data) {
+  return std::snprintf(data, MAX_SIZE, "%.17g", value);
+}
+
+#endif
+
+}}
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_NUMBERFORMAT_HPP
+#define OATPP_XML_NUMBERFORMAT_HPP
+
+#include "oatpp/Types.hpp"
+
+namespace oatpp { namespace xml {
+
+/**
+ * Number formatting and parsing. <br>
+ * Integers are formatted two digits at a time with a digit-pair table and parsed eight digits at a time (SWAR).
+ * Floats are formatted to the shortest string which parses back to the same value (round-trip).
+ */
+class NumberFormat {
+public:
+
+  /**
+   * Max size of a formatted number.
+   */
+  static constexpr v_buff_size MAX_SIZE = 32;
+
+public:
+
+  /**
+   * Format unsigned integer.
+   * @param value
+   * @param data - out buffer of at least &l:NumberFormat::MAX_SIZE; bytes.
+   * @return - size of the formatted number.
+   */
+  static v_buff_size formatUInt64(v_uint64 value, char* data);
+
+  /**
+   * Format signed integer.
+   * @param value
+   * @param data - out buffer of at least &l:NumberFormat::MAX_SIZE; bytes.
+   * @return - size of the formatted number.
+   */
+  static v_buff_size formatInt64(v_int64 value, char* data);
+
+  /**
+   * Format float to the shortest round-trip representation.
+   * @param value
+   * @param data - out buffer of at least &l:NumberFormat::MAX_SIZE; bytes.
+   * @return - size of the formatted number.
+   */
+  static v_buff_size formatFloat32(v_float32 value, char* data);
+
+  /**
+   * Format double to the shortest round-trip representation.
+   * @param value
+   * @param data - out buffer of at least &l:NumberFormat::MAX_SIZE; bytes.
+   * @return - size of the formatted number.
+   */
+  static v_buff_size formatFloat64(v_float64 value, char* data);
+
+  /**
+   * Parse unsigned integer. The whole text must be decimal digits.
+   * @param text - text data.
+   * @param size - text size.
+   * @param value - out value.
+   * @return - `false` if text is not an integer or the value is out of range.
+   */
+  static bool parseUInt64(const char* text, v_buff_size size, v_uint64& value);
+
+  /**
+   * Parse signed integer - decimal digits with an optional sign.
+   * @param text - text data.
+   * @param size - text size.
+   * @param value - out value.
+   * @return - `false` if text is not an integer or the value is out of range.
+   */
+  static bool parseInt64(const char* text, v_buff_size size, v_int64& value);
+
+  /**
+   * Parse float. The whole text must be a number.
+   * @param text - text data.
+   * @param size - text size.
+   * @param value - out value.
+   * @return - `false` if text is not a number.
+   */
+  static bool parseFloat32(const char* text, v_buff_size size, v_float32& value);
+
+  /**
+   * Parse double. The whole text must be a number.
+   * @param text - text data.
+   * @param size - text size.
+   * @param value - out value.
+   * @return - `false` if text is not a number.
+   */
+  static bool parseFloat64(const char* text, v_buff_size size, v_float64& value);
+
+};
+
+}}
+
+#endif //OATPP_XML_NUMBERFORMAT_HPP
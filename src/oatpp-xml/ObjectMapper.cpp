@@ -24,19 +24,302 @@
 
 #include "ObjectMapper.hpp"
 
+#include "./Base64.hpp"
+#include "./NameTable.hpp"
+#include "./Transcoder.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <optional>
+
 namespace oatpp { namespace xml {
 
+namespace {
+
+/* write buffer memory is kept per thread and reused between calls */
+Serializer::Context& getSerializerContext() {
+  static thread_local Serializer::Context context;
+  return context;
+}
+
+/* fields of a DTO type by element name */
+struct ObjectFields {
+  NameTable<oatpp::BaseObject::Property*> table;
+  /* type-selected fields are mapped after the others */
+  bool hasTypeSelectors = false;
+};
+
+/* built once per DTO type - types live as long as the program */
+const ObjectFields& getObjectFields(const data::type::Type* type) {
+  static TypeCache<ObjectFields> cache;
+  return cache.get(type, [](const data::type::Type* t) {
+    ObjectFields result;
+    auto dispatcher = static_cast<const data::type::__class::AbstractObject::PolymorphicDispatcher*>(t->polymorphicDispatcher);
+    std::vector<std::pair<std::string, oatpp::BaseObject::Property*>> fields;
+    for(auto const& field : dispatcher->getProperties()->getList()) {
+      fields.emplace_back(field->name, field);
+      if(field->info.typeSelector) {
+        result.hasTypeSelectors = true;
+      }
+    }
+    result.table = NameTable<oatpp::BaseObject::Property*>(fields);
+    return result;
+  });
+}
+
+template<class T>
+oatpp::Void copyValue(const oatpp::Void& value) {
+  return oatpp::Void(std::make_shared<T>(*static_cast<const T*>(value.get())), value.getValueType());
+}
+
+/*
+ * deep copy of a mapped value - values kept in the parse cache are shared and are never handed out.
+ * Returns false for types which can't be copied generically - enums, Any, Tree and custom types.
+ */
+bool cloneValue(const oatpp::Void& value, oatpp::Void& result) {
+
+  namespace c = data::type::__class;
+
+  auto type = value.getValueType();
+  if(!value) {
+    result = oatpp::Void(type);
+    return true;
+  }
+
+  auto id = type->classId.id;
+
+  if(id == c::String::CLASS_ID.id || id == __class::Binary::CLASS_ID.id) {
+    result = copyValue<std::string>(value);
+  } else if(id == c::Int8::CLASS_ID.id) {
+    result = copyValue<v_int8>(value);
+  } else if(id == c::UInt8::CLASS_ID.id) {
+    result = copyValue<v_uint8>(value);
+  } else if(id == c::Int16::CLASS_ID.id) {
+    result = copyValue<v_int16>(value);
+  } else if(id == c::UInt16::CLASS_ID.id) {
+    result = copyValue<v_uint16>(value);
+  } else if(id == c::Int32::CLASS_ID.id) {
+    result = copyValue<v_int32>(value);
+  } else if(id == c::UInt32::CLASS_ID.id) {
+    result = copyValue<v_uint32>(value);
+  } else if(id == c::Int64::CLASS_ID.id) {
+    result = copyValue<v_int64>(value);
+  } else if(id == c::UInt64::CLASS_ID.id) {
+    result = copyValue<v_uint64>(value);
+  } else if(id == c::Float32::CLASS_ID.id) {
+    result = copyValue<v_float32>(value);
+  } else if(id == c::Float64::CLASS_ID.id) {
+    result = copyValue<v_float64>(value);
+  } else if(id == c::Boolean::CLASS_ID.id) {
+    result = copyValue<bool>(value);
+  } else if(id == c::AbstractObject::CLASS_ID.id) {
+    auto dispatcher = static_cast<const c::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+    auto object = dispatcher->createObject();
+    auto source = static_cast<oatpp::BaseObject*>(value.get());
+    auto target = static_cast<oatpp::BaseObject*>(object.get());
+    for(auto const& property : dispatcher->getProperties()->getList()) {
+      oatpp::Void field;
+      if(!cloneValue(property->get(source), field)) {
+        return false;
+      }
+      property->set(target, field);
+    }
+    result = object;
+  } else if(id == c::AbstractVector::CLASS_ID.id || id == c::AbstractList::CLASS_ID.id || id == c::AbstractUnorderedSet::CLASS_ID.id) {
+    auto dispatcher = static_cast<const c::Collection::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+    auto collection = dispatcher->createObject();
+    for(auto it = dispatcher->beginIteration(value); !it->finished(); it->next()) {
+      oatpp::Void item;
+      if(!cloneValue(it->get(), item)) {
+        return false;
+      }
+      dispatcher->addItem(collection, item);
+    }
+    result = collection;
+  } else if(id == c::AbstractPairList::CLASS_ID.id || id == c::AbstractUnorderedMap::CLASS_ID.id) {
+    auto dispatcher = static_cast<const c::Map::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+    auto map = dispatcher->createObject();
+    for(auto it = dispatcher->beginIteration(value); !it->finished(); it->next()) {
+      oatpp::Void key;
+      oatpp::Void item;
+      if(!cloneValue(it->getKey(), key) || !cloneValue(it->getValue(), item)) {
+        return false;
+      }
+      dispatcher->addItem(map, key, item);
+    }
+    result = map;
+  } else {
+    return false;
+  }
+
+  return true;
+
+}
+
+}
+
 ObjectMapper::ObjectMapper(const SerializerConfig& serializerConfig, const DeserializerConfig& deserializerConfig)
   : data::mapping::ObjectMapper(getMapperInfo())
   , m_serializerConfig(serializerConfig)
   , m_deserializerConfig(deserializerConfig)
-{}
+  , m_cacheToken(std::make_shared<v_uint8>(0))
+{
+  m_objectToTreeMapper.setMapperMethod(__class::Binary::CLASS_ID, &mapBinaryToTree);
+  m_treeToObjectMapper.setMapperMethod(__class::Binary::CLASS_ID, &mapTreeToBinary);
+  m_treeToObjectMapper.setMapperMethod(data::type::__class::AbstractObject::CLASS_ID, &mapTreeToObject);
+  m_objectToTreeMapper.setMapperMethod(__class::Fragment::CLASS_ID, &mapFragmentToTree);
+}
+
+void ObjectMapper::mapBinaryToTree(const data::mapping::ObjectToTreeMapper* mapper,
+                                   data::mapping::ObjectToTreeMapper::State& state,
+                                   const oatpp::Void& polymorph)
+{
+
+  (void) mapper;
+
+  if(!polymorph) {
+    state.tree->setNull();
+    return;
+  }
+
+  state.tree->setPairs({});
+  auto& pairs = state.tree->getPairs();
+  pairs.emplace_back("!BASE64", data::mapping::Tree());
+  pairs.back().second.setString(oatpp::String(std::static_pointer_cast<std::string>(polymorph.getPtr())));
+
+}
+
+void ObjectMapper::mapFragmentToTree(const data::mapping::ObjectToTreeMapper* mapper,
+                                     data::mapping::ObjectToTreeMapper::State& state,
+                                     const oatpp::Void& polymorph)
+{
+
+  if(!polymorph) {
+    state.tree->setNull();
+    return;
+  }
+
+  auto fragment = static_cast<const FragmentData*>(polymorph.get());
+
+  data::mapping::Tree content;
+  data::mapping::ObjectToTreeMapper::State nested;
+  nested.config = state.config;
+  nested.tree = &content;
+  mapper->map(nested, fragment->value);
+  if(!nested.errorStack.empty()) {
+    state.errorStack.splice(nested.errorStack);
+    return;
+  }
+
+  state.tree->setPairs({});
+  state.tree->getPairs().emplace_back(FragmentCache::NODE_NAME, FragmentCache::makeNode(fragment->id, fragment->version, std::move(content)));
+
+}
+
+oatpp::Void ObjectMapper::mapTreeToBinary(const data::mapping::TreeToObjectMapper* mapper,
+                                          data::mapping::TreeToObjectMapper::State& state,
+                                          const oatpp::Type* type)
+{
+
+  (void) mapper;
+
+  const auto& tree = *state.tree;
+
+  if(tree.isNull() || tree.getType() == data::mapping::Tree::Type::UNDEFINED) {
+    return oatpp::Void(type);
+  }
+
+  /* decoded by the deserializer */
+  if(tree.getType() == data::mapping::Tree::Type::PAIRS) {
+    const auto& pairs = tree.getPairs();
+    if(pairs.size() == 1 && pairs[0].first == "!BASE64" && pairs[0].second.getType() == data::mapping::Tree::Type::STRING) {
+      return Binary(pairs[0].second.getString().getPtr());
+    }
+  }
+
+  if(tree.getType() != data::mapping::Tree::Type::STRING) {
+    state.errorStack.push("[oatpp::xml::ObjectMapper::mapTreeToBinary()]: Node is NOT a base64 string.");
+    return nullptr;
+  }
+
+  const auto& text = tree.getString();
+  std::string data(static_cast<size_t>(Base64::getMaxDecodedSize(static_cast<v_buff_size>(text->size()))), '\0');
+  auto size = Base64::decode(text->data(), static_cast<v_buff_size>(text->size()), &data[0]);
+  if(size < 0) {
+    state.errorStack.push("[oatpp::xml::ObjectMapper::mapTreeToBinary()]: Invalid base64 text.");
+    return nullptr;
+  }
+  data.resize(static_cast<size_t>(size));
+
+  return Binary(std::move(data));
+
+}
+
+oatpp::Void ObjectMapper::mapTreeToObject(const data::mapping::TreeToObjectMapper* mapper,
+                                          data::mapping::TreeToObjectMapper::State& state,
+                                          const oatpp::Type* type)
+{
+
+  const auto& tree = *state.tree;
+  const auto& fields = getObjectFields(type);
+
+  /* element content - anything else, attributes and type-selected fields are left to the generic mapper */
+  if(tree.getType() != data::mapping::Tree::Type::PAIRS || tree.attributes().size() > 0 || fields.hasTypeSelectors) {
+    return data::mapping::TreeToObjectMapper::mapObject(mapper, state, type);
+  }
+
+  auto dispatcher = static_cast<const data::type::__class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+  auto object = dispatcher->createObject();
+  auto base = static_cast<oatpp::BaseObject*>(object.get());
+
+  for(const auto& pair : tree.getPairs()) {
+
+    const auto& name = pair.first;
+    auto field = name ? fields.table.find(name->data(), static_cast<v_buff_size>(name->size())) : nullptr;
+
+    if(field == nullptr) {
+      if(!state.config->allowUnknownFields) {
+        state.errorStack.push("[oatpp::xml::ObjectMapper::mapTreeToObject()]: Error. Unknown field '" + name + "'");
+        return nullptr;
+      }
+      continue;
+    }
+
+    auto property = *field;
 
-void ObjectMapper::writeTree(data::stream::ConsistentOutputStream* stream, const data::mapping::Tree& tree, data::mapping::ErrorStack& errorStack) const {
+    data::mapping::TreeToObjectMapper::State nested;
+    nested.tree = &pair.second;
+    nested.config = state.config;
+
+    auto value = mapper->map(nested, property->type);
+    if(!nested.errorStack.empty()) {
+      state.errorStack.splice(nested.errorStack);
+      state.errorStack.push("[oatpp::xml::ObjectMapper::mapTreeToObject()]: field='" + name + "'");
+      return nullptr;
+    }
+
+    if(property->info.required && value == nullptr) {
+      state.errorStack.push("[oatpp::xml::ObjectMapper::mapTreeToObject()]: Error. Field '" + name + "' is required.");
+      return nullptr;
+    }
+
+    property->set(base, value);
+
+  }
+
+  return object;
+
+}
+
+void ObjectMapper::writeTree(data::stream::ConsistentOutputStream* stream, WriteBuffer* buffer,
+                             const data::mapping::Tree& tree, data::mapping::ErrorStack& errorStack) const
+{
   Serializer::State state;
   state.config = &m_serializerConfig.xml;
   state.tree = &tree;
   state.stream = stream;
+  state.context = &getSerializerContext();
+  state.buffer = buffer;
   Serializer::serialize(state);
   if(!state.errorStack.empty()) {
     errorStack = std::move(state.errorStack);
@@ -44,12 +327,32 @@ void ObjectMapper::writeTree(data::stream::ConsistentOutputStream* stream, const
   }
 }
 
-void ObjectMapper::write(data::stream::ConsistentOutputStream* stream, const oatpp::Void& variant, data::mapping::ErrorStack& errorStack) const {
+void ObjectMapper::writeValue(data::stream::ConsistentOutputStream* stream, WriteBuffer* buffer,
+                              const oatpp::Void& variant, data::mapping::ErrorStack& errorStack) const
+{
 
   /* if variant is Tree - we can serialize it right away */
   if(variant.getValueType() == oatpp::Tree::Class::getType()) {
     auto tree = static_cast<const data::mapping::Tree*>(variant.get());
-    writeTree(stream, *tree, errorStack);
+    writeTree(stream, buffer, *tree, errorStack);
+    return;
+  }
+
+  /* DTOs and collections are written directly, field tags are taken from the per-type cache */
+  if(variant && ObjectSerializer::isSupported(variant.getValueType())) {
+    ObjectSerializer::State state;
+    state.mapper = &m_objectToTreeMapper;
+    state.mapperConfig = &m_serializerConfig.mapper;
+    state.tagCache = &m_tagCache;
+    state.xml.config = &m_serializerConfig.xml;
+    state.xml.tree = nullptr;
+    state.xml.stream = stream;
+    state.xml.context = &getSerializerContext();
+    state.xml.buffer = buffer;
+    ObjectSerializer::serialize(state, variant);
+    if(!state.xml.errorStack.empty()) {
+      errorStack = std::move(state.xml.errorStack);
+    }
     return;
   }
 
@@ -65,43 +368,196 @@ void ObjectMapper::write(data::stream::ConsistentOutputStream* stream, const oat
     return;
   }
 
-  writeTree(stream, tree, errorStack);
+  writeTree(stream, buffer, tree, errorStack);
+
+}
+
+void ObjectMapper::write(data::stream::ConsistentOutputStream* stream, const oatpp::Void& variant, data::mapping::ErrorStack& errorStack) const {
+  writeValue(stream, nullptr, variant, errorStack);
+}
+
+oatpp::String ObjectMapper::writeToString(const oatpp::Void& variant) const {
+
+  auto threshold = m_serializerConfig.xml.twoPassThreshold;
+  if(threshold <= 0) {
+    return data::mapping::ObjectMapper::writeToString(variant);
+  }
+
+  data::mapping::ErrorStack errorStack;
+
+  /* first pass - small output is written to the scratch buffer, big output is only measured */
+  WriteBuffer scratch(getSerializerContext().getBuffer(threshold), threshold);
+  writeValue(nullptr, &scratch, variant, errorStack);
+  if(!errorStack.empty()) {
+    throw data::mapping::MappingError(std::move(errorStack));
+  }
+
+  if(!scratch.isOverflown()) {
+    return oatpp::String(scratch.getData(), scratch.getSize());
+  }
+
+  /* second pass - write straight to the string of the exact size */
+  auto size = scratch.getSize();
+  oatpp::String result(size);
+  WriteBuffer exact(result->data(), size);
+  writeValue(nullptr, &exact, variant, errorStack);
+  if(!errorStack.empty()) {
+    throw data::mapping::MappingError(std::move(errorStack));
+  }
+
+  if(exact.isOverflown() || exact.getSize() != size) {
+    /* value changed between the passes */
+    return data::mapping::ObjectMapper::writeToString(variant);
+  }
+
+  return result;
+
+}
+
+void ObjectMapper::readTree(utils::parser::Caret& caret, const data::type::Type* type,
+                            data::mapping::Tree& tree, data::mapping::ErrorStack& errorStack) const
+{
+
+  /* parser scratch buffers are kept per thread and reused between calls */
+  static thread_local Deserializer::Context context;
+
+  auto start = caret.getPosition();
+
+  v_buff_size bomSize;
+  auto encoding = Transcoder::detect(caret.getCurrData(), caret.getDataSize() - start, bomSize);
+
+  if(encoding == Transcoder::Encoding::UNKNOWN) {
+    Error error;
+    error.set(Error::Code::UNSUPPORTED_ENCODING, start);
+    error.renderTo(errorStack, "oatpp::xml::Deserializer", caret.getData(), caret.getDataSize());
+    return;
+  }
+
+  /*
+   * UTF-8 is parsed in place, other encodings - from a full UTF-8 copy of the document.
+   * The deserializer needs the whole document in one piece, so the copy isn't replaced by a sliding window.
+   */
+  auto input = &caret;
+  std::optional<data::stream::BufferOutputStream> transcoded;
+  std::optional<utils::parser::Caret> transcodedCaret;
+
+  if(encoding == Transcoder::Encoding::UTF_8) {
+    caret.inc(bomSize);
+  } else {
+    auto size = caret.getDataSize() - start - bomSize;
+    /* sized for mostly-ASCII text - UTF-16 shrinks to a half, ISO-8859-1 keeps the size */
+    auto expectedSize = encoding == Transcoder::Encoding::ISO_8859_1 ? size : size / 2;
+    transcoded.emplace(expectedSize + expectedSize / 8);
+    Transcoder transcoder(encoding);
+    if(!transcoder.transcode(caret.getCurrData() + bomSize, size, &transcoded.value()) || !transcoder.finish()) {
+      Error error;
+      error.set(transcoder.getError().getCode(), start + bomSize + transcoder.getError().getPosition());
+      error.renderTo(errorStack, "oatpp::xml::Deserializer", caret.getData(), caret.getDataSize());
+      return;
+    }
+    caret.setPosition(caret.getDataSize());
+    transcodedCaret.emplace(reinterpret_cast<const char*>(transcoded->getData()), transcoded->getCurrentPosition());
+    input = &transcodedCaret.value();
+  }
+
+  Deserializer::State state;
+  state.caret = input;
+  state.tree = &tree;
+  state.config = &m_deserializerConfig.xml;
+  state.context = &context;
+  if(type != data::type::Tree::Class::getType()) {
+    auto& hints = m_typeHintsCache.get(type, [](const data::type::Type* t) {
+      return TypeHints(t);
+    });
+    /* hints cost a lookup per element - use them only if there is something to parse */
+    if(m_deserializerConfig.xml.parseTypedLeaves || hints.hasBinary()) {
+      state.hints = hints.getRoot();
+    }
+  }
+  Deserializer::deserialize(state);
+  if(!state.errorStack.empty()) {
+    errorStack = std::move(state.errorStack);
+  }
 
 }
 
 oatpp::Void ObjectMapper::read(utils::parser::Caret& caret, const data::type::Type* type, data::mapping::ErrorStack& errorStack) const {
 
+  /*
+   * hot inputs - parse cost drops to a hash and a compare of the bytes.
+   * Content with spilled parts is not cached - the spilled content is handed over to the caller.
+   */
+  auto cache = m_deserializerConfig.cache.get();
+  auto inputData = caret.getCurrData();
+  auto inputSize = caret.getDataSize() - caret.getPosition();
+  bool cacheable = cache != nullptr && inputSize <= cache->getMaxDocumentSize() && m_deserializerConfig.xml.spillThreshold <= 0;
+  v_uint64 inputHash = 0;
+  ParseCache::ConfigKey configKey;
+
   data::mapping::Tree tree;
+  std::shared_ptr<const Document> cached;
+  oatpp::Void cachedValue;
 
-  {
-    Deserializer::State state;
-    state.caret = &caret;
-    state.tree = &tree;
-    state.config = &m_deserializerConfig.xml;
-    Deserializer::deserialize(state);
-    if(!state.errorStack.empty()) {
-      errorStack = std::move(state.errorStack);
+  if(cacheable) {
+    inputHash = ParseCache::hash(inputData, inputSize);
+    configKey = ParseCache::getConfigKey(m_deserializerConfig.xml);
+    cached = cache->get(inputHash, inputData, inputSize, type, configKey, m_cacheToken, cachedValue);
+  }
+
+  if(cached) {
+    caret.setPosition(caret.getDataSize());
+    /* a copy of the value mapped before - no tree, no mapping */
+    oatpp::Void result;
+    if(cachedValue && cloneValue(cachedValue, result)) {
+      return result;
+    }
+    /* every caller gets its own tree - and its own value mapped from it */
+    cached->toTree(tree);
+  } else {
+    readTree(caret, type, tree, errorStack);
+    if(!errorStack.empty()) {
       return nullptr;
     }
   }
 
+  std::shared_ptr<const Document> document = cached;
+  if(cacheable && !cached) {
+    document = std::make_shared<Document>(Document::fromTree(tree));
+  }
+
   /* if expected type is Tree (root element is Tree) - then we can just move deserialized tree */
   if(type == data::type::Tree::Class::getType()) {
+    if(cacheable && !cached) {
+      cache->put(inputHash, inputData, inputSize, type, configKey, document);
+    }
     return oatpp::Tree(std::move(tree));
   }
 
-  {
-    data::mapping::TreeToObjectMapper::State state;
-    state.tree = &tree;
-    state.config = &m_deserializerConfig.mapper;
-    const auto & result = m_treeToObjectMapper.map(state, type);
-    if(!state.errorStack.empty()) {
-      errorStack = std::move(state.errorStack);
-      return nullptr;
+  data::mapping::TreeToObjectMapper::State state;
+  state.tree = &tree;
+  state.config = &m_deserializerConfig.mapper;
+  auto result = m_treeToObjectMapper.map(state, type);
+  if(!state.errorStack.empty()) {
+    if(cacheable && !cached) {
+      cache->put(inputHash, inputData, inputSize, type, configKey, document);
     }
-    return result;
+    errorStack = std::move(state.errorStack);
+    return nullptr;
   }
 
+  if(cacheable) {
+    /* values of types which can't be copied are mapped from the document on every hit */
+    oatpp::Void value;
+    if(!cloneValue(result, value)) {
+      value = nullptr;
+    }
+    if(!cached || value) {
+      cache->put(inputHash, inputData, inputSize, type, configKey, document, m_cacheToken, value);
+    }
+  }
+
+  return result;
+
 }
 
 const ObjectMapper::SerializerConfig& ObjectMapper::serializerConfig() const {
@@ -117,6 +573,8 @@ ObjectMapper::SerializerConfig& ObjectMapper::serializerConfig() {
 }
 
 ObjectMapper::DeserializerConfig& ObjectMapper::deserializerConfig() {
+  /* mapper options may change - cached values mapped with the old ones are not used anymore */
+  m_cacheToken = std::make_shared<v_uint8>(0);
   return m_deserializerConfig;
 }
 
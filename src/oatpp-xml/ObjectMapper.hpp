@@ -26,8 +26,11 @@
 #ifndef OATPP_XML_OBJECTMAPPER_HPP
 #define OATPP_XML_OBJECTMAPPER_HPP
 
+#include "./ObjectSerializer.hpp"
+#include "./ParseCache.hpp"
 #include "./Serializer.hpp"
 #include "./Deserializer.hpp"
+#include "./Types.hpp"
 
 #include "oatpp/data/mapping/ObjectToTreeMapper.hpp"
 #include "oatpp/data/mapping/TreeToObjectMapper.hpp"
@@ -47,6 +50,18 @@ public:
   public:
     data::mapping::TreeToObjectMapper::Config mapper;
     Deserializer::Config xml;
+
+    /**
+     * Cache of parse results - opt-in. `nullptr` - every input is parsed. <br>
+     * A hit skips parsing and mapping - the value mapped on the first read is kept in the cache and each caller
+     * gets a deep copy of it, so callers never share values. Values which can't be copied (enums, `Any`, `Tree` fields)
+     * and `oatpp::Tree` results are made from the cached document instead. <br>
+     * Entries are keyed by the input, the target type and the parse options of &l:ObjectMapper::DeserializerConfig::xml;,
+     * so one cache may be shared between mappers. A kept value is used only by the mapper which mapped it -
+     * until its non-const &l:ObjectMapper::deserializerConfig (); is called. Inputs are not cached when `spillThreshold` is set.
+     * See &id:oatpp::xml::ParseCache;.
+     */
+    std::shared_ptr<ParseCache> cache;
   };
 
 public:
@@ -58,19 +73,61 @@ public:
   };
 
 private:
-  void writeTree(data::stream::ConsistentOutputStream* stream, const data::mapping::Tree& tree, data::mapping::ErrorStack& errorStack) const;
+  static void mapBinaryToTree(const data::mapping::ObjectToTreeMapper* mapper, data::mapping::ObjectToTreeMapper::State& state, const oatpp::Void& polymorph);
+  static oatpp::Void mapTreeToBinary(const data::mapping::TreeToObjectMapper* mapper, data::mapping::TreeToObjectMapper::State& state, const oatpp::Type* type);
+  static oatpp::Void mapTreeToObject(const data::mapping::TreeToObjectMapper* mapper, data::mapping::TreeToObjectMapper::State& state, const oatpp::Type* type);
+  static void mapFragmentToTree(const data::mapping::ObjectToTreeMapper* mapper, data::mapping::ObjectToTreeMapper::State& state, const oatpp::Void& polymorph);
+private:
+  void writeTree(data::stream::ConsistentOutputStream* stream, WriteBuffer* buffer,
+                 const data::mapping::Tree& tree, data::mapping::ErrorStack& errorStack) const;
+  void writeValue(data::stream::ConsistentOutputStream* stream, WriteBuffer* buffer,
+                  const oatpp::Void& variant, data::mapping::ErrorStack& errorStack) const;
+  void readTree(utils::parser::Caret& caret, const data::type::Type* type,
+                data::mapping::Tree& tree, data::mapping::ErrorStack& errorStack) const;
 private:
   SerializerConfig m_serializerConfig;
   DeserializerConfig m_deserializerConfig;
+  /* owner of the values this mapper puts to the parse cache - renewed when the config may change */
+  std::shared_ptr<const void> m_cacheToken;
 private:
   data::mapping::ObjectToTreeMapper m_objectToTreeMapper;
   data::mapping::TreeToObjectMapper m_treeToObjectMapper;
+  ObjectSerializer::TagCache m_tagCache;
+  TypeCache<TypeHints> m_typeHintsCache;
 public:
 
   ObjectMapper(const SerializerConfig& serializerConfig = {}, const DeserializerConfig& deserializerConfig = {});
 
   void write(data::stream::ConsistentOutputStream* stream, const oatpp::Void& variant, data::mapping::ErrorStack& errorStack) const override;
 
+  /**
+   * Serialize value to string. <br>
+   * Hides &id:oatpp::data::mapping::ObjectMapper::writeToString; - when `Serializer::Config::twoPassThreshold` is set,
+   * output is written to a string allocated once at the exact size. See &id:oatpp::xml::Serializer::Config::twoPassThreshold;. <br>
+   * *Note: the base class method is not virtual - call it on the `oatpp::xml::ObjectMapper` to get two-pass serialization.*
+   * @param variant - value to serialize.
+   * @return - serialized value.
+   * @throws - &id:oatpp::data::mapping::MappingError; on serialization error.
+   */
+  oatpp::String writeToString(const oatpp::Void& variant) const;
+
+  /**
+   * Deserialize value. <br>
+   * Input encoding is detected by &id:oatpp::xml::Transcoder::detect;. UTF-8 input is parsed in place - the BOM is skipped.
+   * UTF-16 and ISO-8859-1 input is first transcoded into a full UTF-8 copy of the document, which is then parsed -
+   * peak memory is the input plus the copy, error positions refer to the transcoded text.
+   * The parser isn't fed incrementally: it needs the whole document as contiguous text. <br>
+   * For big streams of records, transcode piece by piece with &id:oatpp::xml::Transcoder; and split the UTF-8 output
+   * with &id:oatpp::xml::RecordSplitter; instead - then only one record is held in UTF-8 at a time. <br>
+   * Elements are matched to DTO fields with a per-type &id:oatpp::xml::NameTable; - one probe per element.
+   * Elements with attributes and DTOs with type-selected fields are mapped by &id:oatpp::data::mapping::TreeToObjectMapper;. <br>
+   * With &l:ObjectMapper::DeserializerConfig::cache; set, an input seen before isn't parsed again -
+   * the caller gets a copy of the value mapped before, or a value mapped from the cached document.
+   * @param caret - input.
+   * @param type - type of the value.
+   * @param errorStack - out errors.
+   * @return - deserialized value or `nullptr` on error.
+   */
   oatpp::Void read(oatpp::utils::parser::Caret& caret, const oatpp::Type* type, data::mapping::ErrorStack& errorStack) const override;
 
   const SerializerConfig& serializerConfig() const;
@@ -0,0 +1,258 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ObjectSerializer.hpp"
+
+namespace oatpp { namespace xml {
+
+std::vector<ObjectSerializer::Tags> ObjectSerializer::makeObjectTags(const data::type::Type* type) {
+
+  auto dispatcher = static_cast<const data::type::__class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+  const auto& fields = dispatcher->getProperties()->getList();
+
+  std::vector<Tags> tags;
+  tags.reserve(fields.size());
+  for(auto const& field : fields) {
+    tags.push_back(makeTags(field->name));
+  }
+
+  return tags;
+
+}
+
+ObjectSerializer::Tags ObjectSerializer::makeTags(const oatpp::String& name) {
+  Tags tags;
+  tags.name = name;
+  tags.open.reserve(name->size() + 2);
+  tags.open.append("<").append(*name).append(">");
+  tags.close.reserve(name->size() + 3);
+  tags.close.append("</").append(*name).append(">");
+  return tags;
+}
+
+bool ObjectSerializer::isSupported(const data::type::Type* type) {
+  auto classId = type->classId.id;
+  return classId == data::type::__class::AbstractObject::CLASS_ID.id ||
+         classId == data::type::__class::AbstractVector::CLASS_ID.id ||
+         classId == data::type::__class::AbstractList::CLASS_ID.id ||
+         classId == data::type::__class::AbstractUnorderedSet::CLASS_ID.id ||
+         classId == __class::Fragment::CLASS_ID.id;
+}
+
+bool ObjectSerializer::mapTree(State& state, const oatpp::Void& value, data::mapping::Tree& tree) {
+
+  data::mapping::ObjectToTreeMapper::State mapperState;
+  mapperState.config = state.mapperConfig;
+  mapperState.tree = &tree;
+
+  state.mapper->map(mapperState, value);
+
+  if(!mapperState.errorStack.empty()) {
+    state.xml.errorStack.splice(mapperState.errorStack);
+    state.xml.error.set(Error::Code::OBJECT_MAPPING_FAILED);
+    return false;
+  }
+
+  return true;
+
+}
+
+void ObjectSerializer::writeElement(State& state, const Tags& tags, const oatpp::Void& value) {
+
+  auto buffer = state.xml.buffer;
+
+  if(value && isSupported(value.getValueType())) {
+    buffer->write(tags.open.data(), static_cast<v_buff_size>(tags.open.size()));
+    serializeValue(state, value);
+    if(state.xml.error.isSet()) {
+      return;
+    }
+    buffer->write(tags.close.data(), static_cast<v_buff_size>(tags.close.size()));
+    return;
+  }
+
+  /* binary data is encoded straight to the output */
+  if(value && value.getValueType()->classId.id == __class::Binary::CLASS_ID.id) {
+    auto data = static_cast<const std::string*>(value.get());
+    buffer->write(tags.open.data(), static_cast<v_buff_size>(tags.open.size()));
+    buffer->writeBase64(data->data(), static_cast<v_buff_size>(data->size()));
+    buffer->write(tags.close.data(), static_cast<v_buff_size>(tags.close.size()));
+    return;
+  }
+
+  data::mapping::Tree tree;
+  if(!mapTree(state, value, tree)) {
+    return;
+  }
+
+  if(tree.isNull() && !state.xml.config->includeNullElements) {
+    return;
+  }
+
+  state.xml.tree = &tree;
+
+  if(tree.attributes().size() == 0) {
+    buffer->write(tags.open.data(), static_cast<v_buff_size>(tags.open.size()));
+  } else {
+    Serializer::startNode(tags.name, state.xml);
+  }
+
+  if(!state.xml.error.isSet()) {
+    Serializer::serializeNode(state.xml);
+  }
+
+  state.xml.tree = nullptr;
+
+  if(state.xml.error.isSet()) {
+    return;
+  }
+
+  buffer->write(tags.close.data(), static_cast<v_buff_size>(tags.close.size()));
+
+}
+
+void ObjectSerializer::serializeObject(State& state, const oatpp::Void& polymorph) {
+
+  auto type = polymorph.getValueType();
+  auto dispatcher = static_cast<const data::type::__class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+  const auto& fields = dispatcher->getProperties()->getList();
+  const auto& tags = state.tagCache->get(type, &makeObjectTags);
+
+  auto object = static_cast<oatpp::BaseObject*>(polymorph.get());
+
+  v_buff_size index = 0;
+  for(auto const& field : fields) {
+
+    auto value = field->get(object);
+
+    if(value || state.mapperConfig->includeNullFields || (field->info.required && state.mapperConfig->alwaysIncludeRequired)) {
+      const auto& fieldTags = tags[static_cast<size_t>(index)];
+      writeElement(state, fieldTags, value);
+      if(state.xml.error.isSet()) {
+        state.xml.error.pushElement(fieldTags.name);
+        return;
+      }
+    }
+
+    index ++;
+
+  }
+
+}
+
+void ObjectSerializer::serializeCollection(State& state, const oatpp::Void& polymorph) {
+
+  static const Tags itemTags = makeTags("item");
+
+  auto dispatcher = static_cast<const data::type::__class::Collection::PolymorphicDispatcher*>(polymorph.getValueType()->polymorphicDispatcher);
+
+  v_int64 index = 0;
+  auto iterator = dispatcher->beginIteration(polymorph);
+
+  while (!iterator->finished()) {
+
+    writeElement(state, itemTags, iterator->get());
+    if(state.xml.error.isSet()) {
+      state.xml.error.pushIndex(index);
+      state.xml.error.pushElement(itemTags.name);
+      return;
+    }
+
+    iterator->next();
+    index ++;
+
+  }
+
+}
+
+void ObjectSerializer::serializeFragment(State& state, const oatpp::Void& polymorph) {
+
+  auto fragment = static_cast<const FragmentData*>(polymorph.get());
+
+  /* mapper options change DTO output too */
+  auto outputKey = Serializer::getOutputKey(*state.xml.config);
+  outputKey.includeNullFields = state.mapperConfig->includeNullFields;
+  outputKey.alwaysIncludeRequired = state.mapperConfig->alwaysIncludeRequired;
+
+  Serializer::writeFragment(state.xml, fragment->id, fragment->version, outputKey, [&state, fragment]() {
+    serializeValue(state, fragment->value);
+  });
+
+}
+
+void ObjectSerializer::serializeValue(State& state, const oatpp::Void& polymorph) {
+
+  if(polymorph && polymorph.getValueType()->classId.id == __class::Fragment::CLASS_ID.id) {
+    serializeFragment(state, polymorph);
+    return;
+  }
+
+  if(polymorph && polymorph.getValueType()->classId.id == data::type::__class::AbstractObject::CLASS_ID.id) {
+    serializeObject(state, polymorph);
+    return;
+  }
+
+  if(polymorph && isSupported(polymorph.getValueType())) {
+    serializeCollection(state, polymorph);
+    return;
+  }
+
+  data::mapping::Tree tree;
+  if(!mapTree(state, polymorph, tree)) {
+    return;
+  }
+
+  state.xml.tree = &tree;
+  Serializer::serializeNode(state.xml);
+  state.xml.tree = nullptr;
+
+}
+
+void ObjectSerializer::serialize(State& state, const oatpp::Void& polymorph) {
+
+  if(state.xml.buffer) {
+    serializeValue(state, polymorph);
+  } else {
+
+    Serializer::Context localContext;
+    auto context = state.xml.context ? state.xml.context : &localContext;
+
+    auto bufferSize = state.xml.config->writeBufferSize;
+    WriteBuffer buffer(state.xml.stream, context->getBuffer(bufferSize), bufferSize);
+    state.xml.buffer = &buffer;
+
+    serializeValue(state, polymorph);
+
+    buffer.flush();
+    state.xml.buffer = nullptr;
+
+  }
+
+  if(state.xml.error.isSet()) {
+    state.xml.error.renderTo(state.xml.errorStack, "oatpp::xml::Serializer");
+  }
+
+}
+
+}}
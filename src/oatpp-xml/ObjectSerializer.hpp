@@ -0,0 +1,104 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_OBJECTSERIALIZER_HPP
+#define OATPP_XML_OBJECTSERIALIZER_HPP
+
+#include "./Serializer.hpp"
+#include "./TypeCache.hpp"
+#include "./Types.hpp"
+
+#include "oatpp/data/mapping/ObjectToTreeMapper.hpp"
+
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * DTO to XML serializer. <br>
+ * Writes DTO objects and collections straight to the output without building an intermediate &id:oatpp::data::mapping::Tree;.
+ * Open and close tags of object fields are rendered once per DTO type and kept in the &l:ObjectSerializer::TagCache;. <br>
+ * All other values are mapped with &id:oatpp::data::mapping::ObjectToTreeMapper; and written by &id:oatpp::xml::Serializer;,
+ * so the output is the same as if the whole object was mapped to a tree first. <br>
+ * &id:oatpp::xml::Fragment; values are written from the &id:oatpp::xml::Serializer::Config::fragmentCache; when they are cached.
+ */
+class ObjectSerializer {
+public:
+
+  /**
+   * Pre-rendered element tags.
+   */
+  struct Tags {
+    oatpp::String name;
+    std::string open;
+    std::string close;
+  };
+
+  /**
+   * Pre-rendered field tags per DTO type - in the order of the type properties list.
+   */
+  typedef TypeCache<std::vector<Tags>> TagCache;
+
+public:
+
+  /**
+   * Serializer state.
+   */
+  struct State {
+    const data::mapping::ObjectToTreeMapper* mapper;
+    const data::mapping::ObjectToTreeMapper::Config* mapperConfig;
+    const TagCache* tagCache;
+    Serializer::State xml;
+  };
+
+private:
+  static Tags makeTags(const oatpp::String& name);
+  static std::vector<Tags> makeObjectTags(const data::type::Type* type);
+  static bool mapTree(State& state, const oatpp::Void& value, data::mapping::Tree& tree);
+  static void writeElement(State& state, const Tags& tags, const oatpp::Void& value);
+  static void serializeObject(State& state, const oatpp::Void& polymorph);
+  static void serializeCollection(State& state, const oatpp::Void& polymorph);
+  static void serializeFragment(State& state, const oatpp::Void& polymorph);
+  static void serializeValue(State& state, const oatpp::Void& polymorph);
+public:
+
+  /**
+   * Check if values of the type are written by the object serializer - DTO objects, vectors, lists, sets and fragments.
+   * @param type
+   * @return
+   */
+  static bool isSupported(const data::type::Type* type);
+
+  /**
+   * Serialize value.
+   * @param state
+   * @param polymorph
+   */
+  static void serialize(State& state, const oatpp::Void& polymorph);
+
+};
+
+}}
+
+#endif //OATPP_XML_OBJECTSERIALIZER_HPP
@@ -0,0 +1,281 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ParseCache.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+constexpr v_uint64 PRIME_1 = 0x9E3779B185EBCA87ull;
+constexpr v_uint64 PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr v_uint64 PRIME_3 = 0x165667B19E3779F9ull;
+
+v_uint64 rotl(v_uint64 value, v_int32 bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+v_uint64 read64(const char* data) {
+  v_uint64 value;
+  std::memcpy(&value, data, 8);
+  return value;
+}
+
+v_uint64 mixLane(v_uint64 lane, v_uint64 word) {
+  return rotl(lane + word * PRIME_2, 31) * PRIME_1;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ParseCache::ConfigKey
+
+bool ParseCache::ConfigKey::operator==(const ConfigKey& other) const {
+  return maxDepth == other.maxDepth &&
+         maxNodes == other.maxNodes &&
+         maxAttributes == other.maxAttributes &&
+         maxNameLength == other.maxNameLength &&
+         maxTextSize == other.maxTextSize &&
+         maxDocumentSize == other.maxDocumentSize &&
+         namespaceMode == other.namespaceMode &&
+         parseTypedLeaves == other.parseTypedLeaves &&
+         validateUtf8 == other.validateUtf8 &&
+         skipComments == other.skipComments &&
+         skipPIs == other.skipPIs &&
+         mergeCData == other.mergeCData;
+}
+
+bool ParseCache::ConfigKey::operator!=(const ConfigKey& other) const {
+  return !operator==(other);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ParseCache
+
+ParseCache::ParseCache(v_uint64 maxEntries, v_buff_size maxDocumentSize, v_uint32 shardsCount)
+  : m_shards(shardsCount > 0 ? shardsCount : 1)
+  , m_maxDocumentSize(maxDocumentSize)
+  , m_hits(0)
+  , m_misses(0)
+  , m_evictions(0)
+  , m_entries(0)
+{
+  m_shardCapacity = (maxEntries + m_shards.size() - 1) / m_shards.size();
+  if(m_shardCapacity == 0) {
+    m_shardCapacity = 1;
+  }
+}
+
+v_uint64 ParseCache::hash(const char* data, v_buff_size size) {
+
+  auto p = data;
+  auto end = data + size;
+  v_uint64 result;
+
+  if(size >= 32) {
+    /* independent lanes - multiplications of different lanes overlap */
+    v_uint64 a = PRIME_1 + PRIME_2;
+    v_uint64 b = PRIME_2;
+    v_uint64 c = 0;
+    v_uint64 d = 0 - PRIME_1;
+    while(end - p >= 32) {
+      a = mixLane(a, read64(p));
+      b = mixLane(b, read64(p + 8));
+      c = mixLane(c, read64(p + 16));
+      d = mixLane(d, read64(p + 24));
+      p += 32;
+    }
+    result = rotl(a, 1) + rotl(b, 7) + rotl(c, 12) + rotl(d, 18);
+    for(auto lane : {a, b, c, d}) {
+      result = (result ^ mixLane(0, lane)) * PRIME_1 + PRIME_3;
+    }
+  } else {
+    result = PRIME_3;
+  }
+
+  result += static_cast<v_uint64>(size);
+
+  while(end - p >= 8) {
+    result = rotl(result ^ mixLane(0, read64(p)), 27) * PRIME_1 + PRIME_3;
+    p += 8;
+  }
+  while(p < end) {
+    result = rotl(result ^ (static_cast<v_uint8>(*p) * PRIME_3), 11) * PRIME_1;
+    p ++;
+  }
+
+  /* avalanche */
+  result ^= result >> 33;
+  result *= PRIME_2;
+  result ^= result >> 29;
+  result *= PRIME_3;
+  result ^= result >> 32;
+
+  return result;
+
+}
+
+ParseCache::ConfigKey ParseCache::getConfigKey(const Deserializer::Config& config) {
+  ConfigKey key;
+  key.maxDepth = config.maxDepth;
+  key.maxNodes = config.maxNodes;
+  key.maxAttributes = config.maxAttributes;
+  key.maxNameLength = config.maxNameLength;
+  key.maxTextSize = config.maxTextSize;
+  key.maxDocumentSize = config.maxDocumentSize;
+  key.namespaceMode = config.namespaceMode;
+  key.parseTypedLeaves = config.parseTypedLeaves;
+  key.validateUtf8 = config.validateUtf8;
+  key.skipComments = config.skipComments;
+  key.skipPIs = config.skipPIs;
+  key.mergeCData = config.mergeCData;
+  return key;
+}
+
+v_uint64 ParseCache::getKey(v_uint64 hash, const data::type::Type* type, const ConfigKey& config) {
+  v_uint64 options = PRIME_3;
+  for(auto value : {config.maxDepth, config.maxNodes, config.maxAttributes, config.maxNameLength, config.maxTextSize,
+                    config.maxDocumentSize, static_cast<v_buff_size>(config.namespaceMode)})
+  {
+    options = mixLane(options, static_cast<v_uint64>(value));
+  }
+  for(auto flag : {config.parseTypedLeaves, config.validateUtf8, config.skipComments, config.skipPIs, config.mergeCData}) {
+    options = (options << 1) | static_cast<v_uint64>(flag);
+  }
+  return hash ^ (static_cast<v_uint64>(reinterpret_cast<std::uintptr_t>(type)) * PRIME_1) ^ mixLane(0, options);
+}
+
+ParseCache::Shard& ParseCache::getShard(v_uint64 key) {
+  /* high bits - the shard map uses the low ones */
+  return m_shards[(key >> 40) % m_shards.size()];
+}
+
+std::shared_ptr<const Document> ParseCache::get(v_uint64 hash, const char* data, v_buff_size size,
+                                                const data::type::Type* type, const ConfigKey& config)
+{
+  oatpp::Void value;
+  return get(hash, data, size, type, config, nullptr, value);
+}
+
+std::shared_ptr<const Document> ParseCache::get(v_uint64 hash, const char* data, v_buff_size size,
+                                                const data::type::Type* type, const ConfigKey& config,
+                                                const std::shared_ptr<const void>& valueOwner, oatpp::Void& value)
+{
+
+  auto key = getKey(hash, type, config);
+  auto& shard = getShard(key);
+
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if(it != shard.index.end()) {
+      auto& entry = *it->second;
+      if(entry.type == type && entry.config == config && static_cast<v_buff_size>(entry.content->size()) == size &&
+         std::memcmp(entry.content->data(), data, static_cast<size_t>(size)) == 0)
+      {
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        /* same owner object - an expired owner never matches a live one */
+        if(valueOwner && entry.value && !entry.valueOwner.owner_before(valueOwner) && !valueOwner.owner_before(entry.valueOwner)) {
+          value = entry.value;
+        }
+        return entry.document;
+      }
+    }
+  }
+
+  m_misses.fetch_add(1, std::memory_order_relaxed);
+  return nullptr;
+
+}
+
+void ParseCache::put(v_uint64 hash, const char* data, v_buff_size size,
+                     const data::type::Type* type, const ConfigKey& config, const std::shared_ptr<const Document>& document,
+                     const std::shared_ptr<const void>& valueOwner, const oatpp::Void& value)
+{
+
+  if(size > m_maxDocumentSize) {
+    return;
+  }
+
+  auto key = getKey(hash, type, config);
+  auto& shard = getShard(key);
+
+  /* copy is made outside of the lock */
+  oatpp::String content(data, size);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto it = shard.index.find(key);
+  if(it != shard.index.end()) {
+    auto& entry = *it->second;
+    entry.type = type;
+    entry.config = config;
+    entry.content = content;
+    entry.document = document;
+    entry.value = value;
+    entry.valueOwner = valueOwner;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return;
+  }
+
+  if(shard.entries.size() >= m_shardCapacity) {
+    shard.index.erase(shard.entries.back().key);
+    shard.entries.pop_back();
+    m_evictions.fetch_add(1, std::memory_order_relaxed);
+    m_entries.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  shard.entries.push_front(Entry{key, type, config, content, document, value, valueOwner});
+  shard.index[key] = shard.entries.begin();
+  m_entries.fetch_add(1, std::memory_order_relaxed);
+
+}
+
+void ParseCache::clear() {
+  for(auto& shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    m_entries.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+    shard.index.clear();
+    shard.entries.clear();
+  }
+}
+
+ParseCache::Stats ParseCache::getStats() const {
+  return Stats{
+    m_hits.load(std::memory_order_relaxed),
+    m_misses.load(std::memory_order_relaxed),
+    m_evictions.load(std::memory_order_relaxed),
+    m_entries.load(std::memory_order_relaxed)
+  };
+}
+
+v_buff_size ParseCache::getMaxDocumentSize() const {
+  return m_maxDocumentSize;
+}
+
+}}
@@ -0,0 +1,234 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_PARSECACHE_HPP
+#define OATPP_XML_PARSECACHE_HPP
+
+#include "./Deserializer.hpp"
+#include "./Document.hpp"
+
+#include "oatpp/Types.hpp"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Cache of parse results for inputs which are parsed again and again, ex.: configs, feature flags, WSDL fragments. <br>
+ * Parsed trees are kept as &id:oatpp::xml::Document;s - compact and immutable, each reader makes its own tree of it. <br>
+ * An entry may also keep the value mapped from its document, for the mapper which mapped it - see `valueOwner`.
+ * The value is shared by all readers - the mapper hands out copies of it. <br>
+ * Entries are keyed by a 64-bit hash of the input bytes, the target type and the &l:ParseCache::ConfigKey;.
+ * On a hash match the input and the config are compared with the cached ones,
+ * so a lookup costs a hash and a `memcmp` of the input. <br>
+ * The cache is split into shards, each with its own lock and LRU list - readers of different inputs don't contend.
+ * Each shard keeps at most `maxEntries / shardsCount` entries, the least recently used entry is evicted first. <br>
+ * See &id:oatpp::xml::ObjectMapper::DeserializerConfig::cache;.
+ */
+class ParseCache {
+public:
+
+  /**
+   * Cache counters.
+   */
+  struct Stats {
+
+    /**
+     * Count of lookups which returned a cached value.
+     */
+    v_uint64 hits;
+
+    /**
+     * Count of lookups which found nothing.
+     */
+    v_uint64 misses;
+
+    /**
+     * Count of entries evicted to free space.
+     */
+    v_uint64 evictions;
+
+    /**
+     * Current count of entries.
+     */
+    v_uint64 entries;
+
+  };
+
+  /**
+   * Options of &id:oatpp::xml::Deserializer::Config; which change the parse result.
+   * Limits are included - input which fits looser limits may fail stricter ones.
+   */
+  struct ConfigKey {
+
+    v_buff_size maxDepth = 0;
+    v_buff_size maxNodes = 0;
+    v_buff_size maxAttributes = 0;
+    v_buff_size maxNameLength = 0;
+    v_buff_size maxTextSize = 0;
+    v_buff_size maxDocumentSize = 0;
+    Deserializer::NamespaceMode namespaceMode = Deserializer::NamespaceMode::NONE;
+    bool parseTypedLeaves = false;
+    bool validateUtf8 = false;
+    bool skipComments = false;
+    bool skipPIs = false;
+    bool mergeCData = false;
+
+    bool operator==(const ConfigKey& other) const;
+    bool operator!=(const ConfigKey& other) const;
+
+  };
+
+private:
+
+  struct Entry {
+    v_uint64 key;
+    const data::type::Type* type;
+    ConfigKey config;
+    oatpp::String content;
+    std::shared_ptr<const Document> document;
+    oatpp::Void value;
+    std::weak_ptr<const void> valueOwner;
+  };
+
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<v_uint64, std::list<Entry>::iterator> index;
+  };
+
+private:
+  static v_uint64 getKey(v_uint64 hash, const data::type::Type* type, const ConfigKey& config);
+private:
+  Shard& getShard(v_uint64 key);
+private:
+  std::vector<Shard> m_shards;
+  v_uint64 m_shardCapacity;
+  v_buff_size m_maxDocumentSize;
+  std::atomic<v_uint64> m_hits;
+  std::atomic<v_uint64> m_misses;
+  std::atomic<v_uint64> m_evictions;
+  std::atomic<v_uint64> m_entries;
+public:
+
+  /**
+   * Constructor.
+   * @param maxEntries - max count of cached documents.
+   * @param maxDocumentSize - max size of a document to cache. Bigger documents are parsed every time.
+   * @param shardsCount - count of independently locked shards.
+   */
+  ParseCache(v_uint64 maxEntries = 1024, v_buff_size maxDocumentSize = 1024 * 1024, v_uint32 shardsCount = 16);
+
+  /**
+   * Non-copyable.
+   */
+  ParseCache(const ParseCache&) = delete;
+  ParseCache& operator=(const ParseCache&) = delete;
+
+  /**
+   * Hash of the input. Processes 32 bytes per iteration in four independent lanes.
+   * @param data - input.
+   * @param size - input size.
+   * @return - 64-bit hash.
+   */
+  static v_uint64 hash(const char* data, v_buff_size size);
+
+  /**
+   * Get the parse options of the config which are part of the cache key.
+   * @param config - &id:oatpp::xml::Deserializer::Config;.
+   * @return - &l:ParseCache::ConfigKey;.
+   */
+  static ConfigKey getConfigKey(const Deserializer::Config& config);
+
+  /**
+   * Get cached document. Counts a hit or a miss.
+   * @param hash - hash of the input - see &l:ParseCache::hash ();.
+   * @param data - input.
+   * @param size - input size.
+   * @param type - type of the value the input was parsed for.
+   * @param config - parse options - see &l:ParseCache::getConfigKey ();.
+   * @return - cached document or `nullptr` if there is none.
+   */
+  std::shared_ptr<const Document> get(v_uint64 hash, const char* data, v_buff_size size,
+                                      const data::type::Type* type, const ConfigKey& config);
+
+  /**
+   * Get cached document and the value mapped from it. Counts a hit or a miss.
+   * @param hash - hash of the input - see &l:ParseCache::hash ();.
+   * @param data - input.
+   * @param size - input size.
+   * @param type - type of the value the input was parsed for.
+   * @param config - parse options - see &l:ParseCache::getConfigKey ();.
+   * @param valueOwner - owner of the mapped value - see &l:ParseCache::put ();.
+   * @param value - out value put by the same `valueOwner`. Left as is if there is none.
+   * @return - cached document or `nullptr` if there is none.
+   */
+  std::shared_ptr<const Document> get(v_uint64 hash, const char* data, v_buff_size size,
+                                      const data::type::Type* type, const ConfigKey& config,
+                                      const std::shared_ptr<const void>& valueOwner, oatpp::Void& value);
+
+  /**
+   * Put document to the cache. Replaces the previous document for the same input, type and config.
+   * Inputs bigger than `maxDocumentSize` are not cached.
+   * @param hash - hash of the input - see &l:ParseCache::hash ();.
+   * @param data - input.
+   * @param size - input size.
+   * @param type - type of the value the input was parsed for.
+   * @param config - parse options - see &l:ParseCache::getConfigKey ();.
+   * @param document - parsed document.
+   * @param valueOwner - owner of the value, ex.: a token of the mapper and its options.
+   * The value is returned only to the same owner and is dropped with it.
+   * @param value - value mapped from the document. Must not be changed after it is put.
+   */
+  void put(v_uint64 hash, const char* data, v_buff_size size,
+           const data::type::Type* type, const ConfigKey& config, const std::shared_ptr<const Document>& document,
+           const std::shared_ptr<const void>& valueOwner = nullptr, const oatpp::Void& value = nullptr);
+
+  /**
+   * Remove all entries. Counters are kept.
+   */
+  void clear();
+
+  /**
+   * Get counters.
+   * @return - &l:ParseCache::Stats;.
+   */
+  Stats getStats() const;
+
+  /**
+   * Max size of a document to cache.
+   * @return
+   */
+  v_buff_size getMaxDocumentSize() const;
+
+};
+
+}}
+
+#endif /* OATPP_XML_PARSECACHE_HPP */
@@ -0,0 +1,165 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ParserPool.hpp"
+
+namespace oatpp { namespace xml {
+
+ParserPool::ParserPool(const std::shared_ptr<ObjectMapper>& mapper,
+                       const data::type::Type* type,
+                       v_int32 threadsCount,
+                       v_buff_size capacity,
+                       bool ordered)
+  : m_mapper(mapper)
+  , m_type(type)
+  , m_capacity(capacity > 0 ? capacity : 1)
+  , m_ordered(ordered)
+  , m_submitted(0)
+  , m_taken(0)
+  , m_closed(false)
+{
+  if(threadsCount < 1) {
+    threadsCount = 1;
+  }
+  m_threads.reserve(static_cast<size_t>(threadsCount));
+  for(v_int32 i = 0; i < threadsCount; i ++) {
+    m_threads.emplace_back(&ParserPool::run, this);
+  }
+}
+
+ParserPool::~ParserPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_records.clear();
+    m_closed = true;
+  }
+  m_workCondition.notify_all();
+  m_submitCondition.notify_all();
+  m_resultCondition.notify_all();
+  for(auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void ParserPool::run() {
+
+  while(true) {
+
+    std::pair<v_int64, oatpp::String> record;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_workCondition.wait(lock, [this] { return !m_records.empty() || m_closed; });
+      if(m_records.empty()) {
+        return;
+      }
+      record = std::move(m_records.front());
+      m_records.pop_front();
+    }
+
+    Result result;
+    result.index = record.first;
+
+    try {
+      utils::parser::Caret caret(record.second);
+      data::mapping::ErrorStack errorStack;
+      result.value = m_mapper->read(caret, m_type, errorStack);
+      if(!errorStack.empty()) {
+        result.value = nullptr;
+        result.error = errorStack.stacktrace();
+      }
+    } catch (std::exception& e) {
+      result.value = nullptr;
+      result.error = e.what();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_results.emplace(result.index, std::move(result));
+    }
+    m_resultCondition.notify_all();
+
+  }
+
+}
+
+bool ParserPool::isResultReady() const {
+  if(m_results.empty()) {
+    return false;
+  }
+  /* results are keyed by index - in ordered mode only the next index can go */
+  return !m_ordered || m_results.begin()->first == m_taken;
+}
+
+v_int64 ParserPool::submit(const oatpp::String& record) {
+
+  v_int64 index;
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_submitCondition.wait(lock, [this] { return m_submitted - m_taken < m_capacity || m_closed; });
+    if(m_closed) {
+      return -1;
+    }
+    index = m_submitted ++;
+    m_records.emplace_back(index, record);
+  }
+
+  m_workCondition.notify_one();
+  return index;
+
+}
+
+bool ParserPool::take(Result& result) {
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_resultCondition.wait(lock, [this] {
+      return isResultReady() || (m_closed && m_taken == m_submitted);
+    });
+    if(!isResultReady()) {
+      return false;
+    }
+    auto it = m_results.begin();
+    result = std::move(it->second);
+    m_results.erase(it);
+    m_taken ++;
+  }
+
+  m_submitCondition.notify_one();
+  return true;
+
+}
+
+void ParserPool::close() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+  }
+  m_workCondition.notify_all();
+  m_submitCondition.notify_all();
+  m_resultCondition.notify_all();
+}
+
+}}
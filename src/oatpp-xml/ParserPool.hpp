@@ -0,0 +1,139 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_PARSERPOOL_HPP
+#define OATPP_XML_PARSERPOOL_HPP
+
+#include "./ObjectMapper.hpp"
+
+#include "oatpp/Types.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Pool of threads parsing independent records - ex.: documents found by &id:oatpp::xml::RecordSplitter;. <br>
+ * Records are parsed with &id:oatpp::xml::ObjectMapper::read;, each thread keeps its own parser context. <br>
+ * Backpressure - at most `capacity` records are in flight (submitted, but not taken yet),
+ * &l:ParserPool::submit (); blocks until a result is taken. <br>
+ * Results are delivered in submit order or as soon as they are ready.
+ */
+class ParserPool {
+public:
+
+  /**
+   * Result of parsing a record.
+   */
+  struct Result {
+
+    /**
+     * Index of the record - 0-based, in submit order.
+     */
+    v_int64 index;
+
+    /**
+     * Parsed value. `nullptr` if parsing failed.
+     */
+    oatpp::Void value;
+
+    /**
+     * Error message. `nullptr` if parsing succeeded.
+     */
+    oatpp::String error;
+
+  };
+
+private:
+  std::shared_ptr<ObjectMapper> m_mapper;
+  const data::type::Type* m_type;
+  v_buff_size m_capacity;
+  bool m_ordered;
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_submitCondition;
+  std::condition_variable m_workCondition;
+  std::condition_variable m_resultCondition;
+  std::deque<std::pair<v_int64, oatpp::String>> m_records;
+  std::map<v_int64, Result> m_results;
+  v_int64 m_submitted;
+  v_int64 m_taken;
+  bool m_closed;
+  std::vector<std::thread> m_threads;
+private:
+  void run();
+  bool isResultReady() const;
+public:
+
+  /**
+   * Constructor.
+   * @param mapper - &id:oatpp::xml::ObjectMapper;.
+   * @param type - type to parse records to. Ex.: `oatpp::Object<MyDto>::Class::getType()`. `oatpp::Tree` - keep the tree.
+   * @param threadsCount - count of parser threads.
+   * @param capacity - max count of records in flight.
+   * @param ordered - deliver results in submit order.
+   */
+  ParserPool(const std::shared_ptr<ObjectMapper>& mapper,
+             const data::type::Type* type,
+             v_int32 threadsCount,
+             v_buff_size capacity,
+             bool ordered = true);
+
+  ParserPool(const ParserPool&) = delete;
+  ParserPool& operator=(const ParserPool&) = delete;
+
+  /**
+   * Destructor. Records which are not parsed yet are dropped.
+   */
+  ~ParserPool();
+
+  /**
+   * Submit record for parsing. Blocks while `capacity` records are in flight.
+   * @param record - XML document.
+   * @return - index of the record. `-1` if the pool is closed.
+   */
+  v_int64 submit(const oatpp::String& record);
+
+  /**
+   * Take the next result. Blocks until a result is ready.
+   * @param result - out result.
+   * @return - `false` if the pool is closed and all results are taken.
+   */
+  bool take(Result& result);
+
+  /**
+   * Close the pool - no more records are accepted. Submitted records are parsed and can be taken.
+   */
+  void close();
+
+};
+
+}}
+
+#endif //OATPP_XML_PARSERPOOL_HPP
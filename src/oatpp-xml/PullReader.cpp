@@ -0,0 +1,424 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "PullReader.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <cstring>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+bool isBlankChar(char c) {
+  return c == ' ' || c == '\r' || c == '\n' || c == '\t' || c == '\f';
+}
+
+}
+
+PullReader::PullReader(const oatpp::String& text, const Deserializer::Config& config)
+  : m_caret(text)
+  , m_config(config)
+{
+  init();
+}
+
+PullReader::PullReader(const char* data, v_buff_size size, const Deserializer::Config& config)
+  : m_caret(data, size)
+  , m_config(config)
+{
+  init();
+}
+
+void PullReader::init() {
+
+  m_state.config = &m_config;
+  m_state.caret = &m_caret;
+  m_state.tree = nullptr;
+
+  m_token = Token::END_DOCUMENT;
+  m_emptyElement = false;
+  m_pendingEnd = false;
+
+  auto maxSize = m_config.maxDocumentSize;
+  if(maxSize > 0 && m_caret.getDataSize() > maxSize) {
+    m_state.error.set(Error::Code::DOCUMENT_SIZE_LIMIT_EXCEEDED, maxSize);
+    m_token = Token::FAILURE;
+  }
+
+}
+
+PullReader::Token PullReader::fail() {
+  for(auto it = m_elements.rbegin(); it != m_elements.rend(); it ++) {
+    m_state.error.pushElement(it->toString());
+  }
+  m_token = Token::FAILURE;
+  return m_token;
+}
+
+PullReader::Token PullReader::readMarkup() {
+
+  auto start = m_caret.getPosition();
+
+  if(m_caret.isAtText("</", 2, true)) {
+    return readEndElement();
+  }
+
+  if(!Deserializer::countNode(m_state)) {
+    return fail();
+  }
+
+  if(m_caret.isAtText("<?", 2, true)) {
+
+    auto name = m_caret.getCurrData();
+    auto nameSize = Deserializer::scanName(m_state, false);
+    if(nameSize == 0) {
+      return fail();
+    }
+    m_name = data::share::StringKeyLabel(nullptr, name, nameSize);
+
+    m_caret.skipBlankChars();
+    auto label = m_caret.putLabel();
+    if(!Deserializer::findTerminator(m_state, "?>", 2)) {
+      m_state.error.set(Error::Code::UNTERMINATED_PI, start);
+      m_state.error.pushElement("?" + m_name.toString());
+      return fail();
+    }
+    if(!Deserializer::checkText(m_state, m_caret.getData() + label.getStartPosition(), label.getSize(), start)) {
+      return fail();
+    }
+    m_text = data::share::StringKeyLabel(nullptr, m_caret.getData() + label.getStartPosition(), label.getSize());
+    m_caret.inc(2);
+    m_token = Token::PI;
+    return m_token;
+
+  }
+
+  const char* terminator;
+  Error::Code errorCode;
+
+  if(m_caret.isAtText("<!--", 4, true)) {
+    terminator = "-->";
+    errorCode = Error::Code::UNTERMINATED_COMMENT;
+    m_token = Token::COMMENT;
+  } else if(m_caret.isAtText("<![CDATA[", 9, true)) {
+    terminator = "]]>";
+    errorCode = Error::Code::UNTERMINATED_CDATA;
+    m_token = Token::CDATA;
+  } else {
+    return readStartElement();
+  }
+
+  auto label = m_caret.putLabel();
+  if(!Deserializer::findTerminator(m_state, terminator, 3)) {
+    m_state.error.set(errorCode, start);
+    return fail();
+  }
+  if(!Deserializer::checkText(m_state, m_caret.getData() + label.getStartPosition(), label.getSize(), start)) {
+    return fail();
+  }
+  m_text = data::share::StringKeyLabel(nullptr, m_caret.getData() + label.getStartPosition(), label.getSize());
+  m_caret.inc(3);
+  return m_token;
+
+}
+
+PullReader::Token PullReader::readStartElement() {
+
+  m_caret.inc(1);
+
+  auto maxDepth = m_config.maxDepth;
+  if(maxDepth > 0 && static_cast<v_buff_size>(m_elements.size()) >= maxDepth) {
+    m_state.error.set(Error::Code::DEPTH_LIMIT_EXCEEDED, m_caret.getPosition() - 1);
+    return fail();
+  }
+
+  auto name = m_caret.getCurrData();
+  auto nameSize = Deserializer::scanName(m_state, false);
+  if(nameSize == 0) {
+    return fail();
+  }
+  m_name = data::share::StringKeyLabel(nullptr, name, nameSize);
+
+  while(true) {
+
+    m_caret.skipBlankChars();
+    if(!m_caret.canContinue() || m_caret.isAtChar('/') || m_caret.isAtChar('>')) {
+      break;
+    }
+
+    auto maxAttributes = m_config.maxAttributes;
+    if(maxAttributes > 0 && static_cast<v_buff_size>(m_attributes.size()) >= maxAttributes) {
+      m_state.error.set(Error::Code::ATTRIBUTES_LIMIT_EXCEEDED, m_caret.getPosition());
+      m_state.error.pushElement(m_name.toString());
+      return fail();
+    }
+
+    auto key = m_caret.getCurrData();
+    auto keySize = Deserializer::scanName(m_state, true);
+    if(keySize == 0) {
+      m_state.error.pushElement(m_name.toString());
+      return fail();
+    }
+
+    m_caret.skipBlankChars();
+    if(!m_caret.canContinueAtChar('=', 1)) {
+      m_state.error.set(Error::Code::ATTRIBUTE_EQUALS_EXPECTED, m_caret.getPosition());
+      m_state.error.pushAttribute(oatpp::String(key, keySize));
+      m_state.error.pushElement(m_name.toString());
+      return fail();
+    }
+
+    m_caret.skipBlankChars();
+    const char* value;
+    v_buff_size valueSize;
+    if(!Deserializer::scanAttributeValue(m_state, value, valueSize)) {
+      m_state.error.pushAttribute(oatpp::String(key, keySize));
+      m_state.error.pushElement(m_name.toString());
+      return fail();
+    }
+
+    m_attributes.push_back({data::share::StringKeyLabel(nullptr, key, keySize),
+                            data::share::StringKeyLabel(nullptr, value, valueSize)});
+
+  }
+
+  if(m_caret.isAtChar('/')) {
+    if(!(m_caret.canContinueAtChar('/', 1) && m_caret.canContinueAtChar('>', 1))) {
+      m_state.error.set(Error::Code::EMPTY_ELEMENT_END_EXPECTED, m_caret.getPosition());
+      m_state.error.pushElement(m_name.toString());
+      return fail();
+    }
+    m_emptyElement = true;
+    m_pendingEnd = true;
+  } else if(!m_caret.canContinueAtChar('>', 1)) {
+    m_state.error.set(Error::Code::ELEMENT_END_EXPECTED, m_caret.getPosition());
+    m_state.error.pushElement(m_name.toString());
+    return fail();
+  }
+
+  m_elements.push_back(m_name);
+  m_token = Token::START_ELEMENT;
+  return m_token;
+
+}
+
+PullReader::Token PullReader::readEndElement() {
+
+  auto start = m_caret.getPosition() - 2;
+
+  if(m_elements.empty()) {
+    m_state.error.set(Error::Code::INVALID_CLOSING_TAG, start);
+    return fail();
+  }
+
+  auto& name = m_elements.back();
+  if(!m_caret.isAtText(static_cast<const char*>(name.getData()), name.getSize(), true)) {
+    m_state.error.set(Error::Code::INVALID_CLOSING_TAG, start);
+    return fail();
+  }
+
+  m_caret.skipBlankChars();
+  if(!m_caret.canContinueAtChar('>', 1)) {
+    m_state.error.set(Error::Code::CLOSING_TAG_END_EXPECTED, m_caret.getPosition());
+    return fail();
+  }
+
+  m_name = name;
+  m_token = Token::END_ELEMENT;
+  return m_token;
+
+}
+
+PullReader::Token PullReader::readText() {
+
+  auto data = m_caret.getData();
+  auto size = m_caret.getDataSize();
+  auto start = m_caret.getPosition();
+
+  auto found = static_cast<const char*>(std::memchr(data + start, '<', static_cast<size_t>(size - start)));
+  auto end = found == nullptr ? size : static_cast<v_buff_size>(found - data);
+
+  m_caret.setPosition(end);
+
+  v_buff_size i = start;
+  while(i < end && isBlankChar(data[i])) {
+    i ++;
+  }
+
+  /* blank text between elements is skipped - same as in the tree */
+  if(i == end) {
+    return Token::END_DOCUMENT;
+  }
+
+  if(m_elements.empty()) {
+    m_state.error.set(Error::Code::ELEMENT_START_EXPECTED, i);
+    return fail();
+  }
+
+  if(!Deserializer::checkText(m_state, data + start, end - start, start) || !Deserializer::countNode(m_state)) {
+    return fail();
+  }
+
+  m_text = data::share::StringKeyLabel(nullptr, data + start, end - start);
+  m_token = Token::TEXT;
+  return m_token;
+
+}
+
+PullReader::Token PullReader::next() {
+
+  if(m_token == Token::FAILURE) {
+    return m_token;
+  }
+
+  if(m_token == Token::END_ELEMENT) {
+    m_elements.pop_back();
+  }
+
+  m_attributes.clear();
+  m_text = data::share::StringKeyLabel();
+  m_emptyElement = false;
+
+  if(m_pendingEnd) {
+    m_pendingEnd = false;
+    m_token = Token::END_ELEMENT;
+    return m_token;
+  }
+
+  while(m_caret.canContinue()) {
+    if(m_caret.isAtChar('<')) {
+      if(Deserializer::skipNode(m_state)) {
+        if(m_state.error.isSet()) {
+          return fail();
+        }
+        continue;
+      }
+      return readMarkup();
+    }
+    /* END_DOCUMENT here means that blank text was skipped */
+    auto token = readText();
+    if(token != Token::END_DOCUMENT) {
+      return token;
+    }
+  }
+
+  if(!m_elements.empty()) {
+    m_state.error.set(Error::Code::INVALID_CLOSING_TAG, m_caret.getDataSize());
+    return fail();
+  }
+
+  m_token = Token::END_DOCUMENT;
+  return m_token;
+
+}
+
+bool PullReader::skipElement() {
+
+  if(m_token != Token::START_ELEMENT) {
+    return m_token != Token::FAILURE;
+  }
+
+  auto depth = m_elements.size();
+  while(true) {
+    auto token = next();
+    if(token == Token::FAILURE) {
+      return false;
+    }
+    if(token == Token::END_ELEMENT && m_elements.size() == depth) {
+      return true;
+    }
+  }
+
+}
+
+PullReader::Token PullReader::getToken() const {
+  return m_token;
+}
+
+const data::share::StringKeyLabel& PullReader::getName() const {
+  return m_name;
+}
+
+const data::share::StringKeyLabel& PullReader::getRawText() const {
+  return m_text;
+}
+
+oatpp::String PullReader::unescape(const data::share::StringKeyLabel& text) {
+  auto data = static_cast<const char*>(text.getData());
+  auto size = text.getSize();
+  if(std::memchr(data, '&', static_cast<size_t>(size)) == nullptr) {
+    return oatpp::String(data, size);
+  }
+  data::stream::BufferOutputStream stream(size);
+  Utils::unescapeText(&stream, data, size);
+  return stream.toString();
+}
+
+oatpp::String PullReader::getText() const {
+  if(m_text.getData() == nullptr) {
+    return nullptr;
+  }
+  if(m_token == Token::TEXT) {
+    return unescape(m_text);
+  }
+  return m_text.toString();
+}
+
+bool PullReader::isEmptyElement() const {
+  return m_emptyElement;
+}
+
+v_buff_size PullReader::getDepth() const {
+  return static_cast<v_buff_size>(m_elements.size());
+}
+
+const std::vector<PullReader::Attribute>& PullReader::getAttributes() const {
+  return m_attributes;
+}
+
+oatpp::String PullReader::getAttributeValue(const char* name) const {
+  auto nameSize = static_cast<v_buff_size>(std::strlen(name));
+  for(auto& attribute : m_attributes) {
+    if(attribute.name.getSize() == nameSize && std::memcmp(attribute.name.getData(), name, static_cast<size_t>(nameSize)) == 0) {
+      return unescape(attribute.rawValue);
+    }
+  }
+  return nullptr;
+}
+
+oatpp::String PullReader::getAttributeValue(v_buff_size index) const {
+  return unescape(m_attributes[static_cast<size_t>(index)].rawValue);
+}
+
+const Error& PullReader::getError() const {
+  return m_state.error;
+}
+
+oatpp::String PullReader::getErrorMessage() {
+  return m_state.error.toString("oatpp::xml::PullReader", m_caret.getData(), m_caret.getDataSize());
+}
+
+}}
@@ -0,0 +1,242 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_PULLREADER_HPP
+#define OATPP_XML_PULLREADER_HPP
+
+#include "./Deserializer.hpp"
+
+#include "oatpp/data/share/MemoryLabel.hpp"
+#include "oatpp/utils/parser/Caret.hpp"
+#include "oatpp/Types.hpp"
+
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Pull (StAX-style) reader. <br>
+ * &l:PullReader::next (); moves the cursor to the next token of the document.
+ * Names, attributes and text are zero-copy views of the input - they are valid until the next call to &l:PullReader::next ();
+ * and as long as the input data is alive. Text and attribute values are unescaped only when requested. <br>
+ * Limits of &id:oatpp::xml::Deserializer::Config; are applied. Namespaces are not processed - names are kept as-is.
+ * Blank text between elements is skipped the same way &id:oatpp::xml::Deserializer; does.
+ * Comments and PIs are skipped when `skipComments` and `skipPIs` are set. <br>
+ * Reader is NOT thread-safe.
+ */
+class PullReader {
+public:
+
+  /**
+   * Token type.
+   */
+  enum class Token : v_int32 {
+
+    /**
+     * End of the document. No more tokens.
+     */
+    END_DOCUMENT = 0,
+
+    /**
+     * Element start tag - `<name attr="value">`. <br>
+     * Empty element - `<name/>` - is reported as START_ELEMENT followed by END_ELEMENT.
+     */
+    START_ELEMENT = 1,
+
+    /**
+     * Element end tag - `</name>`.
+     */
+    END_ELEMENT = 2,
+
+    /**
+     * Element text.
+     */
+    TEXT = 3,
+
+    /**
+     * CDATA section.
+     */
+    CDATA = 4,
+
+    /**
+     * Comment.
+     */
+    COMMENT = 5,
+
+    /**
+     * Processing instruction. Name is the PI target.
+     */
+    PI = 6,
+
+    /**
+     * Parsing failed. See &l:PullReader::getError ();. No more tokens.
+     */
+    FAILURE = 7
+
+  };
+
+public:
+
+  /**
+   * Attribute of the current start tag.
+   */
+  struct Attribute {
+
+    /**
+     * Attribute name.
+     */
+    data::share::StringKeyLabel name;
+
+    /**
+     * Attribute value - raw, as in the document.
+     */
+    data::share::StringKeyLabel rawValue;
+
+  };
+
+private:
+  utils::parser::Caret m_caret;
+  Deserializer::Config m_config;
+  Deserializer::State m_state;
+  Token m_token;
+  data::share::StringKeyLabel m_name;
+  data::share::StringKeyLabel m_text;
+  std::vector<Attribute> m_attributes;
+  std::vector<data::share::StringKeyLabel> m_elements;
+  bool m_emptyElement;
+  bool m_pendingEnd;
+private:
+  void init();
+  Token fail();
+  Token readMarkup();
+  Token readStartElement();
+  Token readEndElement();
+  Token readText();
+  static oatpp::String unescape(const data::share::StringKeyLabel& text);
+public:
+
+  /**
+   * Constructor.
+   * @param text - document. Reader keeps a reference to the text.
+   * @param config - &id:oatpp::xml::Deserializer::Config;.
+   */
+  PullReader(const oatpp::String& text, const Deserializer::Config& config = {});
+
+  /**
+   * Constructor.
+   * @param data - document data. Data must stay alive while the reader is used.
+   * @param size - document size.
+   * @param config - &id:oatpp::xml::Deserializer::Config;.
+   */
+  PullReader(const char* data, v_buff_size size, const Deserializer::Config& config = {});
+
+  PullReader(const PullReader&) = delete;
+  PullReader& operator=(const PullReader&) = delete;
+
+  /**
+   * Move to the next token.
+   * @return - &l:PullReader::Token;.
+   */
+  Token next();
+
+  /**
+   * Skip the rest of the current element - all its content and the end tag. <br>
+   * Call it on START_ELEMENT. The cursor is left on the END_ELEMENT of the skipped element.
+   * @return - `false` if parsing failed.
+   */
+  bool skipElement();
+
+  /**
+   * Get current token.
+   * @return - &l:PullReader::Token;.
+   */
+  Token getToken() const;
+
+  /**
+   * Name of the current element or the PI target.
+   * @return
+   */
+  const data::share::StringKeyLabel& getName() const;
+
+  /**
+   * Raw text of the current TEXT, CDATA, COMMENT or PI token - as in the document.
+   * @return
+   */
+  const data::share::StringKeyLabel& getRawText() const;
+
+  /**
+   * Text of the current token. TEXT is unescaped, other tokens are copied as-is.
+   * @return
+   */
+  oatpp::String getText() const;
+
+  /**
+   * Check if current START_ELEMENT is an empty element - `<name/>`.
+   * @return
+   */
+  bool isEmptyElement() const;
+
+  /**
+   * Nesting depth of the current token. Root START_ELEMENT and END_ELEMENT are at depth `1`.
+   * @return
+   */
+  v_buff_size getDepth() const;
+
+  /**
+   * Attributes of the current START_ELEMENT.
+   * @return
+   */
+  const std::vector<Attribute>& getAttributes() const;
+
+  /**
+   * Get unescaped value of the current START_ELEMENT attribute.
+   * @param name - attribute name.
+   * @return - attribute value or `nullptr` if there is no such attribute.
+   */
+  oatpp::String getAttributeValue(const char* name) const;
+
+  /**
+   * Get unescaped value of the current START_ELEMENT attribute.
+   * @param index - attribute index in &l:PullReader::getAttributes ();.
+   * @return
+   */
+  oatpp::String getAttributeValue(v_buff_size index) const;
+
+  /**
+   * Get parsing error.
+   * @return - &id:oatpp::xml::Error;.
+   */
+  const Error& getError() const;
+
+  /**
+   * Render parsing error to string - with the line, column and element path.
+   * @return
+   */
+  oatpp::String getErrorMessage();
+
+};
+
+}}
+
+#endif //OATPP_XML_PULLREADER_HPP
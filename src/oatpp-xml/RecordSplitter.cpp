@@ -0,0 +1,224 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "RecordSplitter.hpp"
+
+#include "./Scanner.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace oatpp { namespace xml {
+
+RecordSplitter::RecordSplitter(v_buff_size maxRecordSize)
+  : m_offset(0)
+  , m_recordStart(0)
+  , m_position(0)
+  , m_depth(0)
+  , m_maxRecordSize(maxRecordSize)
+  , m_markup(Markup::NONE)
+  , m_scanPosition(0)
+  , m_quote(0)
+{}
+
+v_buff_size RecordSplitter::scanMarkup(v_buff_size position, bool& isRecordEnd) {
+
+  auto data = m_buffer.data();
+  auto size = static_cast<v_buff_size>(m_buffer.size());
+
+  if(m_markup == Markup::NONE) {
+
+    auto markup = data + position;
+    auto rest = size - position;
+
+    /* not enough data to tell the kind of the markup - wait for more */
+    if(rest < 2) {
+      return -1;
+    }
+
+    if(markup[1] == '!') {
+      if(rest < 4) {
+        return -1;
+      }
+      if(std::memcmp(markup, "<!--", 4) == 0) {
+        m_markup = Markup::COMMENT;
+        m_scanPosition = position + 4;
+      } else if(rest < 9) {
+        return -1;
+      } else if(std::memcmp(markup, "<![CDATA[", 9) == 0) {
+        m_markup = Markup::CDATA;
+        m_scanPosition = position + 9;
+      } else {
+        /* DOCTYPE */
+        m_markup = Markup::DECLARATION;
+        m_scanPosition = position + 2;
+      }
+    } else if(markup[1] == '?') {
+      m_markup = Markup::PI;
+      m_scanPosition = position + 2;
+    } else if(markup[1] == '/') {
+      m_markup = Markup::END_TAG;
+      m_scanPosition = position + 2;
+    } else {
+      m_markup = Markup::START_TAG;
+      m_scanPosition = position + 1;
+    }
+
+    m_quote = 0;
+
+  }
+
+  /* -1 - markup is not complete, the next scan starts where this one stopped */
+  auto skipTo = [&](const char* text, v_buff_size textSize) -> v_buff_size {
+    auto offset = Scanner::findText(data + m_scanPosition, size - m_scanPosition, text, textSize);
+    if(offset < 0) {
+      /* the terminator may start in the tail */
+      m_scanPosition = std::max(m_scanPosition, size - textSize + 1);
+      return -1;
+    }
+    return m_scanPosition + offset + textSize;
+  };
+
+  auto skipTag = [&]() -> v_buff_size {
+    auto offset = Scanner::findTagEnd(data + m_scanPosition, size - m_scanPosition, m_quote);
+    if(offset < 0) {
+      m_scanPosition = size;
+      return -1;
+    }
+    return m_scanPosition + offset;
+  };
+
+  v_buff_size end;
+  auto markup = m_markup;
+
+  switch(markup) {
+    case Markup::COMMENT: end = skipTo("-->", 3); break;
+    case Markup::CDATA: end = skipTo("]]>", 3); break;
+    case Markup::PI: end = skipTo("?>", 2); break;
+    default: end = skipTag(); break;
+  }
+
+  if(end < 0) {
+    return -1;
+  }
+
+  m_markup = Markup::NONE;
+
+  if(markup == Markup::END_TAG) {
+    if(m_depth == 0) {
+      m_error.set(Error::Code::INVALID_CLOSING_TAG, m_offset + position);
+      return -1;
+    }
+    m_depth --;
+    isRecordEnd = m_depth == 0;
+  } else if(markup == Markup::START_TAG) {
+    if(data[end - 2] == '/') {
+      isRecordEnd = m_depth == 0;
+    } else {
+      m_depth ++;
+    }
+  }
+
+  return end;
+
+}
+
+void RecordSplitter::feed(const char* data, v_buff_size size) {
+  /* drop records which are already returned - only when they take most of the buffer, so that data is moved rarely */
+  if(m_recordStart > 0 && m_recordStart * 2 >= static_cast<v_buff_size>(m_buffer.size())) {
+    m_buffer.erase(0, static_cast<size_t>(m_recordStart));
+    m_offset += m_recordStart;
+    m_position -= m_recordStart;
+    if(m_markup != Markup::NONE) {
+      m_scanPosition -= m_recordStart;
+    }
+    m_recordStart = 0;
+  }
+  m_buffer.append(data, static_cast<size_t>(size));
+}
+
+bool RecordSplitter::next(oatpp::String& record) {
+
+  if(m_error.isSet()) {
+    return false;
+  }
+
+  auto data = m_buffer.data();
+  auto size = static_cast<v_buff_size>(m_buffer.size());
+
+  if(m_depth == 0 && m_position == m_recordStart) {
+    while(m_position < size && (data[m_position] == ' ' || data[m_position] == '\n' || data[m_position] == '\r' ||
+                                data[m_position] == '\t' || data[m_position] == '\f'))
+    {
+      m_position ++;
+    }
+    m_recordStart = m_position;
+  }
+
+  while(m_position < size) {
+
+    auto found = static_cast<const char*>(std::memchr(data + m_position, '<', static_cast<size_t>(size - m_position)));
+    if(found == nullptr) {
+      m_position = size;
+      break;
+    }
+
+    auto position = static_cast<v_buff_size>(found - data);
+    bool isRecordEnd = false;
+    auto end = scanMarkup(position, isRecordEnd);
+    if(end < 0) {
+      m_position = position;
+      break;
+    }
+    m_position = end;
+
+    if(isRecordEnd) {
+      auto recordSize = m_position - m_recordStart;
+      if(m_maxRecordSize > 0 && recordSize > m_maxRecordSize) {
+        break;
+      }
+      record = oatpp::String(data + m_recordStart, recordSize);
+      m_recordStart = m_position;
+      return true;
+    }
+
+  }
+
+  if(!m_error.isSet() && m_maxRecordSize > 0 && size - m_recordStart > m_maxRecordSize) {
+    m_error.set(Error::Code::DOCUMENT_SIZE_LIMIT_EXCEEDED, m_offset + m_recordStart + m_maxRecordSize);
+  }
+
+  return false;
+
+}
+
+v_buff_size RecordSplitter::getPendingSize() const {
+  return static_cast<v_buff_size>(m_buffer.size()) - m_recordStart;
+}
+
+const Error& RecordSplitter::getError() const {
+  return m_error;
+}
+
+}}
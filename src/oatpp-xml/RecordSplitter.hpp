@@ -0,0 +1,116 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_RECORDSPLITTER_HPP
+#define OATPP_XML_RECORDSPLITTER_HPP
+
+#include "./Error.hpp"
+
+#include "oatpp/Types.hpp"
+
+#include <string>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Splits a stream of concatenated XML documents into records - one document per record. <br>
+ * Data is fed in pieces of any size. Only the markup is looked at - comments, CDATA, PIs and quoted attribute values
+ * are skipped so that tags inside them don't break the split. The document is not validated - this is done by the parser. <br>
+ * A record is the prolog (PIs, comments) followed by the root element. Blank chars between records are dropped. <br>
+ * Markup split between pieces is not rescanned - the scan resumes where the previous piece ended. <br>
+ * Splitter is NOT thread-safe.
+ */
+class RecordSplitter {
+private:
+
+  /*
+   * Kind of the markup being scanned.
+   */
+  enum class Markup : v_int32 {
+    NONE = 0,
+    COMMENT,
+    CDATA,
+    PI,
+    DECLARATION,
+    START_TAG,
+    END_TAG
+  };
+
+private:
+  std::string m_buffer;
+  v_buff_size m_offset;
+  v_buff_size m_recordStart;
+  v_buff_size m_position;
+  v_buff_size m_depth;
+  v_buff_size m_maxRecordSize;
+  Error m_error;
+private:
+  /* markup which is not terminated in the data fed so far - scanning resumes where it stopped */
+  Markup m_markup;
+  v_buff_size m_scanPosition;
+  char m_quote;
+private:
+  v_buff_size scanMarkup(v_buff_size position, bool& isRecordEnd);
+public:
+
+  /**
+   * Constructor.
+   * @param maxRecordSize - max size of a record. `0` - no limit.
+   */
+  RecordSplitter(v_buff_size maxRecordSize = 0);
+
+  /**
+   * Append stream data.
+   * @param data
+   * @param size
+   */
+  void feed(const char* data, v_buff_size size);
+
+  /**
+   * Get the next complete record.
+   * @param record - out record.
+   * @return - `false` if there is no complete record in the data fed so far, or if splitting failed - see &l:RecordSplitter::getError ();.
+   */
+  bool next(oatpp::String& record);
+
+  /**
+   * Size of the fed data which is not returned as a record yet.
+   * Non-zero at the end of the stream means the last record is incomplete.
+   * @return
+   */
+  v_buff_size getPendingSize() const;
+
+  /**
+   * Get splitting error. Error position is the offset in the stream. <br>
+   * `DOCUMENT_SIZE_LIMIT_EXCEEDED` - record is bigger than `maxRecordSize`.
+   * `INVALID_CLOSING_TAG` - closing tag outside of an element.
+   * @return - &id:oatpp::xml::Error;.
+   */
+  const Error& getError() const;
+
+};
+
+}}
+
+#endif //OATPP_XML_RECORDSPLITTER_HPP
@@ -0,0 +1,271 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Scanner.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define OATPP_XML_SCANNER_SSE2
+  #include <emmintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #endif
+#endif
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+v_buff_size findTextScalar(const char* data, v_buff_size size, const char* text, v_buff_size textSize) {
+
+  auto first = text[0];
+  v_buff_size i = 0;
+
+  while(size - i >= textSize) {
+    auto found = static_cast<const char*>(std::memchr(data + i, first, static_cast<size_t>(size - i - textSize + 1)));
+    if(found == nullptr) {
+      return -1;
+    }
+    i = static_cast<v_buff_size>(found - data);
+    if(std::memcmp(found + 1, text + 1, static_cast<size_t>(textSize - 1)) == 0) {
+      return i;
+    }
+    i ++;
+  }
+
+  return -1;
+
+}
+
+#if defined(OATPP_XML_SCANNER_SSE2)
+
+inline v_uint32 countTrailingZeros(v_uint32 mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<v_uint32>(index);
+#else
+  return static_cast<v_uint32>(__builtin_ctz(mask));
+#endif
+}
+
+#endif
+
+/*
+ * UTF-8 byte classes:
+ * 0 - ASCII, 1 - 80..8F, 2 - 90..9F, 3 - A0..BF (continuation bytes),
+ * 4 - C0, C1, F5..FF (never valid), 5 - C2..DF, 6 - E0, 7 - E1..EC, EE, EF, 8 - ED, 9 - F0, 10 - F1..F3, 11 - F4.
+ */
+constexpr v_uint8 UTF8_CLASSES[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+  6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 7,
+  9, 10, 10, 10, 11, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+};
+
+constexpr v_uint8 UTF8_ACCEPT = 0;
+constexpr v_uint8 UTF8_REJECT = 1;
+constexpr v_uint8 UTF8_CLASSES_COUNT = 12;
+
+/*
+ * UTF8_STATES[state * UTF8_CLASSES_COUNT + class] - next state. States:
+ * 0 - accept, 1 - reject, 2 - 1 continuation byte left, 3 - 2 left, 4 - after E0 (A0..BF, no overlongs),
+ * 5 - after ED (80..9F, no surrogates), 6 - 3 left, 7 - after F0 (90..BF, no overlongs), 8 - after F4 (80..8F, max U+10FFFF).
+ */
+constexpr v_uint8 UTF8_STATES[9 * UTF8_CLASSES_COUNT] = {
+  0, 1, 1, 1, 1, 2, 4, 3, 5, 7, 6, 8,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 3, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+inline bool hasNonAscii8(const char* data) {
+  v_uint64 word;
+  std::memcpy(&word, data, 8);
+  return (word & 0x8080808080808080ULL) != 0;
+}
+
+}
+
+v_buff_size Scanner::findText(const char* data, v_buff_size size, const char* text, v_buff_size textSize) {
+
+  if(textSize > size) {
+    return -1;
+  }
+
+#if defined(OATPP_XML_SCANNER_SSE2)
+
+  if(textSize > 1) {
+
+    const auto first = _mm_set1_epi8(text[0]);
+    const auto last = _mm_set1_epi8(text[textSize - 1]);
+
+    v_buff_size i = 0;
+    /* both 16-byte loads - at i and at i + textSize - 1 - stay within data */
+    for(; i + textSize - 1 + 16 <= size; i += 16) {
+
+      auto blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      auto blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + textSize - 1));
+      auto mask = static_cast<v_uint32>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))
+      ));
+
+      while(mask != 0) {
+        auto offset = i + countTrailingZeros(mask);
+        if(std::memcmp(data + offset + 1, text + 1, static_cast<size_t>(textSize - 2)) == 0) {
+          return offset;
+        }
+        mask &= mask - 1;
+      }
+
+    }
+
+    auto result = findTextScalar(data + i, size - i, text, textSize);
+    return result < 0 ? -1 : i + result;
+
+  }
+
+#endif
+
+  return findTextScalar(data, size, text, textSize);
+
+}
+
+v_buff_size Scanner::findTagEnd(const char* data, v_buff_size size) {
+  char quote = 0;
+  return findTagEnd(data, size, quote);
+}
+
+v_buff_size Scanner::findTagEnd(const char* data, v_buff_size size, char& quote) {
+  v_buff_size i = 0;
+  while(i < size) {
+    if(quote != 0) {
+      auto found = static_cast<const char*>(std::memchr(data + i, quote, static_cast<size_t>(size - i)));
+      if(found == nullptr) {
+        return -1;
+      }
+      i = static_cast<v_buff_size>(found - data) + 1;
+      quote = 0;
+      continue;
+    }
+    auto c = data[i];
+    if(c == '"' || c == '\'') {
+      quote = c;
+    } else if(c == '>') {
+      return i + 1;
+    }
+    i ++;
+  }
+  return -1;
+}
+
+v_buff_size Scanner::findInvalidUtf8(const char* data, v_buff_size size) {
+
+  v_buff_size i = 0;
+
+  while(i < size) {
+
+    if(static_cast<v_uint8>(data[i]) < 0x80) {
+
+#if defined(OATPP_XML_SCANNER_SSE2)
+      while(size - i >= 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if(_mm_movemask_epi8(block) != 0) {
+          break;
+        }
+        i += 16;
+      }
+#endif
+
+      while(size - i >= 8 && !hasNonAscii8(data + i)) {
+        i += 8;
+      }
+
+      while(i < size && static_cast<v_uint8>(data[i]) < 0x80) {
+        i ++;
+      }
+
+      continue;
+
+    }
+
+    /* multibyte sequence - run the state machine until it accepts or rejects */
+    auto state = UTF8_STATES[UTF8_CLASSES[static_cast<v_uint8>(data[i])]];
+    v_buff_size j = i + 1;
+    while(state > UTF8_REJECT && j < size) {
+      state = UTF8_STATES[state * UTF8_CLASSES_COUNT + UTF8_CLASSES[static_cast<v_uint8>(data[j])]];
+      j ++;
+    }
+
+    if(state != UTF8_ACCEPT) {
+      return i;
+    }
+
+    i = j;
+
+  }
+
+  return -1;
+
+}
+
+v_buff_size Scanner::trimToCodePoint(const char* data, v_buff_size size) {
+
+  v_buff_size i = size;
+  while(i > 0 && size - i < 3 && (static_cast<v_uint8>(data[i - 1]) & 0xC0) == 0x80) {
+    i --;
+  }
+  if(i == 0) {
+    return size;
+  }
+
+  auto lead = static_cast<v_uint8>(data[i - 1]);
+  v_buff_size length = 1;
+  if(lead >= 0xF0) length = 4;
+  else if(lead >= 0xE0) length = 3;
+  else if(lead >= 0xC0) length = 2;
+
+  return i - 1 + length > size ? i - 1 : size;
+
+}
+
+}}
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_SCANNER_HPP
+#define OATPP_XML_SCANNER_HPP
+
+#include "oatpp/Types.hpp"
+
+namespace oatpp { namespace xml {
+
+/**
+ * Vectorized search in raw text. <br>
+ * On SSE2 targets candidates are filtered 16 bytes at a time by the first and the last byte of the pattern,
+ * only positions where both match are compared in full.
+ * Other targets fall back to `memchr` on the first byte.
+ */
+class Scanner {
+public:
+
+  /**
+   * Find the first occurrence of `text` in `data`.
+   * @param data - data to search in.
+   * @param size - size of the data.
+   * @param text - text to search for.
+   * @param textSize - size of the text. Must be > 0.
+   * @return - offset of the text in data or `-1` if not found.
+   */
+  static v_buff_size findText(const char* data, v_buff_size size, const char* text, v_buff_size textSize);
+
+  /**
+   * Find the end of a tag - the first `>` which is not inside a quoted attribute value.
+   * @param data - tag data, ex.: `<a href="x>y">`, starting anywhere before the end.
+   * @param size - size of the data.
+   * @return - offset right after the `>` or `-1` if the tag is not terminated.
+   */
+  static v_buff_size findTagEnd(const char* data, v_buff_size size);
+
+  /**
+   * Find the end of a tag which may be split between pieces of data. <br>
+   * Same as &l:Scanner::findTagEnd (); but the quote state is kept between calls.
+   * @param data - tag data.
+   * @param size - size of the data.
+   * @param quote - in/out. Quote char of the attribute value the data starts in, `0` - outside of a value.
+   * Set to the state at the end of the data if the tag is not terminated.
+   * @return - offset right after the `>` or `-1` if the tag is not terminated.
+   */
+  static v_buff_size findTagEnd(const char* data, v_buff_size size, char& quote);
+
+  /**
+   * Find the first invalid UTF-8 sequence - stray continuation bytes, overlong forms, surrogates,
+   * code points above U+10FFFF and sequences truncated by the end of the data. <br>
+   * ASCII runs are skipped 16 bytes at a time (SSE2) or 8 bytes at a time (other targets),
+   * multibyte sequences are checked with a table-driven state machine.
+   * @param data - data to validate.
+   * @param size - size of the data.
+   * @return - offset of the first byte of the invalid sequence or `-1` if the data is valid UTF-8.
+   */
+  static v_buff_size findInvalidUtf8(const char* data, v_buff_size size);
+
+  /**
+   * Cut the last UTF-8 sequence if the data ends in the middle of it. <br>
+   * Used to split text into pieces at code point boundaries. The data is not validated.
+   * @param data - data.
+   * @param size - size of the data.
+   * @return - size of the data without the trailing incomplete sequence.
+   */
+  static v_buff_size trimToCodePoint(const char* data, v_buff_size size);
+
+};
+
+}}
+
+#endif //OATPP_XML_SCANNER_HPP
@@ -23,28 +23,111 @@
  ***************************************************************************/
 
 #include "Serializer.hpp"
+#include "Scanner.hpp"
+#include "oatpp/data/stream/BufferStream.hpp"
 #include "oatpp/utils/Conversion.hpp"
 
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
 namespace oatpp { namespace xml {
 
 void Serializer::startNode(const oatpp::String& name, State& state) {
-  state.stream->writeSimple("<", 1);
-  state.stream->writeSimple(name);
-  for(v_uint32 i = 0; i < state.tree->attributes().size(); i ++) {
-    auto attr = state.tree->attributes()[i];
-    state.stream->writeSimple(" ", 1);
-    state.stream->writeSimple(attr.first);
-    state.stream->writeSimple("=\"", 2);
-    state.stream->writeSimple(Utils::escapeAttributeText(attr.second.get(), '"', state.errorStack));
-    state.stream->writeSimple("\"", 1);
+  state.buffer->write('<');
+  state.buffer->write(name);
+  const auto& attributes = state.tree->attributes();
+  for(v_uint32 i = 0; i < attributes.size(); i ++) {
+    auto attr = attributes[i];
+    state.buffer->write(' ');
+    state.buffer->write(attr.first);
+    state.buffer->write("=\"", 2);
+    const auto& value = attr.second.get();
+    if(value && !state.buffer->writeEscapedAttributeText(value->data(), static_cast<v_buff_size>(value->size()), '"')) {
+      state.error.set(Error::Code::INVALID_CHARACTER);
+      state.error.pushAttribute(attr.first);
+      return;
+    }
+    state.buffer->write('"');
   }
-  state.stream->writeSimple(">", 1);
+  state.buffer->write('>');
 }
 
 void Serializer::endNode(const oatpp::String& name, State& state) {
-  state.stream->writeSimple("</", 2);
-  state.stream->writeSimple(name);
-  state.stream->writeSimple(">", 1);
+  state.buffer->write("</", 2);
+  state.buffer->write(name);
+  state.buffer->write('>');
+}
+
+FragmentCache::OutputKey Serializer::getOutputKey(const Config& config) {
+  FragmentCache::OutputKey key;
+  key.escapeFlags = config.escapeFlags;
+  key.includeNullElements = config.includeNullElements;
+  key.useBeautifier = config.useBeautifier;
+  if(config.useBeautifier) {
+    if(config.beautifierIndent) key.beautifierIndent = *config.beautifierIndent;
+    if(config.beautifierNewLine) key.beautifierNewLine = *config.beautifierNewLine;
+  }
+  key.includeNullFields = false;
+  key.alwaysIncludeRequired = false;
+  return key;
+}
+
+void Serializer::writeFragment(State& state, const oatpp::String& id, v_uint64 version, const FragmentCache::OutputKey& outputKey, const std::function<void()>& render) {
+
+  auto cache = state.config->fragmentCache.get();
+  if(cache == nullptr || !id) {
+    render();
+    return;
+  }
+
+  auto bytes = cache->get(id, version, outputKey);
+  if(bytes) {
+    state.buffer->write(bytes);
+    return;
+  }
+
+  /* render to memory once - the next time the bytes are written as is */
+  data::stream::BufferOutputStream stream;
+  char scratch[4096];
+  WriteBuffer buffer(&stream, scratch, sizeof(scratch));
+
+  auto outer = state.buffer;
+  state.buffer = &buffer;
+  render();
+  buffer.flush();
+  state.buffer = outer;
+
+  if(state.error.isSet()) {
+    return;
+  }
+
+  bytes = stream.toString();
+  cache->put(id, version, outputKey, bytes);
+  state.buffer->write(bytes);
+
+}
+
+void Serializer::serializeFragment(State& state) {
+
+  oatpp::String id;
+  v_uint64 version = 0;
+
+  const auto& attributes = state.tree->attributes();
+  for(v_uint32 i = 0; i < attributes.size(); i ++) {
+    auto attr = attributes[i];
+    const auto& value = attr.second.get();
+    if(attr.first == "id") {
+      id = value;
+    } else if(attr.first == "version" && value) {
+      version = std::strtoull(value->c_str(), nullptr, 10);
+    }
+  }
+
+  writeFragment(state, id, version, getOutputKey(*state.config), [&state]() {
+    serializeNode(state);
+  });
+
 }
 
 void Serializer::serializeCData(State& state) {
@@ -56,14 +139,14 @@ void Serializer::serializeCData(State& state) {
   }
 
   if(node.getType() != data::mapping::Tree::Type::STRING) {
-    state.errorStack.push("[oatpp::xml::Serializer::serializeCData()]: String is expected as CDATA data");
+    state.error.set(Error::Code::STRING_EXPECTED);
     return;
   }
 
-  state.stream->writeSimple("<![CDATA[", 9);
+  state.buffer->write("<![CDATA[", 9);
   auto data = state.tree->getString();
-  state.stream->writeSimple(data->data(), static_cast<v_buff_size>(data->size()));
-  state.stream->writeSimple("]]>", 3);
+  state.buffer->write(data->data(), static_cast<v_buff_size>(data->size()));
+  state.buffer->write("]]>", 3);
 
 }
 
@@ -76,41 +159,112 @@ void Serializer::serializeComment(State& state) {
   }
 
   if(node.getType() != data::mapping::Tree::Type::STRING) {
-    state.errorStack.push("[oatpp::xml::Serializer::serializeComment()]: String is expected as COMMENT data");
+    state.error.set(Error::Code::STRING_EXPECTED);
+    return;
+  }
+
+  state.buffer->write("<!--", 4);
+  auto data = state.tree->getString();
+  state.buffer->write(data->data(), static_cast<v_buff_size>(data->size()));
+  state.buffer->write("-->", 3);
+
+}
+
+void Serializer::serializeBase64(State& state) {
+
+  auto& node = *state.tree;
+
+  if(node.isNull()) {
+    return;
+  }
+
+  if(node.getType() != data::mapping::Tree::Type::STRING) {
+    state.error.set(Error::Code::STRING_EXPECTED);
     return;
   }
 
-  state.stream->writeSimple("<!--", 4);
   auto data = state.tree->getString();
-  state.stream->writeSimple(data->data(), static_cast<v_buff_size>(data->size()));
-  state.stream->writeSimple("-->", 3);
+  state.buffer->writeBase64(data->data(), static_cast<v_buff_size>(data->size()));
+
+}
+
+void Serializer::serializeSpill(State& state) {
+
+  auto& node = *state.tree;
+
+  if(node.getType() != data::mapping::Tree::Type::STRING) {
+    state.error.set(Error::Code::STRING_EXPECTED);
+    return;
+  }
+
+  const auto& sink = state.config->spillSink ? state.config->spillSink : FileSpillSink::getDefault();
+
+  /* pieces are cut at code point boundaries - escaping works on whole characters */
+  char buffer[4096];
+  v_buff_size size = 0;
+
+  try {
+
+    auto stream = sink->read(node.getString());
+    if(!stream) {
+      state.error.set(Error::Code::SPILL_FAILED);
+      return;
+    }
+
+    while(true) {
+      auto res = stream->readSimple(buffer + size, static_cast<v_buff_size>(sizeof(buffer)) - size);
+      if(res < 0) {
+        state.error.set(Error::Code::SPILL_FAILED);
+        return;
+      }
+      if(res == 0) {
+        break;
+      }
+      size += res;
+      auto pieceSize = Scanner::trimToCodePoint(buffer, size);
+      if(!state.buffer->writeEscapedElementText(buffer, pieceSize)) {
+        state.error.set(Error::Code::INVALID_CHARACTER);
+        return;
+      }
+      size -= pieceSize;
+      std::memmove(buffer, buffer + pieceSize, static_cast<size_t>(size));
+    }
+
+  } catch (std::exception&) {
+    state.error.set(Error::Code::SPILL_FAILED);
+    return;
+  }
+
+  if(size > 0 && !state.buffer->writeEscapedElementText(buffer, size)) {
+    state.error.set(Error::Code::INVALID_CHARACTER);
+  }
 
 }
 
 void Serializer::serializePINode(State& state, const oatpp::String& key) {
 
   if(!key || key->size() < 2) {
-    state.errorStack.push("[oatpp::xml::Serializer::serializePINode()]: Invalid tag name");
+    state.error.set(Error::Code::INVALID_PI_NAME);
     return;
   }
 
   auto& node = *state.tree;
 
   if(node.getType() != data::mapping::Tree::Type::STRING) {
-    state.errorStack.push("[oatpp::xml::Serializer::serializePINode()]: String is expected as PI data");
+    state.error.set(Error::Code::STRING_EXPECTED);
     return;
   }
 
-  state.stream->writeSimple("<?", 2);
-  state.stream->writeSimple(key->data() + 1, static_cast<v_buff_size>(key->size() - 1));
+  state.buffer->write("<?", 2);
+  state.buffer->write(key->data() + 1, static_cast<v_buff_size>(key->size() - 1));
 
   auto data = state.tree->getString();
   if(!data->empty()) {
-    state.stream->writeSimple(" ", 1);
-    state.stream->writeSimple(data->data(), static_cast<v_buff_size>(data->size()));
+    state.buffer->write(' ');
+    state.buffer->write(data->data(), static_cast<v_buff_size>(data->size()));
   }
 
-  state.stream->writeSimple("?>", 2);
+  state.buffer->write("?>", 2);
 
 }
 
@@ -133,8 +287,20 @@ bool Serializer::serializeSpecial(State& state, const oatpp::String& key) {
         serializeComment(state);
         return true;
       }
-      state.errorStack.push("[oatpp::xml::Serializer::serializeSpecial()]: Unknown special node type '" + key + "'");
-      break;
+      if(key == "!BASE64") {
+        serializeBase64(state);
+        return true;
+      }
+      if(key == FragmentCache::NODE_NAME) {
+        serializeFragment(state);
+        return true;
+      }
+      if(key == "!SPILL") {
+        serializeSpill(state);
+        return true;
+      }
+      state.error.set(Error::Code::UNKNOWN_SPECIAL_NODE);
+      return true;
     }
     case '?': {
       serializePINode(state, key);
@@ -148,43 +314,36 @@ bool Serializer::serializeSpecial(State& state, const oatpp::String& key) {
 }
 
 void Serializer::serializeString(State& state) {
-  auto content = Utils::escapeElementText(state.tree->getString(), state.errorStack);
-  if(!state.errorStack.empty()) {
-    state.errorStack.push("[oatpp::xml::Serializer::serializeString()]: Can't escape string");
-    return;
+  const auto& content = state.tree->getString();
+  if(content && !state.buffer->writeEscapedElementText(content->data(), static_cast<v_buff_size>(content->size()))) {
+    state.error.set(Error::Code::INVALID_CHARACTER);
   }
-  state.stream->writeSimple(content);
 }
 
 void Serializer::serializeArray(State& state) {
 
-  State nestedState;
-  nestedState.stream = state.stream;
-  nestedState.config = state.config;
-
-  auto& vector = state.tree->getVector();
+  auto tree = state.tree;
+  auto& vector = tree->getVector();
 
   oatpp::String itemName = "item";
 
   v_int64 index = 0;
-  for(auto& tree : vector) {
+  for(auto& item : vector) {
 
-    nestedState.tree = &tree;
+    if(!item.isNull() || state.config->includeNullElements) {
 
-    if(!tree.isNull() || state.config->includeNullElements) {
+      state.tree = &item;
 
-      startNode(itemName, nestedState);
-      if(!nestedState.errorStack.empty()) {
-        state.errorStack.splice(nestedState.errorStack);
-        state.errorStack.push("[oatpp::xml::Serializer::serializeArray()]: index=" + utils::Conversion::int64ToStr(index));
-        return;
+      startNode(itemName, state);
+      if(!state.error.isSet()) {
+        serializeNode(state);
       }
 
-      serialize(nestedState);
+      state.tree = tree;
 
-      if(!nestedState.errorStack.empty()) {
-        state.errorStack.splice(nestedState.errorStack);
-        state.errorStack.push("[oatpp::xml::Serializer::serializeArray()]: index=" + utils::Conversion::int64ToStr(index));
+      if(state.error.isSet()) {
+        state.error.pushIndex(index);
+        state.error.pushElement(itemName);
         return;
       }
 
@@ -200,37 +359,32 @@ void Serializer::serializeArray(State& state) {
 
 void Serializer::serializeMap(State& state) {
 
-  State nestedState;
-  nestedState.stream = state.stream;
-  nestedState.config = state.config;
-
-  auto& map = state.tree->getMap();
+  auto tree = state.tree;
+  auto& map = tree->getMap();
   auto mapSize = map.size();
 
   for(v_uint64 index = 0; index < mapSize; index ++) {
 
     const auto& pair = map[index];
+    const auto& node = pair.second.get();
 
-    nestedState.tree = &pair.second.get();
+    if(!node.isNull() || state.config->includeNullElements) {
 
-    if(!nestedState.tree->isNull() || state.config->includeNullElements) {
+      state.tree = &node;
 
-      startNode(pair.first, nestedState);
-      if(!nestedState.errorStack.empty()) {
-        state.errorStack.splice(nestedState.errorStack);
-        state.errorStack.push("[oatpp::xml::Serializer::serializeMap()]: key='" + pair.first + "'");
-        return;
+      startNode(pair.first, state);
+      if(!state.error.isSet()) {
+        serializeNode(state);
       }
 
-      serialize(nestedState);
+      state.tree = tree;
 
-      if(!nestedState.errorStack.empty()) {
-        state.errorStack.splice(nestedState.errorStack);
-        state.errorStack.push("[oatpp::xml::Serializer::serializeMap()]: key='" + pair.first + "'");
+      if(state.error.isSet()) {
+        state.error.pushElement(pair.first);
         return;
       }
 
-      endNode(pair.first, nestedState);
+      endNode(pair.first, state);
 
     }
 
@@ -240,47 +394,40 @@ void Serializer::serializeMap(State& state) {
 
 void Serializer::serializePairs(State& state) {
 
-  State nestedState;
-  nestedState.stream = state.stream;
-  nestedState.config = state.config;
+  auto tree = state.tree;
+  auto& pairs = tree->getPairs();
 
-  auto& map = state.tree->getPairs();
-  auto mapSize = map.size();
+  for(const auto& pair : pairs) {
 
-  for(v_uint64 index = 0; index < mapSize; index ++) {
+    const auto& key = pair.first;
+    const auto& node = pair.second;
 
-    const auto& pair = map[index];
+    if(!node.isNull() || state.config->includeNullElements) {
 
-    nestedState.tree = &pair.second;
+      state.tree = &node;
 
-    if(!nestedState.tree->isNull() || state.config->includeNullElements) {
-
-      auto& key = pair.first;
-      if(serializeSpecial(nestedState, key)) {
-        if(!nestedState.errorStack.empty()) {
-          state.errorStack.splice(nestedState.errorStack);
-          state.errorStack.push("[oatpp::xml::Serializer::serializePairs()]: key='" + key + "'");
+      if(serializeSpecial(state, key)) {
+        state.tree = tree;
+        if(state.error.isSet()) {
+          state.error.pushElement(key);
           return;
         }
         continue;
       }
 
-      startNode(key, nestedState);
-      if(!nestedState.errorStack.empty()) {
-        state.errorStack.splice(nestedState.errorStack);
-        state.errorStack.push("[oatpp::xml::Serializer::serializePairs()]: key='" + key + "'");
-        return;
+      startNode(key, state);
+      if(!state.error.isSet()) {
+        serializeNode(state);
       }
 
-      serialize(nestedState);
+      state.tree = tree;
 
-      if(!nestedState.errorStack.empty()) {
-        state.errorStack.splice(nestedState.errorStack);
-        state.errorStack.push("[oatpp::xml::Serializer::serializePairs()]: key='" + key + "'");
+      if(state.error.isSet()) {
+        state.error.pushElement(key);
         return;
       }
 
-      endNode(key, nestedState);
+      endNode(key, state);
 
     }
 
@@ -288,7 +435,7 @@ void Serializer::serializePairs(State& state) {
 
 }
 
-void Serializer::serialize(oatpp::xml::Serializer::State &state) {
+void Serializer::serializeNode(State& state) {
 
   switch (state.tree->getType()) {
 
@@ -296,24 +443,24 @@ void Serializer::serialize(oatpp::xml::Serializer::State &state) {
 //      state.errorStack.push("[oatpp::xml::Serializer::serialize()]: "
 //                            "UNDEFINED tree node is NOT serializable. To fix: set node value.");
       return;
-    case data::mapping::Tree::Type::NULL_VALUE: state.stream->writeSimple("null", 4); return;
+    case data::mapping::Tree::Type::NULL_VALUE: state.buffer->write("null", 4); return;
 
-    case data::mapping::Tree::Type::INTEGER: state.stream->writeAsString(state.tree->getInteger()); return;
-    case data::mapping::Tree::Type::FLOAT: state.stream->writeAsString(state.tree->getFloat()); return;
+    case data::mapping::Tree::Type::INTEGER: state.buffer->writeAsString(state.tree->getInteger()); return;
+    case data::mapping::Tree::Type::FLOAT: state.buffer->writeAsString(state.tree->getFloat()); return;
 
-    case data::mapping::Tree::Type::BOOL:  state.stream->writeAsString(state.tree->getPrimitive<bool>()); return;
+    case data::mapping::Tree::Type::BOOL:  state.buffer->writeAsString(state.tree->getPrimitive<bool>()); return;
 
-    case data::mapping::Tree::Type::INT_8: state.stream->writeAsString(state.tree->getPrimitive<v_int8>()); return;
-    case data::mapping::Tree::Type::UINT_8: state.stream->writeAsString(state.tree->getPrimitive<v_uint8>()); return;
-    case data::mapping::Tree::Type::INT_16: state.stream->writeAsString(state.tree->getPrimitive<v_int16>()); return;
-    case data::mapping::Tree::Type::UINT_16: state.stream->writeAsString(state.tree->getPrimitive<v_uint16>()); return;
-    case data::mapping::Tree::Type::INT_32: state.stream->writeAsString(state.tree->getPrimitive<v_int32>()); return;
-    case data::mapping::Tree::Type::UINT_32: state.stream->writeAsString(state.tree->getPrimitive<v_uint32>()); return;
-    case data::mapping::Tree::Type::INT_64: state.stream->writeAsString(state.tree->getPrimitive<v_int64>()); return;
-    case data::mapping::Tree::Type::UINT_64: state.stream->writeAsString(state.tree->getPrimitive<v_uint64>()); return;
+    case data::mapping::Tree::Type::INT_8: state.buffer->writeAsString(state.tree->getPrimitive<v_int8>()); return;
+    case data::mapping::Tree::Type::UINT_8: state.buffer->writeAsString(state.tree->getPrimitive<v_uint8>()); return;
+    case data::mapping::Tree::Type::INT_16: state.buffer->writeAsString(state.tree->getPrimitive<v_int16>()); return;
+    case data::mapping::Tree::Type::UINT_16: state.buffer->writeAsString(state.tree->getPrimitive<v_uint16>()); return;
+    case data::mapping::Tree::Type::INT_32: state.buffer->writeAsString(state.tree->getPrimitive<v_int32>()); return;
+    case data::mapping::Tree::Type::UINT_32: state.buffer->writeAsString(state.tree->getPrimitive<v_uint32>()); return;
+    case data::mapping::Tree::Type::INT_64: state.buffer->writeAsString(state.tree->getPrimitive<v_int64>()); return;
+    case data::mapping::Tree::Type::UINT_64: state.buffer->writeAsString(state.tree->getPrimitive<v_uint64>()); return;
 
-    case data::mapping::Tree::Type::FLOAT_32: state.stream->writeAsString(state.tree->getPrimitive<v_float32>()); return;
-    case data::mapping::Tree::Type::FLOAT_64: state.stream->writeAsString(state.tree->getPrimitive<v_float64>()); return;
+    case data::mapping::Tree::Type::FLOAT_32: state.buffer->writeAsString(state.tree->getPrimitive<v_float32>()); return;
+    case data::mapping::Tree::Type::FLOAT_64: state.buffer->writeAsString(state.tree->getPrimitive<v_float64>()); return;
 
     case data::mapping::Tree::Type::STRING: serializeString(state); return;
     case data::mapping::Tree::Type::VECTOR: serializeArray(state); return;
@@ -325,8 +472,46 @@ void Serializer::serialize(oatpp::xml::Serializer::State &state) {
 
   }
 
-  state.errorStack.push("[oatpp::xml::Serializer::serialize()]: Unknown node type");
+  state.error.set(Error::Code::UNKNOWN_NODE_TYPE);
+
+}
+
+Serializer::Context::Context()
+  : m_bufferSize(0)
+{}
+
+char* Serializer::Context::getBuffer(v_buff_size size) {
+  if(m_bufferSize < size) {
+    m_buffer.reset(new char[static_cast<size_t>(size)]);
+    m_bufferSize = size;
+  }
+  return m_buffer.get();
+}
+
+void Serializer::serialize(oatpp::xml::Serializer::State &state) {
+
+  if(state.buffer) {
+    serializeNode(state);
+  } else {
+
+    Context localContext;
+    auto context = state.context ? state.context : &localContext;
 
+    auto bufferSize = state.config->writeBufferSize;
+    WriteBuffer buffer(state.stream, context->getBuffer(bufferSize), bufferSize);
+    state.buffer = &buffer;
+
+    serializeNode(state);
+
+    buffer.flush();
+    state.buffer = nullptr;
+
+  }
+
+  if(state.error.isSet()) {
+    /* render error only once - when it leaves the serializer */
+    state.error.renderTo(state.errorStack, "oatpp::xml::Serializer");
+  }
 }
 
 }}
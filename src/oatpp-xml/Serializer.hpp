@@ -26,15 +26,24 @@
 #ifndef OATPP_XML_SERIALIZER_HPP
 #define OATPP_XML_SERIALIZER_HPP
 
+#include "./Error.hpp"
+#include "./FragmentCache.hpp"
+#include "./SpillSink.hpp"
 #include "./Utils.hpp"
+#include "./WriteBuffer.hpp"
 
 #include "oatpp/data/mapping/ObjectMapper.hpp"
 #include "oatpp/data/mapping/Tree.hpp"
 #include "oatpp/Types.hpp"
 
+#include <functional>
+
 namespace oatpp { namespace xml {
 
+class ObjectSerializer;
+
 class Serializer {
+  friend ObjectSerializer;
 public:
   /**
    * Serializer config.
@@ -66,10 +75,70 @@ public:
      * Escape flags.
      */
     v_uint32 escapeFlags = xml::Utils::FLAG_ESCAPE_STANDARD_ONLY;
+
+    /**
+     * Size of the write-combining buffer. Output is collected in the buffer and written to the stream in blocks of this size.
+     * `0` - no buffering, every fragment is written to the stream right away.
+     */
+    v_buff_size writeBufferSize = 4096;
+
+    /**
+     * Size threshold of the two-pass &id:oatpp::xml::ObjectMapper::writeToString;. <br>
+     * Output up to this size is written in one pass to a reusable scratch buffer and copied to the result string.
+     * Bigger output is measured during the same pass and written again straight to a string allocated once at the exact size -
+     * no reallocations and no final copy. <br>
+     * `0` - disabled, output is collected in a growing &id:oatpp::data::stream::BufferOutputStream;.
+     */
+    v_buff_size twoPassThreshold = 0;
+
+    /**
+     * Cache of serialized fragments - `!FRAGMENT` nodes and &id:oatpp::xml::Fragment; values. `nullptr` - fragments are serialized every time. <br>
+     * Cached bytes are keyed by the options above, so changed options never get bytes rendered with the old ones.
+     * See &id:oatpp::xml::FragmentCache;.
+     */
+    std::shared_ptr<FragmentCache> fragmentCache;
+
+    /**
+     * Sink to read the content of `!SPILL` nodes from - see &id:oatpp::xml::Deserializer::Config::spillThreshold;. <br>
+     * The content is read back with &id:oatpp::xml::SpillSink::read; and written as escaped text.
+     * `nullptr` - &id:oatpp::xml::FileSpillSink::getDefault;.
+     */
+    std::shared_ptr<SpillSink> spillSink;
+  };
+
+public:
+
+  /**
+   * Reusable serializer context. <br>
+   * Keeps the write buffer memory between &l:Serializer::serialize (); calls. <br>
+   * Context is NOT thread-safe - use one context per thread.
+   */
+  class Context {
+  private:
+    std::unique_ptr<char[]> m_buffer;
+    v_buff_size m_bufferSize;
+  public:
+
+    /**
+     * Constructor.
+     */
+    Context();
+
+    /**
+     * Get buffer memory of at least `size` bytes. Memory is reallocated only if the requested size grows.
+     * @param size
+     * @return
+     */
+    char* getBuffer(v_buff_size size);
+
   };
 
 public:
 
+  /**
+   * Serializer state. <br>
+   * Errors are recorded to `error` and rendered to `errorStack` by &l:Serializer::serialize (); once serialization failed.
+   */
   struct State {
 
     const Config* config;
@@ -77,22 +146,38 @@ public:
     data::stream::ConsistentOutputStream* stream;
 
     data::mapping::ErrorStack errorStack;
+    Error error;
+
+    Context* context = nullptr;
+
+    /**
+     * Output buffer. If not set by the caller, &l:Serializer::serialize (); sets it to a buffer over `stream`
+     * for the duration of the call. <br>
+     * Set it to a &id:oatpp::xml::WriteBuffer; without a stream to write to memory or to measure the output size.
+     */
+    WriteBuffer* buffer = nullptr;
 
   };
 
 private:
   static void startNode(const oatpp::String& name, State& state);
   static void endNode(const oatpp::String& name, State& state);
+  static FragmentCache::OutputKey getOutputKey(const Config& config);
+  static void writeFragment(State& state, const oatpp::String& id, v_uint64 version, const FragmentCache::OutputKey& outputKey, const std::function<void()>& render);
 private:
 
   static void serializeCData(State& state);
   static void serializeComment(State& state);
+  static void serializeBase64(State& state);
+  static void serializeFragment(State& state);
+  static void serializeSpill(State& state);
   static void serializePINode(State& state, const oatpp::String& key);
   static bool serializeSpecial(State& state, const oatpp::String& key);
   static void serializeString(State& state);
   static void serializeArray(State& state);
   static void serializeMap(State& state);
   static void serializePairs(State& state);
+  static void serializeNode(State& state);
 
 public:
 
@@ -0,0 +1,71 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "SpillSink.hpp"
+
+#include "oatpp/data/stream/FileStream.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <random>
+
+namespace oatpp { namespace xml {
+
+std::shared_ptr<data::stream::InputStream> SpillSink::read(const oatpp::String& handle) {
+  (void) handle;
+  return nullptr;
+}
+
+FileSpillSink::FileSpillSink(const oatpp::String& directory)
+  : m_directory(directory)
+  , m_counter(0)
+{
+
+  if(!m_directory) {
+    m_directory = std::filesystem::temp_directory_path().string();
+  }
+
+  /* file names must not clash with other processes using the same directory */
+  std::random_device device;
+  std::mt19937_64 random(device() ^ static_cast<v_uint64>(std::chrono::steady_clock::now().time_since_epoch().count()));
+  m_prefix = "oatpp-xml-spill-" + std::to_string(random()) + "-";
+
+}
+
+std::shared_ptr<data::stream::OutputStream> FileSpillSink::open(oatpp::String& handle) {
+  auto path = std::filesystem::path(*m_directory) / (*m_prefix + std::to_string(m_counter ++));
+  handle = path.string();
+  return std::make_shared<data::stream::FileOutputStream>(handle->c_str(), "wb");
+}
+
+std::shared_ptr<data::stream::InputStream> FileSpillSink::read(const oatpp::String& handle) {
+  return std::make_shared<data::stream::FileInputStream>(handle->c_str());
+}
+
+const std::shared_ptr<SpillSink>& FileSpillSink::getDefault() {
+  static const std::shared_ptr<SpillSink> sink = std::make_shared<FileSpillSink>();
+  return sink;
+}
+
+}}
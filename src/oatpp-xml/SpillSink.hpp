@@ -0,0 +1,99 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_SPILLSINK_HPP
+#define OATPP_XML_SPILLSINK_HPP
+
+#include "oatpp/data/stream/Stream.hpp"
+#include "oatpp/Types.hpp"
+
+#include <atomic>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Destination for oversized text and CDATA content. <br>
+ * See &id:oatpp::xml::Deserializer::Config::spillThreshold;.
+ * The tree gets a `!SPILL` node with the content handle instead of the content itself.
+ * The serializer reads the content back through &l:SpillSink::read ();.
+ */
+class SpillSink {
+public:
+
+  /**
+   * Default virtual destructor.
+   */
+  virtual ~SpillSink() = default;
+
+  /**
+   * Open output for a piece of content. <br>
+   * Called from the parsing thread - implementation must be thread-safe if the sink is shared between parsers.
+   * @param handle - out. Handle of the content to put to the tree, ex.: file path.
+   * @return - stream to write the content to. The content is complete once the stream is released.
+   * May throw - the error is reported as &id:oatpp::xml::Error::Code::SPILL_FAILED;.
+   */
+  virtual std::shared_ptr<data::stream::OutputStream> open(oatpp::String& handle) = 0;
+
+  /**
+   * Open previously written content for reading. <br>
+   * Used by the serializer to write `!SPILL` nodes back - see &id:oatpp::xml::Serializer::Config::spillSink;.
+   * @param handle - content handle.
+   * @return - stream to read the content from. Default implementation returns `nullptr` - content can't be read back.
+   * May throw - the error is reported as &id:oatpp::xml::Error::Code::SPILL_FAILED;.
+   */
+  virtual std::shared_ptr<data::stream::InputStream> read(const oatpp::String& handle);
+
+};
+
+/**
+ * Spill sink writing each piece of content to a new file. The handle is the file path. <br>
+ * Files are not removed by the sink - the application owns them once the document is parsed.
+ */
+class FileSpillSink : public SpillSink {
+private:
+  oatpp::String m_directory;
+  oatpp::String m_prefix;
+  std::atomic<v_uint64> m_counter;
+public:
+
+  /**
+   * Constructor.
+   * @param directory - directory for the files. `nullptr` - system temp directory.
+   */
+  explicit FileSpillSink(const oatpp::String& directory = nullptr);
+
+  std::shared_ptr<data::stream::OutputStream> open(oatpp::String& handle) override;
+  std::shared_ptr<data::stream::InputStream> read(const oatpp::String& handle) override;
+
+  /**
+   * Get shared sink writing to the system temp directory.
+   * @return
+   */
+  static const std::shared_ptr<SpillSink>& getDefault();
+
+};
+
+}}
+
+#endif //OATPP_XML_SPILLSINK_HPP
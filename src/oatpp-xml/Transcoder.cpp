@@ -0,0 +1,399 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Transcoder.hpp"
+
+#include "./Scanner.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define OATPP_XML_TRANSCODER_SSE2
+  #include <emmintrin.h>
+#endif
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/* block buffer in front of the output stream - keeps stream calls off the per-char path */
+class Output {
+private:
+  data::stream::ConsistentOutputStream* m_stream;
+  char m_buffer[Transcoder::BUFFER_SIZE];
+  v_buff_size m_size;
+public:
+
+  explicit Output(data::stream::ConsistentOutputStream* stream)
+    : m_stream(stream)
+    , m_size(0)
+  {}
+
+  char* reserve(v_buff_size size) {
+    if(m_size + size > Transcoder::BUFFER_SIZE) {
+      flush();
+    }
+    return m_buffer + m_size;
+  }
+
+  void commit(v_buff_size size) {
+    m_size += size;
+  }
+
+  void write(const char* data, v_buff_size size) {
+    if(size > Transcoder::BUFFER_SIZE / 4) {
+      flush();
+      m_stream->writeSimple(data, size);
+      return;
+    }
+    std::memcpy(reserve(size), data, static_cast<size_t>(size));
+    m_size += size;
+  }
+
+  void flush() {
+    if(m_size > 0) {
+      m_stream->writeSimple(m_buffer, m_size);
+      m_size = 0;
+    }
+  }
+
+};
+
+inline v_buff_size encodeUtf8(v_uint32 code, char* out) {
+  if(code < 0x80) {
+    out[0] = static_cast<char>(code);
+    return 1;
+  }
+  if(code < 0x800) {
+    out[0] = static_cast<char>(0xC0 | (code >> 6));
+    out[1] = static_cast<char>(0x80 | (code & 0x3F));
+    return 2;
+  }
+  if(code < 0x10000) {
+    out[0] = static_cast<char>(0xE0 | (code >> 12));
+    out[1] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+    out[2] = static_cast<char>(0x80 | (code & 0x3F));
+    return 3;
+  }
+  out[0] = static_cast<char>(0xF0 | (code >> 18));
+  out[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+  out[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+  out[3] = static_cast<char>(0x80 | (code & 0x3F));
+  return 4;
+}
+
+bool equalsIgnoreCase(const char* a, v_buff_size size, const char* b) {
+  for(v_buff_size i = 0; i < size; i ++) {
+    auto c = a[i];
+    if(c >= 'a' && c <= 'z') {
+      c = static_cast<char>(c - 'a' + 'A');
+    }
+    if(b[i] == 0 || c != b[i]) {
+      return false;
+    }
+  }
+  return b[size] == 0;
+}
+
+bool isBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+}
+
+Transcoder::Transcoder(Encoding encoding)
+  : m_encoding(encoding)
+  , m_offset(0)
+  , m_highSurrogate(0)
+  , m_pendingByte(-1)
+{}
+
+Transcoder::Encoding Transcoder::detect(const char* data, v_buff_size size, v_buff_size& bomSize) {
+
+  auto bytes = reinterpret_cast<const v_uint8*>(data);
+  bomSize = 0;
+
+  if(size >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+    bomSize = 3;
+    return Encoding::UTF_8;
+  }
+  if(size >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE) {
+    bomSize = 2;
+    return Encoding::UTF_16LE;
+  }
+  if(size >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF) {
+    bomSize = 2;
+    return Encoding::UTF_16BE;
+  }
+
+  /* document starts with an ASCII char - its zero byte gives UTF-16 away */
+  if(size >= 2 && bytes[0] != 0 && bytes[1] == 0) {
+    return Encoding::UTF_16LE;
+  }
+  if(size >= 2 && bytes[0] == 0 && bytes[1] != 0) {
+    return Encoding::UTF_16BE;
+  }
+
+  if(size < 6 || std::memcmp(data, "<?xml", 5) != 0 || !isBlank(data[5])) {
+    return Encoding::UTF_8;
+  }
+
+  /* malformed declaration is left for the parser to report */
+  auto end = Scanner::findText(data, size, "?>", 2);
+  if(end < 0) {
+    return Encoding::UTF_8;
+  }
+  auto i = Scanner::findText(data, end, "encoding", 8);
+  if(i < 0) {
+    return Encoding::UTF_8;
+  }
+
+  i += 8;
+  while(i < end && isBlank(data[i])) i ++;
+  if(i == end || data[i] != '=') {
+    return Encoding::UTF_8;
+  }
+  i ++;
+  while(i < end && isBlank(data[i])) i ++;
+  if(i == end || (data[i] != '"' && data[i] != '\'')) {
+    return Encoding::UTF_8;
+  }
+
+  auto quote = data[i ++];
+  auto nameStart = i;
+  while(i < end && data[i] != quote) i ++;
+
+  auto encoding = getEncodingByName(data + nameStart, i - nameStart);
+  /* declaration was just read as 8-bit text - it can't be UTF-16 */
+  if(encoding == Encoding::UTF_16LE || encoding == Encoding::UTF_16BE) {
+    return Encoding::UNKNOWN;
+  }
+  return encoding;
+
+}
+
+Transcoder::Encoding Transcoder::getEncodingByName(const char* name, v_buff_size size) {
+
+  static const struct {
+    const char* name;
+    Encoding encoding;
+  } names[] = {
+    {"UTF-8", Encoding::UTF_8},
+    {"UTF8", Encoding::UTF_8},
+    {"US-ASCII", Encoding::UTF_8},
+    {"ASCII", Encoding::UTF_8},
+    {"UTF-16LE", Encoding::UTF_16LE},
+    {"UTF-16BE", Encoding::UTF_16BE},
+    {"ISO-8859-1", Encoding::ISO_8859_1},
+    {"ISO8859-1", Encoding::ISO_8859_1},
+    {"ISO_8859-1", Encoding::ISO_8859_1},
+    {"LATIN1", Encoding::ISO_8859_1},
+    {"L1", Encoding::ISO_8859_1}
+  };
+
+  for(const auto& entry : names) {
+    if(equalsIgnoreCase(name, size, entry.name)) {
+      return entry.encoding;
+    }
+  }
+
+  return Encoding::UNKNOWN;
+
+}
+
+bool Transcoder::transcodeUtf16(const char* data, v_buff_size size, data::stream::ConsistentOutputStream* stream) {
+
+  bool bigEndian = m_encoding == Encoding::UTF_16BE;
+  auto bytes = reinterpret_cast<const v_uint8*>(data);
+  Output output(stream);
+
+  /* position - offset of the code unit in the input */
+  auto put = [&](v_uint32 unit, v_buff_size position) {
+    if(m_highSurrogate != 0) {
+      if(unit < 0xDC00 || unit > 0xDFFF) {
+        m_error.set(Error::Code::INVALID_CHARACTER, position - 2);
+        return false;
+      }
+      auto code = 0x10000 + ((m_highSurrogate - 0xD800) << 10) + (unit - 0xDC00);
+      m_highSurrogate = 0;
+      output.commit(encodeUtf8(code, output.reserve(4)));
+      return true;
+    }
+    if(unit >= 0xD800 && unit <= 0xDBFF) {
+      m_highSurrogate = unit;
+      return true;
+    }
+    if(unit >= 0xDC00 && unit <= 0xDFFF) {
+      m_error.set(Error::Code::INVALID_CHARACTER, position);
+      return false;
+    }
+    output.commit(encodeUtf8(unit, output.reserve(3)));
+    return true;
+  };
+
+  v_buff_size i = 0;
+
+  /* code unit split by the previous piece */
+  if(m_pendingByte >= 0 && size > 0) {
+    auto pending = static_cast<v_uint32>(m_pendingByte);
+    auto unit = bigEndian ? (pending << 8) | bytes[0] : pending | (static_cast<v_uint32>(bytes[0]) << 8);
+    m_pendingByte = -1;
+    if(!put(unit, m_offset - 1)) {
+      output.flush();
+      return false;
+    }
+    i = 1;
+  }
+
+  bool ascii = true;
+  while(size - i >= 2) {
+
+#if defined(OATPP_XML_TRANSCODER_SSE2)
+    /* 8 ASCII code units at a time - vector mode is retried only after an ASCII char */
+    if(ascii && m_highSurrogate == 0) {
+      while(size - i >= 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if(bigEndian) {
+          block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+        }
+        auto high = _mm_and_si128(block, _mm_set1_epi16(static_cast<short>(0xFF80)));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF) {
+          break;
+        }
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output.reserve(8)), _mm_packus_epi16(block, block));
+        output.commit(8);
+        i += 16;
+      }
+      if(size - i < 2) {
+        break;
+      }
+    }
+#endif
+
+    auto unit = bigEndian ?
+                (static_cast<v_uint32>(bytes[i]) << 8) | bytes[i + 1] :
+                bytes[i] | (static_cast<v_uint32>(bytes[i + 1]) << 8);
+    if(!put(unit, m_offset + i)) {
+      output.flush();
+      return false;
+    }
+    ascii = unit < 0x80;
+    i += 2;
+
+  }
+
+  if(i < size) {
+    m_pendingByte = bytes[i];
+  }
+
+  output.flush();
+  return true;
+
+}
+
+void Transcoder::transcodeLatin1(const char* data, v_buff_size size, data::stream::ConsistentOutputStream* stream) {
+
+  Output output(stream);
+  v_buff_size i = 0;
+
+  while(i < size) {
+
+    /* ASCII run is written as-is */
+    auto runStart = i;
+#if defined(OATPP_XML_TRANSCODER_SSE2)
+    while(size - i >= 16 && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))) == 0) {
+      i += 16;
+    }
+#endif
+    while(i < size && static_cast<v_uint8>(data[i]) < 0x80) {
+      i ++;
+    }
+    if(i > runStart) {
+      output.write(data + runStart, i - runStart);
+    }
+
+    while(i < size && static_cast<v_uint8>(data[i]) >= 0x80) {
+      output.commit(encodeUtf8(static_cast<v_uint8>(data[i]), output.reserve(2)));
+      i ++;
+    }
+
+  }
+
+  output.flush();
+
+}
+
+bool Transcoder::transcode(const char* data, v_buff_size size, data::stream::ConsistentOutputStream* stream) {
+
+  if(m_error.isSet()) {
+    return false;
+  }
+
+  switch(m_encoding) {
+
+    case Encoding::UTF_16LE:
+    case Encoding::UTF_16BE:
+      if(!transcodeUtf16(data, size, stream)) {
+        return false;
+      }
+      break;
+
+    case Encoding::ISO_8859_1:
+      transcodeLatin1(data, size, stream);
+      break;
+
+    default:
+      stream->writeSimple(data, size);
+
+  }
+
+  m_offset += size;
+  return true;
+
+}
+
+bool Transcoder::finish() {
+  if(m_error.isSet()) {
+    return false;
+  }
+  if(m_pendingByte >= 0) {
+    m_error.set(Error::Code::INVALID_CHARACTER, m_offset - 1);
+    return false;
+  }
+  if(m_highSurrogate != 0) {
+    m_error.set(Error::Code::INVALID_CHARACTER, m_offset - 2);
+    return false;
+  }
+  return true;
+}
+
+const Error& Transcoder::getError() const {
+  return m_error;
+}
+
+Transcoder::Encoding Transcoder::getEncoding() const {
+  return m_encoding;
+}
+
+}}
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_TRANSCODER_HPP
+#define OATPP_XML_TRANSCODER_HPP
+
+#include "./Error.hpp"
+
+#include "oatpp/data/stream/Stream.hpp"
+#include "oatpp/Types.hpp"
+
+namespace oatpp { namespace xml {
+
+/**
+ * Streaming transcoder of UTF-16LE, UTF-16BE and ISO-8859-1 input to UTF-8. <br>
+ * Data is fed in pieces of any size - a code unit or a surrogate pair split between pieces is completed by the next piece.
+ * Output is written to the stream through a small block buffer, so the input never has to be kept in memory as a whole. <br>
+ * On SSE2 targets ASCII runs are converted 16 bytes at a time. <br>
+ * Transcoder is NOT thread-safe.
+ */
+class Transcoder {
+public:
+
+  /**
+   * Input encoding.
+   */
+  enum class Encoding : v_int32 {
+
+    /**
+     * Encoding is declared but not supported.
+     */
+    UNKNOWN = 0,
+
+    /**
+     * UTF-8 and its subsets (US-ASCII). Passed through as-is.
+     */
+    UTF_8 = 1,
+
+    UTF_16LE = 2,
+    UTF_16BE = 3,
+    ISO_8859_1 = 4
+
+  };
+
+  /**
+   * Size of the output block buffer.
+   */
+  static constexpr v_buff_size BUFFER_SIZE = 4096;
+
+private:
+  Encoding m_encoding;
+  v_buff_size m_offset;
+  v_uint32 m_highSurrogate;
+  v_int32 m_pendingByte;
+  Error m_error;
+private:
+  bool transcodeUtf16(const char* data, v_buff_size size, data::stream::ConsistentOutputStream* stream);
+  void transcodeLatin1(const char* data, v_buff_size size, data::stream::ConsistentOutputStream* stream);
+public:
+
+  /**
+   * Constructor.
+   * @param encoding - input encoding. Must not be `UNKNOWN`.
+   */
+  Transcoder(Encoding encoding);
+
+  /**
+   * Detect encoding of a document. <br>
+   * Checks the byte order mark, then the byte pattern of the first chars (UTF-16 without BOM),
+   * then the `encoding` of the `<?xml ...?>` declaration. Documents without BOM and declaration are UTF-8.
+   * @param data - start of the document.
+   * @param size - size of the data.
+   * @param bomSize - out size of the byte order mark to skip.
+   * @return - &l:Transcoder::Encoding;.
+   */
+  static Encoding detect(const char* data, v_buff_size size, v_buff_size& bomSize);
+
+  /**
+   * Get encoding by its name - case-insensitive, ex.: `UTF-8`, `iso-8859-1`, `latin1`.
+   * @param name
+   * @param size
+   * @return - &l:Transcoder::Encoding;. `UNKNOWN` if not supported.
+   */
+  static Encoding getEncodingByName(const char* name, v_buff_size size);
+
+  /**
+   * Transcode next piece of the input.
+   * @param data
+   * @param size
+   * @param stream - stream to write UTF-8 to.
+   * @return - `false` if input is invalid - see &l:Transcoder::getError ();.
+   */
+  bool transcode(const char* data, v_buff_size size, data::stream::ConsistentOutputStream* stream);
+
+  /**
+   * Check that input ended on a char boundary.
+   * @return - `false` if the last char is incomplete - see &l:Transcoder::getError ();.
+   */
+  bool finish();
+
+  /**
+   * Get transcoding error. Error position is the offset in the input. <br>
+   * `INVALID_CHARACTER` - unpaired UTF-16 surrogate or incomplete last char.
+   * @return - &id:oatpp::xml::Error;.
+   */
+  const Error& getError() const;
+
+  Encoding getEncoding() const;
+
+};
+
+}}
+
+#endif //OATPP_XML_TRANSCODER_HPP
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_TYPECACHE_HPP
+#define OATPP_XML_TYPECACHE_HPP
+
+#include "oatpp/Types.hpp"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Cache of values computed once per type, ex.: pre-rendered DTO field tags. <br>
+ * Readers look up an immutable snapshot of the type map with a single atomic load - no locks.
+ * On a miss the value is built and a new snapshot is published under the mutex. <br>
+ * Old snapshots are kept until the cache is destroyed, so readers never see freed memory.
+ * The number of types is small and fixed, so is the memory kept.
+ * @tparam V - value type.
+ */
+template<class V>
+class TypeCache {
+private:
+  typedef std::unordered_map<const data::type::Type*, const V*> Map;
+private:
+  mutable std::atomic<const Map*> m_map;
+  mutable std::mutex m_mutex;
+  mutable std::list<V> m_values;
+  mutable std::list<Map> m_maps;
+private:
+
+  template<class Builder>
+  const V& add(const data::type::Type* type, Builder&& builder) const {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto& current = *m_map.load(std::memory_order_relaxed);
+    auto it = current.find(type);
+    if(it != current.end()) {
+      return *it->second;
+    }
+
+    m_values.emplace_back(builder(type));
+    auto& value = m_values.back();
+
+    m_maps.push_back(current);
+    auto& map = m_maps.back();
+    map[type] = &value;
+    m_map.store(&map, std::memory_order_release);
+
+    return value;
+
+  }
+
+public:
+
+  TypeCache() {
+    m_maps.emplace_back();
+    m_map.store(&m_maps.back(), std::memory_order_release);
+  }
+
+  TypeCache(const TypeCache&) = delete;
+  TypeCache& operator=(const TypeCache&) = delete;
+
+  /**
+   * Get value for the type. Build it on the first call.
+   * @param type - type.
+   * @param builder - `V(const data::type::Type*)` - called under the cache mutex. Must not access this cache.
+   * @return
+   */
+  template<class Builder>
+  const V& get(const data::type::Type* type, Builder&& builder) const {
+    auto map = m_map.load(std::memory_order_acquire);
+    auto it = map->find(type);
+    if(it != map->end()) {
+      return *it->second;
+    }
+    return add(type, std::forward<Builder>(builder));
+  }
+
+};
+
+}}
+
+#endif //OATPP_XML_TYPECACHE_HPP
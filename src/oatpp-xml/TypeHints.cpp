@@ -0,0 +1,108 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "TypeHints.hpp"
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+data::mapping::Tree::Type getLeafType(const data::type::ClassId& classId) {
+
+  namespace c = data::type::__class;
+  typedef data::mapping::Tree::Type TreeType;
+
+  auto id = classId.id;
+
+  if(id == c::Int8::CLASS_ID.id) return TreeType::INT_8;
+  if(id == c::UInt8::CLASS_ID.id) return TreeType::UINT_8;
+  if(id == c::Int16::CLASS_ID.id) return TreeType::INT_16;
+  if(id == c::UInt16::CLASS_ID.id) return TreeType::UINT_16;
+  if(id == c::Int32::CLASS_ID.id) return TreeType::INT_32;
+  if(id == c::UInt32::CLASS_ID.id) return TreeType::UINT_32;
+  if(id == c::Int64::CLASS_ID.id) return TreeType::INT_64;
+  if(id == c::UInt64::CLASS_ID.id) return TreeType::UINT_64;
+  if(id == c::Float32::CLASS_ID.id) return TreeType::FLOAT_32;
+  if(id == c::Float64::CLASS_ID.id) return TreeType::FLOAT_64;
+  if(id == c::Boolean::CLASS_ID.id) return TreeType::BOOL;
+
+  return TreeType::UNDEFINED;
+
+}
+
+}
+
+TypeHints::TypeHints(const data::type::Type* type) {
+  std::unordered_map<const data::type::Type*, const Node*> built;
+  m_root = build(type, built);
+}
+
+const TypeHints::Node* TypeHints::build(const data::type::Type* type, std::unordered_map<const data::type::Type*, const Node*>& built) {
+
+  if(type == nullptr) {
+    return nullptr;
+  }
+
+  /* DTOs may refer to themselves */
+  auto it = built.find(type);
+  if(it != built.end()) {
+    return it->second;
+  }
+
+  m_nodes.emplace_back();
+  auto& node = m_nodes.back();
+  built[type] = &node;
+
+  namespace c = data::type::__class;
+  auto id = type->classId.id;
+
+  if(id == c::AbstractObject::CLASS_ID.id) {
+    auto dispatcher = static_cast<const c::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+    std::vector<std::pair<std::string, const Node*>> children;
+    for(auto const& field : dispatcher->getProperties()->getList()) {
+      auto child = build(field->type, built);
+      if(child) {
+        children.emplace_back(field->name, child);
+      }
+    }
+    /* hints are built once per type and cached by the object mapper */
+    node.m_children = NameTable<const Node*>(children);
+  } else if(id == c::AbstractVector::CLASS_ID.id || id == c::AbstractList::CLASS_ID.id || id == c::AbstractUnorderedSet::CLASS_ID.id) {
+    /* any child element is a collection item */
+    node.m_anyChild = build(type->params.front(), built);
+  } else if(id == c::AbstractPairList::CLASS_ID.id || id == c::AbstractUnorderedMap::CLASS_ID.id) {
+    /* any child element is a map value */
+    node.m_anyChild = build(type->params.back(), built);
+  } else if(id == __class::Binary::CLASS_ID.id) {
+    node.m_binary = true;
+    m_hasBinary = true;
+  } else {
+    node.m_leafType = getLeafType(type->classId);
+  }
+
+  return &node;
+
+}
+
+}}
@@ -0,0 +1,134 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_TYPEHINTS_HPP
+#define OATPP_XML_TYPEHINTS_HPP
+
+#include "./NameTable.hpp"
+#include "./Types.hpp"
+
+#include "oatpp/data/mapping/Tree.hpp"
+#include "oatpp/Types.hpp"
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Expected leaf types of a document, derived from the target DTO type. <br>
+ * Lets the &id:oatpp::xml::Deserializer; parse numeric and boolean leaf text straight into typed tree values
+ * when the target type is known. See &id:oatpp::xml::Deserializer::Config::parseTypedLeaves;.
+ */
+class TypeHints {
+public:
+
+  /**
+   * Hints of an element.
+   */
+  class Node {
+    friend TypeHints;
+  private:
+    data::mapping::Tree::Type m_leafType = data::mapping::Tree::Type::UNDEFINED;
+    NameTable<const Node*> m_children;
+    const Node* m_anyChild = nullptr;
+    bool m_binary = false;
+  public:
+
+    /**
+     * Expected type of the element text. `UNDEFINED` - not a numeric or boolean leaf.
+     * @return
+     */
+    data::mapping::Tree::Type getLeafType() const {
+      return m_leafType;
+    }
+
+    /**
+     * Element text is base64 binary data - see &id:oatpp::xml::Binary;.
+     * @return
+     */
+    bool isBinary() const {
+      return m_binary;
+    }
+
+    /**
+     * Get hints of a child element. <br>
+     * DTO fields are resolved with a per-type &id:oatpp::xml::NameTable; - one probe, no hashing of the whole name.
+     * @param name - child element name.
+     * @return - child hints or `nullptr` if nothing is known about the child.
+     */
+    const Node* getChild(const oatpp::String& name) const {
+      if(m_anyChild) {
+        return m_anyChild;
+      }
+      auto child = m_children.find(*name);
+      return child ? *child : nullptr;
+    }
+
+  };
+
+private:
+  std::deque<Node> m_nodes;
+  const Node* m_root;
+  bool m_hasBinary = false;
+private:
+  const Node* build(const data::type::Type* type, std::unordered_map<const data::type::Type*, const Node*>& built);
+public:
+
+  /**
+   * Constructor.
+   * @param type - type of the document root - its fields are the top-level elements.
+   */
+  explicit TypeHints(const data::type::Type* type);
+
+  /**
+   * Non-copyable - nodes point to each other. Movable - moved nodes keep their addresses.
+   */
+  TypeHints(const TypeHints&) = delete;
+  TypeHints& operator=(const TypeHints&) = delete;
+  TypeHints(TypeHints&&) = default;
+
+  /**
+   * Get hints of the document root.
+   * @return
+   */
+  const Node* getRoot() const {
+    return m_root;
+  }
+
+  /**
+   * Check if the type has binary fields.
+   * @return
+   */
+  bool hasBinary() const {
+    return m_hasBinary;
+  }
+
+};
+
+}}
+
+#endif //OATPP_XML_TYPEHINTS_HPP
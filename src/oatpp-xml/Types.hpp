@@ -0,0 +1,141 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_TYPES_HPP
+#define OATPP_XML_TYPES_HPP
+
+#include "oatpp/Types.hpp"
+
+namespace oatpp { namespace xml {
+
+namespace __class {
+
+/**
+ * Binary class.
+ */
+class Binary {
+public:
+
+  /**
+   * Class id.
+   */
+  static const data::type::ClassId CLASS_ID;
+
+  static data::type::Type* getType();
+
+};
+
+/**
+ * Fragment class.
+ */
+class Fragment {
+public:
+
+  /**
+   * Class id.
+   */
+  static const data::type::ClassId CLASS_ID;
+
+  static data::type::Type* getType();
+
+};
+
+}
+
+/**
+ * Binary data - written to XML as base64 element text. <br>
+ * Use it as a DTO field type for binary attachments: `DTO_FIELD(oatpp::xml::Binary, attachment);`. <br>
+ * In the &id:oatpp::data::mapping::Tree; binary data is a single `!BASE64` node with raw bytes as its string value.
+ */
+class Binary : public data::type::ObjectWrapper<std::string, __class::Binary> {
+public:
+
+  Binary() = default;
+
+  Binary(std::nullptr_t) {}
+
+  Binary(const std::shared_ptr<std::string>& ptr)
+    : data::type::ObjectWrapper<std::string, __class::Binary>(ptr)
+  {}
+
+  Binary(std::string&& data)
+    : data::type::ObjectWrapper<std::string, __class::Binary>(std::make_shared<std::string>(std::move(data)))
+  {}
+
+  Binary(const void* data, v_buff_size size)
+    : data::type::ObjectWrapper<std::string, __class::Binary>(
+        std::make_shared<std::string>(static_cast<const char*>(data), static_cast<size_t>(size)))
+  {}
+
+};
+
+/**
+ * Content of a &l:Fragment;.
+ */
+struct FragmentData {
+
+  /**
+   * Fragment id.
+   */
+  oatpp::String id;
+
+  /**
+   * Fragment version - change it once the value changes.
+   */
+  v_uint64 version;
+
+  /**
+   * Value - DTO, collection or any other mappable value.
+   */
+  oatpp::Void value;
+
+};
+
+/**
+ * Cacheable value - its serialized XML is memoized in the &id:oatpp::xml::FragmentCache; by id and version. <br>
+ * Use it as a DTO field type for big values which are the same in many responses:
+ * `DTO_FIELD(oatpp::xml::Fragment, catalog);`. The value is written as the element content, as if it was the field value.
+ * In the &id:oatpp::data::mapping::Tree; a fragment is a single `!FRAGMENT` node with `id` and `version` attributes. <br>
+ * *Note: fragments are write-only - they are not deserialized.*
+ */
+class Fragment : public data::type::ObjectWrapper<FragmentData, __class::Fragment> {
+public:
+
+  Fragment() = default;
+
+  Fragment(std::nullptr_t) {}
+
+  Fragment(const std::shared_ptr<FragmentData>& ptr)
+    : data::type::ObjectWrapper<FragmentData, __class::Fragment>(ptr)
+  {}
+
+  Fragment(const oatpp::String& id, v_uint64 version, const oatpp::Void& value)
+    : data::type::ObjectWrapper<FragmentData, __class::Fragment>(std::make_shared<FragmentData>(FragmentData{id, version, value}))
+  {}
+
+};
+
+}}
+
+#endif //OATPP_XML_TYPES_HPP
@@ -30,6 +30,7 @@
 #include "oatpp/utils/Conversion.hpp"
 
 #include <cstdlib>
+#include <cstring>
 
 namespace oatpp { namespace xml {
 
@@ -76,7 +77,7 @@ v_uint32 Utils::escapeChar(data::stream::ConsistentOutputStream* stream,
   }
 }
 
-bool Utils::unescapeChar(data::stream::ConsistentOutputStream* stream, const data::share::StringKeyLabel& charRef) {
+bool Utils::unescapeChar(data::stream::OutputStream* stream, const data::share::StringKeyLabel& charRef) {
 
   auto data = static_cast<const v_char8*>(charRef.getData());
   auto dataSize = charRef.getSize();
@@ -130,69 +131,171 @@ bool Utils::unescapeChar(data::stream::ConsistentOutputStream* stream, const dat
 
 }
 
-oatpp::String Utils::escapeAttributeText(const oatpp::String& text, char enclosingChar, data::mapping::ErrorStack& errorStack) {
+v_buff_size Utils::escapeNextChar(const char* text, v_buff_size textSize, char* escaped, v_buff_size& escapedSize) {
 
-  if(text == nullptr) {
-    return "";
+  auto c = static_cast<v_char8>(*text);
+
+  const char* entity = nullptr;
+  switch (c) {
+    case '&': entity = "&amp;"; break;
+    case '<': entity = "&lt;"; break;
+    case '>': entity = "&gt;"; break;
+    case '"': entity = "&quot;"; break;
+    case '\'': entity = "&apos;"; break;
+    default:
+      break;
   }
 
-  data::stream::BufferOutputStream ss(256);
+  if(entity) {
+    escapedSize = static_cast<v_buff_size>(std::strlen(entity));
+    std::memcpy(escaped, entity, static_cast<size_t>(escapedSize));
+    return 1;
+  }
 
-  auto data = text->data();
+  if(c >= 32 && c < 128) {
+    escaped[0] = static_cast<char>(c);
+    escapedSize = 1;
+    return 1;
+  }
 
-  v_buff_usize i = 0;
-  while(i < text->size()) {
+  auto charLength = encoding::Unicode::getUtf8CharSequenceLength(c);
+  if(charLength <= 0 || textSize < charLength) {
+    return 0;
+  }
 
-    auto c = data[i];
+  auto code = static_cast<v_uint32>(encoding::Unicode::encodeUtf8Char(text, charLength));
 
-    switch (c) {
-      case '"': {
-        if(enclosingChar == '"') {
-          ss.writeSimple("&quot;", 6);
-        } else if(enclosingChar == '\'') {
-          ss.writeSimple("\"", 1);
-        }
-        i ++;
-        break;
+  /* &#<decimal code>; */
+  char digits[16];
+  v_buff_size digitsCount = 0;
+  do {
+    digits[digitsCount ++] = static_cast<char>('0' + code % 10);
+    code /= 10;
+  } while(code > 0);
+
+  escaped[0] = '&';
+  escaped[1] = '#';
+  for(v_buff_size i = 0; i < digitsCount; i ++) {
+    escaped[2 + i] = digits[digitsCount - 1 - i];
+  }
+  escaped[2 + digitsCount] = ';';
+  escapedSize = digitsCount + 3;
+
+  return charLength;
+
+}
+
+v_buff_size Utils::getEscapedTextSize(const char* text, v_buff_size textSize, char enclosingChar) {
+
+  v_buff_size result = 0;
+
+  v_buff_size i = 0;
+  while(i < textSize) {
+
+    auto runSize = getPlainTextLength(&text[i], textSize - i, enclosingChar);
+    result += runSize;
+    i += runSize;
+
+    if(i < textSize) {
+
+      auto c = static_cast<v_char8>(text[i]);
+      switch (c) {
+        case '&': result += 5; i ++; continue;
+        case '<':
+        case '>': result += 4; i ++; continue;
+        case '"':
+        case '\'': result += 6; i ++; continue;
+        default:
+          break;
       }
-      case '\'': {
-        if(enclosingChar == '\'') {
-          ss.writeSimple("&apos;", 6);
-        } else if(enclosingChar == '"') {
-          ss.writeSimple("'", 1);
-        }
-        i ++;
-        break;
+
+      auto charLength = encoding::Unicode::getUtf8CharSequenceLength(c);
+      if(charLength <= 0 || textSize - i < charLength) {
+        return -1;
       }
-      default:
-        i += escapeChar(&ss, &data[i], text->size() - i, errorStack);
-        if(!errorStack.empty()) {
-          return "";
-        }
-        break;
+
+      /* &#<decimal code>; */
+      auto code = static_cast<v_uint32>(encoding::Unicode::encodeUtf8Char(&text[i], charLength));
+      result += 3;
+      do {
+        result ++;
+        code /= 10;
+      } while(code > 0);
+
+      i += charLength;
+
     }
+
   }
 
-  return ss.toString();
+  return result;
 
 }
 
-oatpp::String Utils::escapeElementText(const oatpp::String& text, data::mapping::ErrorStack& errorStack) {
+bool Utils::escapeAttributeText(data::stream::ConsistentOutputStream* stream,
+                                const char* text, v_buff_size textSize, char enclosingChar)
+{
+
+  char escaped[MAX_ESCAPED_CHAR_SIZE];
+
+  v_buff_size i = 0;
+  while(i < textSize) {
+
+    /* write runs of chars which don't need escaping at once */
+    auto runSize = getPlainTextLength(&text[i], textSize - i, enclosingChar);
+    if(runSize > 0) {
+      stream->writeSimple(&text[i], runSize);
+      i += runSize;
+    }
+
+    if(i < textSize) {
+      v_buff_size escapedSize;
+      auto charSize = escapeNextChar(&text[i], textSize - i, escaped, escapedSize);
+      if(charSize == 0) {
+        return false;
+      }
+      stream->writeSimple(escaped, escapedSize);
+      i += charSize;
+    }
+
+  }
+
+  return true;
+
+}
+
+bool Utils::escapeElementText(data::stream::ConsistentOutputStream* stream,
+                              const char* text, v_buff_size textSize)
+{
+  return escapeAttributeText(stream, text, textSize, 0);
+}
+
+oatpp::String Utils::escapeAttributeText(const oatpp::String& text, char enclosingChar, data::mapping::ErrorStack& errorStack) {
 
   if(text == nullptr) {
     return "";
   }
 
   data::stream::BufferOutputStream ss(256);
+  if(!escapeAttributeText(&ss, text->data(), static_cast<v_buff_size>(text->size()), enclosingChar)) {
+    errorStack.push("[oatpp::xml::Utils::escapeAttributeText()]: Invalid character");
+    return "";
+  }
 
-  auto data = text->data();
+  return ss.toString();
 
-  v_buff_usize i = 0;
-  while(i < text->size()) {
-    i += escapeChar(&ss, &data[i], text->size() - i, errorStack);
-    if(!errorStack.empty()) {
-      return "";
-    }
+}
+
+oatpp::String Utils::escapeElementText(const oatpp::String& text, data::mapping::ErrorStack& errorStack) {
+
+  if(text == nullptr) {
+    return "";
+  }
+
+  data::stream::BufferOutputStream ss(256);
+  if(!escapeElementText(&ss, text->data(), static_cast<v_buff_size>(text->size()))) {
+    errorStack.push("[oatpp::xml::Utils::escapeElementText()]: Invalid character");
+    return "";
   }
 
   return ss.toString();
@@ -200,17 +303,26 @@ oatpp::String Utils::escapeElementText(const oatpp::String& text, data::mapping:
 }
 
 oatpp::String Utils::unescapeText(const oatpp::String& text, data::mapping::ErrorStack& errorStack) {
-
   data::stream::BufferOutputStream ss(256);
+  unescapeText(&ss, text->data(), static_cast<v_buff_size>(text->size()));
+  return ss.toString();
+}
+
+bool Utils::unescapeText(data::stream::OutputStream* stream, const char* text, v_buff_size textSize) {
+
+  v_buff_size position = 0;
+  while (position < textSize) {
+
+    auto found = static_cast<const char*>(std::memchr(text + position, '&', static_cast<size_t>(textSize - position)));
+    auto runEnd = found ? static_cast<v_buff_size>(found - text) : textSize;
+    if(runEnd > position && stream->writeSimple(text + position, runEnd - position) != runEnd - position) {
+      return false;
+    }
+    position = runEnd;
 
-  utils::parser::Caret caret(text);
-  while (caret.canContinue()) {
-    auto label = caret.putLabel();
-    auto found = caret.findChar('&');
-    ss.writeSimple(label.getData(), label.getSize());
     if(found) {
-      auto data = reinterpret_cast<const v_char8*>(caret.getCurrData());
-      auto size = caret.getDataSize() - caret.getPosition();
+      auto data = reinterpret_cast<const v_char8*>(found);
+      auto size = textSize - position;
       v_buff_size i;
       for(i = 1; i < size; i ++) {
         auto c = data[static_cast<v_buff_usize>(i)];
@@ -225,12 +337,13 @@ oatpp::String Utils::unescapeText(const oatpp::String& text, data::mapping::Erro
           break;
         }
       }
-      unescapeChar(&ss, data::share::StringKeyLabel(nullptr, reinterpret_cast<const char*>(data), i));
-      caret.inc(i);
+      unescapeChar(stream, data::share::StringKeyLabel(nullptr, found, i));
+      position += i;
     }
+
   }
 
-  return ss.toString();
+  return true;
 
 }
 
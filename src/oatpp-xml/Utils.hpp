@@ -39,19 +39,93 @@ public:
   static constexpr v_uint32 FLAG_ESCAPE_ALL = FLAG_ESCAPE_WHITESPACE | FLAG_ESCAPE_UTF8CHAR;
 public:
   static const std::unordered_map<data::share::StringKeyLabel, std::string> PREDEFINED_ENTITIES;
+
+  /**
+   * Max size of a single escaped char produced by &l:Utils::escapeNextChar ();.
+   */
+  static constexpr v_buff_size MAX_ESCAPED_CHAR_SIZE = 16;
 public:
 
+  /**
+   * Get length of the leading run of chars which don't need escaping.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @param enclosingChar - attribute value enclosing char - `"` or `'`. `0` for element text.
+   * @return - length of the run.
+   */
+  static v_buff_size getPlainTextLength(const char* text, v_buff_size textSize, char enclosingChar) {
+    v_buff_size i = 0;
+    while(i < textSize) {
+      auto c = static_cast<v_char8>(text[i]);
+      if(c < 32 || c >= 128 || c == '&' || c == '<' || c == '>' || c == static_cast<v_char8>(enclosingChar)) {
+        break;
+      }
+      i ++;
+    }
+    return i;
+  }
+
+  /**
+   * Escape the char (UTF-8 sequence) at the start of the text. <br>
+   * To be called for chars where &l:Utils::getPlainTextLength (); stopped.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @param escaped - out buffer of at least &l:Utils::MAX_ESCAPED_CHAR_SIZE; bytes.
+   * @param escapedSize - out size of the escaped char.
+   * @return - count of consumed text bytes. `0` - invalid character.
+   */
+  static v_buff_size escapeNextChar(const char* text, v_buff_size textSize, char* escaped, v_buff_size& escapedSize);
+
+  /**
+   * Get size of the escaped text without writing it.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @param enclosingChar - attribute value enclosing char - `"` or `'`. `0` for element text.
+   * @return - size of the escaped text. `-1` if text contains an invalid character.
+   */
+  static v_buff_size getEscapedTextSize(const char* text, v_buff_size textSize, char enclosingChar);
+
   static v_uint32 escapeChar(data::stream::ConsistentOutputStream* stream,
                              const char* buffer, v_buff_usize bufferSize,
                              data::mapping::ErrorStack& errorStack);
 
-  static bool unescapeChar(data::stream::ConsistentOutputStream* stream, const data::share::StringKeyLabel& charRef);
+  static bool unescapeChar(data::stream::OutputStream* stream, const data::share::StringKeyLabel& charRef);
+
+  /**
+   * Escape attribute text and write it straight to the stream.
+   * @param stream - &id:oatpp::data::stream::ConsistentOutputStream;.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @param enclosingChar - attribute value enclosing char - `"` or `'`.
+   * @return - `false` if text contains an invalid character.
+   */
+  static bool escapeAttributeText(data::stream::ConsistentOutputStream* stream,
+                                  const char* text, v_buff_size textSize, char enclosingChar);
+
+  /**
+   * Escape element text and write it straight to the stream.
+   * @param stream - &id:oatpp::data::stream::ConsistentOutputStream;.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @return - `false` if text contains an invalid character.
+   */
+  static bool escapeElementText(data::stream::ConsistentOutputStream* stream,
+                                const char* text, v_buff_size textSize);
 
   static oatpp::String escapeAttributeText(const oatpp::String& text, char enclosingChar, data::mapping::ErrorStack& errorStack);
   static oatpp::String escapeElementText(const oatpp::String& text, data::mapping::ErrorStack& errorStack);
 
   static oatpp::String unescapeText(const oatpp::String& text, data::mapping::ErrorStack& errorStack);
 
+  /**
+   * Unescape text and write it straight to the stream.
+   * @param stream - &id:oatpp::data::stream::OutputStream;.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @return - `false` if the stream failed to write.
+   */
+  static bool unescapeText(data::stream::OutputStream* stream, const char* text, v_buff_size textSize);
+
 
 };
 
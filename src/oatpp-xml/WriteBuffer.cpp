@@ -0,0 +1,182 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "WriteBuffer.hpp"
+
+#include "./Base64.hpp"
+#include "./Utils.hpp"
+
+#include <algorithm>
+
+namespace oatpp { namespace xml {
+
+WriteBuffer::WriteBuffer(data::stream::ConsistentOutputStream* stream, char* data, v_buff_size capacity)
+  : m_stream(stream)
+  , m_data(data)
+  , m_capacity(capacity)
+  , m_position(0)
+  , m_overflowSize(0)
+{}
+
+WriteBuffer::WriteBuffer(char* data, v_buff_size capacity)
+  : WriteBuffer(nullptr, data, capacity)
+{}
+
+WriteBuffer::~WriteBuffer() {
+  flush();
+}
+
+void WriteBuffer::writeSlow(const char* data, v_buff_size size) {
+  if(m_stream == nullptr) {
+    /* no stream - from now on only count */
+    m_capacity = m_position;
+    m_overflowSize += size;
+    return;
+  }
+  flush();
+  if(size < m_capacity) {
+    std::memcpy(m_data, data, static_cast<size_t>(size));
+    m_position = size;
+    return;
+  }
+  /* too big to buffer - write straight to the stream */
+  m_stream->writeSimple(data, size);
+}
+
+void WriteBuffer::writeAsString(v_int32 value) {
+  writeNumber(static_cast<v_int64>(value), &NumberFormat::formatInt64);
+}
+
+void WriteBuffer::writeAsString(v_uint32 value) {
+  writeNumber(static_cast<v_uint64>(value), &NumberFormat::formatUInt64);
+}
+
+void WriteBuffer::writeAsString(v_int64 value) {
+  writeNumber(value, &NumberFormat::formatInt64);
+}
+
+void WriteBuffer::writeAsString(v_uint64 value) {
+  writeNumber(value, &NumberFormat::formatUInt64);
+}
+
+void WriteBuffer::writeAsString(v_float32 value) {
+  writeNumber(value, &NumberFormat::formatFloat32);
+}
+
+void WriteBuffer::writeAsString(v_float64 value) {
+  writeNumber(value, &NumberFormat::formatFloat64);
+}
+
+void WriteBuffer::writeAsString(bool value) {
+  if(value) {
+    write("true", 4);
+  } else {
+    write("false", 5);
+  }
+}
+
+bool WriteBuffer::writeEscapedElementText(const char* text, v_buff_size textSize) {
+  return writeEscapedAttributeText(text, textSize, 0);
+}
+
+bool WriteBuffer::writeEscapedAttributeText(const char* text, v_buff_size textSize, char enclosingChar) {
+
+  if(m_overflowSize > 0) {
+    auto escapedSize = Utils::getEscapedTextSize(text, textSize, enclosingChar);
+    if(escapedSize < 0) {
+      return false;
+    }
+    m_overflowSize += escapedSize;
+    return true;
+  }
+
+  v_buff_size i = 0;
+  while(i < textSize) {
+
+    auto runSize = Utils::getPlainTextLength(&text[i], textSize - i, enclosingChar);
+    if(runSize > 0) {
+      write(&text[i], runSize);
+      i += runSize;
+    }
+
+    if(i < textSize) {
+      char escaped[Utils::MAX_ESCAPED_CHAR_SIZE];
+      v_buff_size escapedSize;
+      auto charSize = Utils::escapeNextChar(&text[i], textSize - i, escaped, escapedSize);
+      if(charSize == 0) {
+        return false;
+      }
+      write(escaped, escapedSize);
+      i += charSize;
+    }
+
+  }
+
+  return true;
+
+}
+
+void WriteBuffer::writeBase64(const char* data, v_buff_size size) {
+
+  if(m_stream == nullptr && Base64::getEncodedSize(size) > m_capacity - m_position) {
+    /* no stream - from now on only count */
+    m_capacity = m_position;
+    m_overflowSize += Base64::getEncodedSize(size);
+    return;
+  }
+
+  v_buff_size i = 0;
+  while(i < size) {
+
+    if(m_capacity - m_position < 4) {
+      flush();
+    }
+
+    auto room = m_capacity - m_position;
+    if(room < 4) {
+      /* zero capacity - encode small chunks on stack */
+      char chunk[64];
+      auto chunkSize = std::min<v_buff_size>(48, size - i);
+      write(chunk, Base64::encode(data + i, chunkSize, chunk));
+      i += chunkSize;
+      continue;
+    }
+
+    /* whole quads only - padding may appear only at the very end */
+    auto chunkSize = std::min<v_buff_size>(room / 4 * 3, size - i);
+    m_position += Base64::encode(data + i, chunkSize, m_data + m_position);
+    i += chunkSize;
+
+  }
+
+}
+
+void WriteBuffer::flush() {
+  if(m_stream && m_position > 0) {
+    m_stream->writeSimple(m_data, m_position);
+    m_position = 0;
+  }
+}
+
+}}
@@ -0,0 +1,198 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_WRITEBUFFER_HPP
+#define OATPP_XML_WRITEBUFFER_HPP
+
+#include "./NumberFormat.hpp"
+
+#include "oatpp/data/stream/Stream.hpp"
+#include "oatpp/Types.hpp"
+
+#include <cstring>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Fixed-size write-combining buffer. <br>
+ * Collects small fragments (tags, names, attribute values) and flushes them to the underlying stream in large blocks,
+ * so that the stream's virtual `write` is called once per block instead of once per fragment. <br>
+ * Buffer memory is owned by the caller. Zero capacity - every write goes straight to the stream. <br>
+ * Without a stream, data is written to the buffer memory until the first write which doesn't fit.
+ * After that the buffer is overflown and only counts the size of the data - escaped text is measured without being written.
+ */
+class WriteBuffer {
+private:
+  data::stream::ConsistentOutputStream* m_stream;
+  char* m_data;
+  v_buff_size m_capacity;
+  v_buff_size m_position;
+  v_buff_size m_overflowSize;
+private:
+  void writeSlow(const char* data, v_buff_size size);
+  template<typename T, typename F>
+  void writeNumber(T value, F format) {
+    if(m_capacity - m_position < NumberFormat::MAX_SIZE) {
+      flush();
+    }
+    if(m_capacity - m_position >= NumberFormat::MAX_SIZE) {
+      m_position += format(value, m_data + m_position);
+    } else {
+      char buffer[NumberFormat::MAX_SIZE];
+      write(buffer, format(value, buffer));
+    }
+  }
+public:
+
+  /**
+   * Constructor.
+   * @param stream - stream to flush data to.
+   * @param data - buffer memory.
+   * @param capacity - buffer capacity.
+   */
+  WriteBuffer(data::stream::ConsistentOutputStream* stream, char* data, v_buff_size capacity);
+
+  /**
+   * Constructor. Buffer without a stream.
+   * @param data - buffer memory.
+   * @param capacity - buffer capacity. `0` - only measure the size of the data.
+   */
+  WriteBuffer(char* data, v_buff_size capacity);
+
+  /**
+   * Non-copyable.
+   */
+  WriteBuffer(const WriteBuffer&) = delete;
+  WriteBuffer& operator=(const WriteBuffer&) = delete;
+
+  /**
+   * Destructor. Flushes pending data.
+   */
+  ~WriteBuffer();
+
+  /**
+   * Write data.
+   * @param data
+   * @param size
+   */
+  void write(const char* data, v_buff_size size) {
+    if(size <= m_capacity - m_position) {
+      std::memcpy(m_data + m_position, data, static_cast<size_t>(size));
+      m_position += size;
+      return;
+    }
+    writeSlow(data, size);
+  }
+
+  /**
+   * Write char.
+   * @param c
+   */
+  void write(char c) {
+    if(m_position < m_capacity) {
+      m_data[m_position ++] = c;
+      return;
+    }
+    writeSlow(&c, 1);
+  }
+
+  /**
+   * Write string.
+   * @param str
+   */
+  void write(const oatpp::String& str) {
+    write(str->data(), static_cast<v_buff_size>(str->size()));
+  }
+
+  /*
+   * Numbers are formatted straight into the buffer. See &id:oatpp::xml::NumberFormat;.
+   */
+
+  void writeAsString(v_int32 value);
+  void writeAsString(v_uint32 value);
+  void writeAsString(v_int64 value);
+  void writeAsString(v_uint64 value);
+  void writeAsString(v_float32 value);
+  void writeAsString(v_float64 value);
+  void writeAsString(bool value);
+
+  /**
+   * Escape element text and write it.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @return - `false` if text contains an invalid character.
+   */
+  bool writeEscapedElementText(const char* text, v_buff_size textSize);
+
+  /**
+   * Escape attribute text and write it.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @param enclosingChar - attribute value enclosing char - `"` or `'`.
+   * @return - `false` if text contains an invalid character.
+   */
+  bool writeEscapedAttributeText(const char* text, v_buff_size textSize, char enclosingChar);
+
+  /**
+   * Encode binary data as base64 and write it. Data is encoded straight into the buffer. See &id:oatpp::xml::Base64;.
+   * @param data - binary data.
+   * @param size - size of the data.
+   */
+  void writeBase64(const char* data, v_buff_size size);
+
+  /**
+   * Write pending data to the stream. No-op if the buffer has no stream.
+   */
+  void flush();
+
+  /**
+   * Get buffer memory.
+   * @return
+   */
+  const char* getData() const {
+    return m_data;
+  }
+
+  /**
+   * Get size of the data written to the buffer which was not flushed yet, plus the size of the overflown data.
+   * For a buffer without a stream - total size of the data written.
+   * @return
+   */
+  v_buff_size getSize() const {
+    return m_position + m_overflowSize;
+  }
+
+  /**
+   * Check if data didn't fit into the buffer without a stream.
+   * @return
+   */
+  bool isOverflown() const {
+    return m_overflowSize > 0;
+  }
+
+};
+
+}}
+
+#endif //OATPP_XML_WRITEBUFFER_HPP
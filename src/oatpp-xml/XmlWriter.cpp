@@ -0,0 +1,228 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "XmlWriter.hpp"
+
+#include "Scanner.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace oatpp { namespace xml {
+
+XmlWriter::XmlWriter(data::stream::ConsistentOutputStream* stream, v_buff_size bufferSize)
+  : m_data(bufferSize > 0 ? new char[static_cast<size_t>(bufferSize)] : nullptr)
+  , m_buffer(stream, m_data.get(), bufferSize)
+  , m_startTagOpen(false)
+{}
+
+void XmlWriter::closeStartTag() {
+  if(m_startTagOpen) {
+    m_buffer.write('>');
+    m_startTagOpen = false;
+  }
+}
+
+void XmlWriter::startContent(const char* method) {
+#ifndef NDEBUG
+  if(m_elements.empty()) {
+    throw std::runtime_error(std::string("[oatpp::xml::XmlWriter::") + method + "()]: Error. Content must be written inside an element.");
+  }
+#else
+  (void) method;
+#endif
+  closeStartTag();
+}
+
+void XmlWriter::startElement(const char* name, v_buff_size nameSize) {
+  closeStartTag();
+#ifndef NDEBUG
+  m_elements.emplace_back(name, static_cast<size_t>(nameSize));
+#endif
+  m_buffer.write('<');
+  m_buffer.write(name, nameSize);
+  m_startTagOpen = true;
+}
+
+void XmlWriter::startElement(const char* name) {
+  startElement(name, static_cast<v_buff_size>(std::strlen(name)));
+}
+
+void XmlWriter::startElement(const oatpp::String& name) {
+  startElement(name->data(), static_cast<v_buff_size>(name->size()));
+}
+
+bool XmlWriter::attribute(const char* name, v_buff_size nameSize, const char* value, v_buff_size valueSize) {
+#ifndef NDEBUG
+  if(!m_startTagOpen) {
+    throw std::runtime_error("[oatpp::xml::XmlWriter::attribute()]: Error. Attributes must be written right after startElement().");
+  }
+#endif
+  m_buffer.write(' ');
+  m_buffer.write(name, nameSize);
+  m_buffer.write("=\"", 2);
+  if(!m_buffer.writeEscapedAttributeText(value, valueSize, '"')) {
+    return false;
+  }
+  m_buffer.write('"');
+  return true;
+}
+
+bool XmlWriter::attribute(const char* name, const char* value) {
+  return attribute(name, static_cast<v_buff_size>(std::strlen(name)), value, static_cast<v_buff_size>(std::strlen(value)));
+}
+
+bool XmlWriter::attribute(const oatpp::String& name, const oatpp::String& value) {
+  return attribute(name->data(), static_cast<v_buff_size>(name->size()), value->data(), static_cast<v_buff_size>(value->size()));
+}
+
+bool XmlWriter::text(const char* text, v_buff_size textSize) {
+  startContent("text");
+  return m_buffer.writeEscapedElementText(text, textSize);
+}
+
+bool XmlWriter::text(const char* text) {
+  return this->text(text, static_cast<v_buff_size>(std::strlen(text)));
+}
+
+bool XmlWriter::text(const oatpp::String& text) {
+  return this->text(text->data(), static_cast<v_buff_size>(text->size()));
+}
+
+void XmlWriter::value(v_int32 value) {
+  startContent("value");
+  m_buffer.writeAsString(value);
+}
+
+void XmlWriter::value(v_uint32 value) {
+  startContent("value");
+  m_buffer.writeAsString(value);
+}
+
+void XmlWriter::value(v_int64 value) {
+  startContent("value");
+  m_buffer.writeAsString(value);
+}
+
+void XmlWriter::value(v_uint64 value) {
+  startContent("value");
+  m_buffer.writeAsString(value);
+}
+
+void XmlWriter::value(v_float32 value) {
+  startContent("value");
+  m_buffer.writeAsString(value);
+}
+
+void XmlWriter::value(v_float64 value) {
+  startContent("value");
+  m_buffer.writeAsString(value);
+}
+
+void XmlWriter::value(bool value) {
+  startContent("value");
+  m_buffer.writeAsString(value);
+}
+
+void XmlWriter::cdata(const char* data, v_buff_size size) {
+  startContent("cdata");
+  m_buffer.write("<![CDATA[", 9);
+  /* "]]>" can't appear inside a section - end the section after "]]" and start the next one with ">" */
+  auto offset = Scanner::findText(data, size, "]]>", 3);
+  while(offset >= 0) {
+    m_buffer.write(data, offset + 2);
+    m_buffer.write("]]><![CDATA[", 12);
+    data += offset + 2;
+    size -= offset + 2;
+    offset = Scanner::findText(data, size, "]]>", 3);
+  }
+  m_buffer.write(data, size);
+  m_buffer.write("]]>", 3);
+}
+
+void XmlWriter::cdata(const oatpp::String& data) {
+  cdata(data->data(), static_cast<v_buff_size>(data->size()));
+}
+
+bool XmlWriter::comment(const char* data, v_buff_size size) {
+  if(Scanner::findText(data, size, "--", 2) >= 0 || (size > 0 && data[size - 1] == '-')) {
+    return false;
+  }
+  closeStartTag();
+  m_buffer.write("<!--", 4);
+  m_buffer.write(data, size);
+  m_buffer.write("-->", 3);
+  return true;
+}
+
+bool XmlWriter::comment(const oatpp::String& data) {
+  return comment(data->data(), static_cast<v_buff_size>(data->size()));
+}
+
+bool XmlWriter::pi(const oatpp::String& target, const oatpp::String& data) {
+  if(data && Scanner::findText(data->data(), static_cast<v_buff_size>(data->size()), "?>", 2) >= 0) {
+    return false;
+  }
+  closeStartTag();
+  m_buffer.write("<?", 2);
+  m_buffer.write(target);
+  if(data && !data->empty()) {
+    m_buffer.write(' ');
+    m_buffer.write(data);
+  }
+  m_buffer.write("?>", 2);
+  return true;
+}
+
+void XmlWriter::endElement(const char* name, v_buff_size nameSize) {
+#ifndef NDEBUG
+  if(m_elements.empty() || m_elements.back().compare(0, std::string::npos, name, static_cast<size_t>(nameSize)) != 0) {
+    throw std::runtime_error("[oatpp::xml::XmlWriter::endElement()]: Error. '" + std::string(name, static_cast<size_t>(nameSize)) +
+                             "' doesn't match the open element '" + (m_elements.empty() ? std::string() : m_elements.back()) + "'.");
+  }
+  m_elements.pop_back();
+#endif
+  if(m_startTagOpen) {
+    m_buffer.write("/>", 2);
+    m_startTagOpen = false;
+    return;
+  }
+  m_buffer.write("</", 2);
+  m_buffer.write(name, nameSize);
+  m_buffer.write('>');
+}
+
+void XmlWriter::endElement(const char* name) {
+  endElement(name, static_cast<v_buff_size>(std::strlen(name)));
+}
+
+void XmlWriter::endElement(const oatpp::String& name) {
+  endElement(name->data(), static_cast<v_buff_size>(name->size()));
+}
+
+void XmlWriter::flush() {
+  m_buffer.flush();
+}
+
+}}
@@ -0,0 +1,166 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef OATPP_XML_XMLWRITER_HPP
+#define OATPP_XML_XMLWRITER_HPP
+
+#include "./WriteBuffer.hpp"
+
+#include "oatpp/data/stream/Stream.hpp"
+#include "oatpp/Types.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+/**
+ * Streaming XML writer. <br>
+ * Writes XML straight to the stream without building a &id:oatpp::data::mapping::Tree;. Output goes through a &id:oatpp::xml::WriteBuffer;,
+ * text and attribute values are escaped the same way &id:oatpp::xml::Serializer; escapes them. <br>
+ * The writer doesn't keep the open elements - the caller passes the name to &l:XmlWriter::endElement ();.
+ * In debug builds (`NDEBUG` not defined) nesting is checked and misuse throws `std::runtime_error`.
+ * The class layout is the same in both builds - only the checks are compiled out. <br>
+ * Writer is NOT thread-safe.
+ */
+class XmlWriter {
+private:
+  std::unique_ptr<char[]> m_data;
+  WriteBuffer m_buffer;
+  bool m_startTagOpen;
+  std::vector<std::string> m_elements;
+private:
+  void closeStartTag();
+  void startContent(const char* method);
+public:
+
+  /**
+   * Constructor.
+   * @param stream - stream to write to.
+   * @param bufferSize - size of the write buffer. `0` - no buffering.
+   */
+  XmlWriter(data::stream::ConsistentOutputStream* stream, v_buff_size bufferSize = 4096);
+
+  XmlWriter(const XmlWriter&) = delete;
+  XmlWriter& operator=(const XmlWriter&) = delete;
+
+  /**
+   * Destructor. Pending data is flushed by the &id:oatpp::xml::WriteBuffer; destructor.
+   */
+  ~XmlWriter() = default;
+
+  /**
+   * Write element start tag - `<name`. Attributes may be added until any content is written.
+   * @param name - element name.
+   * @param nameSize - element name size.
+   */
+  void startElement(const char* name, v_buff_size nameSize);
+
+  void startElement(const char* name);
+  void startElement(const oatpp::String& name);
+
+  /**
+   * Add attribute to the current start tag. Value is escaped.
+   * @param name - attribute name.
+   * @param nameSize - attribute name size.
+   * @param value - attribute value.
+   * @param valueSize - attribute value size.
+   * @return - `false` if value contains an invalid character.
+   */
+  bool attribute(const char* name, v_buff_size nameSize, const char* value, v_buff_size valueSize);
+
+  bool attribute(const char* name, const char* value);
+  bool attribute(const oatpp::String& name, const oatpp::String& value);
+
+  /**
+   * Write element text. Text is escaped.
+   * @param text - text data.
+   * @param textSize - text size.
+   * @return - `false` if text contains an invalid character.
+   */
+  bool text(const char* text, v_buff_size textSize);
+
+  bool text(const char* text);
+  bool text(const oatpp::String& text);
+
+  /*
+   * Write number or bool as element text. See &id:oatpp::xml::NumberFormat;.
+   */
+
+  void value(v_int32 value);
+  void value(v_uint32 value);
+  void value(v_int64 value);
+  void value(v_uint64 value);
+  void value(v_float32 value);
+  void value(v_float64 value);
+  void value(bool value);
+
+  /**
+   * Write CDATA section. Data is written as-is, `]]>` inside the data is split between two sections.
+   * @param data - CDATA content.
+   * @param size - content size.
+   */
+  void cdata(const char* data, v_buff_size size);
+
+  void cdata(const oatpp::String& data);
+
+  /**
+   * Write comment. Data is written as-is.
+   * @param data - comment content.
+   * @param size - content size.
+   * @return - `false` if the data contains `--` or ends with `-`. Nothing is written in this case.
+   */
+  bool comment(const char* data, v_buff_size size);
+
+  bool comment(const oatpp::String& data);
+
+  /**
+   * Write processing instruction - `<?target data?>`. Data is written as-is.
+   * @param target - PI target, ex.: `xml`.
+   * @param data - PI data, ex.: `version="1.0"`. May be `nullptr`.
+   * @return - `false` if the data contains `?>`. Nothing is written in this case.
+   */
+  bool pi(const oatpp::String& target, const oatpp::String& data);
+
+  /**
+   * Write element end tag. Element without content is closed as an empty element - `<name/>`.
+   * @param name - element name. Must be the name passed to the matching &l:XmlWriter::startElement ();.
+   * @param nameSize - element name size.
+   */
+  void endElement(const char* name, v_buff_size nameSize);
+
+  void endElement(const char* name);
+  void endElement(const oatpp::String& name);
+
+  /**
+   * Write pending data to the stream.
+   */
+  void flush();
+
+};
+
+}}
+
+#endif //OATPP_XML_XMLWRITER_HPP
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Base64Benchmark.hpp"
+
+#include "oatpp-xml/Base64.hpp"
+
+#include "oatpp/encoding/Base64.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+std::string encode(const std::string& data) {
+  std::string result(static_cast<size_t>(Base64::getEncodedSize(static_cast<v_buff_size>(data.size()))), '\0');
+  auto size = Base64::encode(data.data(), static_cast<v_buff_size>(data.size()), &result[0]);
+  OATPP_ASSERT(size == static_cast<v_buff_size>(result.size()))
+  return result;
+}
+
+bool decode(const std::string& text, std::string& data) {
+  data.assign(static_cast<size_t>(Base64::getMaxDecodedSize(static_cast<v_buff_size>(text.size()))), '\0');
+  auto size = Base64::decode(text.data(), static_cast<v_buff_size>(text.size()), &data[0]);
+  if(size < 0) {
+    return false;
+  }
+  data.resize(static_cast<size_t>(size));
+  return true;
+}
+
+std::string generateData(v_buff_size size) {
+  std::mt19937 random(42);
+  std::string data(static_cast<size_t>(size), '\0');
+  for(auto& c : data) {
+    c = static_cast<char>(random());
+  }
+  return data;
+}
+
+}
+
+void Base64Benchmark::onRun() {
+
+  /* throughput against oatpp::encoding::Base64 */
+  {
+    for(v_buff_size size : {1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024}) {
+
+      auto data = generateData(size);
+      oatpp::String dataString(data);
+      v_int32 iterations = static_cast<v_int32>(std::max<v_buff_size>(1, 64 * 1024 * 1024 / size / 4));
+
+      std::string text;
+      auto start = std::chrono::steady_clock::now();
+      for(v_int32 i = 0; i < iterations; i ++) text = encode(data);
+      auto timeEncode = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+      std::string decoded;
+      start = std::chrono::steady_clock::now();
+      for(v_int32 i = 0; i < iterations; i ++) OATPP_ASSERT(decode(text, decoded))
+      auto timeDecode = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+      OATPP_ASSERT(decoded == data)
+
+      oatpp::String coreText;
+      start = std::chrono::steady_clock::now();
+      for(v_int32 i = 0; i < iterations; i ++) coreText = oatpp::encoding::Base64::encode(dataString);
+      auto timeCoreEncode = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+      start = std::chrono::steady_clock::now();
+      for(v_int32 i = 0; i < iterations; i ++) oatpp::encoding::Base64::decode(coreText);
+      auto timeCoreDecode = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+      auto megabytes = static_cast<v_float64>(size) * iterations / (1024.0 * 1024.0);
+      auto rate = [megabytes](v_int64 us) { return us > 0 ? static_cast<v_int64>(megabytes * 1000000.0 / static_cast<v_float64>(us)) : 0; };
+
+      OATPP_LOGd(TAG, "{} bytes x {}: encode {} MB/s (encoding::Base64 {} MB/s), decode {} MB/s (encoding::Base64 {} MB/s)",
+                 size, iterations, rate(timeEncode), rate(timeCoreEncode), rate(timeDecode), rate(timeCoreDecode))
+
+    }
+  }
+
+}
+
+}}
@@ -0,0 +1,147 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Base64Test.hpp"
+
+#include "oatpp-xml/Base64.hpp"
+#include "oatpp-xml/WriteBuffer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/encoding/Base64.hpp"
+
+#include <random>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+std::string encode(const std::string& data) {
+  std::string result(static_cast<size_t>(Base64::getEncodedSize(static_cast<v_buff_size>(data.size()))), '\0');
+  auto size = Base64::encode(data.data(), static_cast<v_buff_size>(data.size()), &result[0]);
+  OATPP_ASSERT(size == static_cast<v_buff_size>(result.size()))
+  return result;
+}
+
+bool decode(const std::string& text, std::string& data) {
+  data.assign(static_cast<size_t>(Base64::getMaxDecodedSize(static_cast<v_buff_size>(text.size()))), '\0');
+  auto size = Base64::decode(text.data(), static_cast<v_buff_size>(text.size()), &data[0]);
+  if(size < 0) {
+    return false;
+  }
+  data.resize(static_cast<size_t>(size));
+  return true;
+}
+
+std::string generateData(v_buff_size size) {
+  std::mt19937 random(42);
+  std::string data(static_cast<size_t>(size), '\0');
+  for(auto& c : data) {
+    c = static_cast<char>(random());
+  }
+  return data;
+}
+
+}
+
+void Base64Test::onRun() {
+
+  /* RFC 4648 test vectors */
+  {
+    OATPP_ASSERT(encode("") == "")
+    OATPP_ASSERT(encode("f") == "Zg==")
+    OATPP_ASSERT(encode("fo") == "Zm8=")
+    OATPP_ASSERT(encode("foo") == "Zm9v")
+    OATPP_ASSERT(encode("foob") == "Zm9vYg==")
+    OATPP_ASSERT(encode("fooba") == "Zm9vYmE=")
+    OATPP_ASSERT(encode("foobar") == "Zm9vYmFy")
+
+    std::string data;
+    OATPP_ASSERT(decode("Zm9vYmFy", data) && data == "foobar")
+    OATPP_ASSERT(decode("Zm9vYmE=", data) && data == "fooba")
+    OATPP_ASSERT(decode("Zm9vYg==", data) && data == "foob")
+    OATPP_ASSERT(decode("", data) && data == "")
+  }
+
+  /* whitespace and invalid input */
+  {
+    std::string data;
+    OATPP_ASSERT(decode("  Zm9v\n  YmFy\r\n", data) && data == "foobar")
+    OATPP_ASSERT(decode("Zm9\tvYg = =", data) && data == "foob")
+    OATPP_ASSERT(!decode("Zm9", data))
+    OATPP_ASSERT(!decode("Zm9vY", data))
+    OATPP_ASSERT(!decode("Z===", data))
+    OATPP_ASSERT(!decode("Zg==Zg==", data))
+    OATPP_ASSERT(!decode("Zg=a", data))
+    OATPP_ASSERT(!decode("Zm9v&amp;", data))
+    OATPP_ASSERT(!decode("Zm9-", data))
+  }
+
+  /* round-trip, line-wrapped text */
+  {
+    std::mt19937 random(42);
+    for(v_int32 i = 0; i < 2000; i ++) {
+      auto data = generateData(random() % 300);
+      auto text = encode(data);
+      OATPP_ASSERT(encode(data) == *oatpp::encoding::Base64::encode(oatpp::String(data)))
+
+      std::string wrapped;
+      for(size_t j = 0; j < text.size(); j += 76) {
+        wrapped.append(text, j, 76).append("\n");
+      }
+
+      std::string decoded;
+      OATPP_ASSERT(decode(text, decoded) && decoded == data)
+      OATPP_ASSERT(decode(wrapped, decoded) && decoded == data)
+    }
+  }
+
+  /* write buffer - chunked encoding gives the same text for any buffer size */
+  {
+    auto data = generateData(1000);
+    auto text = encode(data);
+    for(v_buff_size capacity : {0, 1, 5, 16, 64, 4096}) {
+      data::stream::BufferOutputStream stream;
+      std::string memory(static_cast<size_t>(capacity), '\0');
+      {
+        WriteBuffer buffer(&stream, &memory[0], capacity);
+        buffer.writeBase64(data.data(), static_cast<v_buff_size>(data.size()));
+      }
+      OATPP_ASSERT(stream.toString() == text.c_str())
+    }
+  }
+
+
+  /* large input matches oatpp::encoding::Base64 */
+  {
+    auto data = generateData(64 * 1024);
+    auto text = encode(data);
+    OATPP_ASSERT(text == *oatpp::encoding::Base64::encode(oatpp::String(data)))
+    std::string decoded;
+    OATPP_ASSERT(decode(text, decoded) && decoded == data)
+  }
+
+}
+
+}}
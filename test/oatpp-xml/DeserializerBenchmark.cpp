@@ -0,0 +1,187 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "DeserializerBenchmark.hpp"
+#include "TestDocuments.hpp"
+
+#include "oatpp-xml/Deserializer.hpp"
+#include "oatpp-xml/TypeHints.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/macro/codegen.hpp"
+
+#include <chrono>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+class RecordDto : public oatpp::DTO {
+
+  DTO_INIT(RecordDto, DTO)
+
+  DTO_FIELD(Int64, id);
+  DTO_FIELD(Float64, value);
+  DTO_FIELD(Boolean, flag);
+  DTO_FIELD(UInt8, count);
+
+};
+
+class RecordsDto : public oatpp::DTO {
+
+  DTO_INIT(RecordsDto, DTO)
+
+  DTO_FIELD(List<Object<RecordDto>>, records);
+
+};
+
+#include OATPP_CODEGEN_END(DTO)
+
+oatpp::String generateNumericDocument(v_int32 recordsCount) {
+  data::stream::BufferOutputStream ss;
+  ss << "<records>\n";
+  for(v_int32 i = 0; i < recordsCount; i ++) {
+    ss << "  <record><id>" << i * 1000003 << "</id><value>" << i * 0.37 << "</value>";
+    ss << "<flag>" << (i % 2 == 0 ? "true" : "false") << "</flag><count>" << i % 200 << "</count></record>\n";
+  }
+  ss << "</records>\n";
+  return ss.toString();
+}
+
+v_int64 benchmarkParse(const oatpp::String& text, const Deserializer::Config& config, v_int32 iterations,
+                       const TypeHints::Node* hints = nullptr)
+{
+  Deserializer::Context context;
+  auto start = std::chrono::steady_clock::now();
+  for(v_int32 i = 0; i < iterations; i ++) {
+    data::mapping::Tree tree;
+    utils::parser::Caret caret(text);
+    Deserializer::State state;
+    state.tree = &tree;
+    state.caret = &caret;
+    state.config = &config;
+    state.context = &context;
+    state.hints = hints;
+    Deserializer::deserialize(state);
+    OATPP_ASSERT(!state.error.isSet())
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+}
+
+void DeserializerBenchmark::onRun() {
+
+  /* limits overhead on valid input */
+  {
+    auto text = generateRecordsDocument(1000);
+
+    Deserializer::Config noLimits;
+
+    Deserializer::Config limits;
+    limits.maxDepth = 64;
+    limits.maxNodes = 1000000;
+    limits.maxAttributes = 64;
+    limits.maxNameLength = 256;
+    limits.maxTextSize = 1024 * 1024;
+    limits.maxDocumentSize = 1024 * 1024 * 64;
+
+    benchmarkParse(text, noLimits, 5); // warm up
+
+    auto timeNoLimits = benchmarkParse(text, noLimits, 50);
+    auto timeLimits = benchmarkParse(text, limits, 50);
+
+    Deserializer::Config utf8;
+    utf8.validateUtf8 = true;
+    auto timeUtf8 = benchmarkParse(text, utf8, 50);
+
+    OATPP_LOGd(TAG, "parse {} bytes x 50: no limits - {} us, all limits - {} us, UTF-8 validation - {} us",
+               text->size(), timeNoLimits, timeLimits, timeUtf8)
+  }
+
+  /* node filtering - comment-heavy document */
+  {
+    data::stream::BufferOutputStream ss;
+    ss << "<records>";
+    for(v_int32 i = 0; i < 10000; i ++) {
+      ss << "<!-- record " << i << " exported by the vendor system, do not edit by hand -->"
+         << "<record id=\"" << i << "\"><name>record " << i << "</name><?audit user=\"system\"?><value>" << i * 7 << "</value></record>";
+    }
+    ss << "</records>";
+    auto text = ss.toString();
+
+    Deserializer::Config keep;
+    Deserializer::Config skip;
+    skip.skipComments = true;
+    skip.skipPIs = true;
+
+    benchmarkParse(text, keep, 5); // warm up
+    auto timeKeep = benchmarkParse(text, keep, 20);
+    auto timeSkip = benchmarkParse(text, skip, 20);
+
+    OATPP_LOGd(TAG, "parse {} bytes x 20: keep comments and PIs - {} us, skip - {} us", text->size(), timeKeep, timeSkip)
+  }
+
+  /* typed leaves on numeric-heavy payload */
+  {
+    TypeHints hints(oatpp::Object<RecordsDto>::Class::getType());
+    auto text = generateNumericDocument(1000);
+
+    Deserializer::Config strings;
+
+    Deserializer::Config typed;
+    typed.parseTypedLeaves = true;
+
+    benchmarkParse(text, typed, 5, hints.getRoot()); // warm up
+
+    auto timeStrings = benchmarkParse(text, strings, 50, hints.getRoot());
+    auto timeTyped = benchmarkParse(text, typed, 50, hints.getRoot());
+
+    OATPP_LOGd(TAG, "parse {} bytes x 50: string leaves - {} us, typed leaves - {} us", text->size(), timeStrings, timeTyped)
+  }
+
+  /* parallel parsing - core scaling */
+  {
+    auto text = generateRecordsDocument(50000);
+
+    v_int64 serialTime = 0;
+    for(v_int32 threads : {1, 2, 4, 8}) {
+      Deserializer::Config config;
+      config.parallelThreads = threads;
+      config.parallelThreshold = 0;
+      auto time = benchmarkParse(text, config, 3);
+      if(threads == 1) {
+        serialTime = time;
+      }
+      OATPP_LOGd(TAG, "parse {} bytes x 3: {} threads - {} us (x{})", text->size(), threads, time,
+                 static_cast<v_float64>(serialTime) / static_cast<v_float64>(time))
+    }
+  }
+
+}
+
+}}
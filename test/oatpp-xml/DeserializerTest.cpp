@@ -0,0 +1,757 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "DeserializerTest.hpp"
+#include "TestDocuments.hpp"
+
+#include "oatpp-xml/Deserializer.hpp"
+#include "oatpp-xml/ObjectMapper.hpp"
+#include "oatpp-xml/Scanner.hpp"
+#include "oatpp-xml/Serializer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/macro/codegen.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/* keeps spilled content in memory - handle is the content index */
+class MemorySpillSink : public SpillSink {
+public:
+  std::vector<std::shared_ptr<data::stream::BufferOutputStream>> streams;
+  bool fail = false;
+public:
+  std::shared_ptr<data::stream::OutputStream> open(oatpp::String& handle) override {
+    if(fail) {
+      throw std::runtime_error("sink is not available");
+    }
+    handle = oatpp::String(std::to_string(streams.size()));
+    streams.push_back(std::make_shared<data::stream::BufferOutputStream>());
+    return streams.back();
+  }
+};
+
+struct SpillAbort {};
+
+/* throws an exception which is not an std::exception - it's not handled by the deserializer */
+class AbortingSpillSink : public SpillSink {
+public:
+  std::shared_ptr<data::stream::OutputStream> open(oatpp::String& handle) override {
+    (void) handle;
+    throw SpillAbort();
+  }
+};
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+class RecordDto : public oatpp::DTO {
+
+  DTO_INIT(RecordDto, DTO)
+
+  DTO_FIELD(Int64, id);
+  DTO_FIELD(Float64, value);
+  DTO_FIELD(Boolean, flag);
+  DTO_FIELD(UInt8, count);
+  DTO_FIELD(String, name);
+
+};
+
+class BlobDto : public oatpp::DTO {
+
+  DTO_INIT(BlobDto, DTO)
+
+  DTO_FIELD(String, name);
+  DTO_FIELD(Binary, data);
+
+};
+
+class RecordsDto : public oatpp::DTO {
+
+  DTO_INIT(RecordsDto, DTO)
+
+  DTO_FIELD(List<Object<RecordDto>>, records);
+
+};
+
+#include OATPP_CODEGEN_END(DTO)
+
+struct ParseResult {
+  data::mapping::Tree tree;
+  Error error;
+  oatpp::String errorText;
+};
+
+ParseResult parse(const oatpp::String& text, const Deserializer::Config& config = Deserializer::Config(),
+                  const TypeHints::Node* hints = nullptr)
+{
+
+  ParseResult result;
+
+  utils::parser::Caret caret(text);
+
+  Deserializer::State state;
+  state.tree = &result.tree;
+  state.caret = &caret;
+  state.config = &config;
+  state.hints = hints;
+
+  Deserializer::deserialize(state);
+
+  result.error = state.error;
+  if(!state.errorStack.empty()) {
+    result.errorText = state.errorStack.stacktrace();
+  }
+
+  return result;
+
+}
+
+void checkError(const char* tag, const oatpp::String& text, Error::Code code,
+                v_buff_size line, v_buff_size column, const char* path,
+                const Deserializer::Config& config = Deserializer::Config())
+{
+
+  auto result = parse(text, config);
+  OATPP_LOGd(tag, "{}", result.errorText)
+
+  OATPP_ASSERT(result.error.getCode() == code)
+
+  v_buff_size errorLine, errorColumn;
+  OATPP_ASSERT(result.error.getLineColumn(text->data(), static_cast<v_buff_size>(text->size()), errorLine, errorColumn))
+  OATPP_ASSERT(errorLine == line)
+  OATPP_ASSERT(errorColumn == column)
+  OATPP_ASSERT(result.error.getPath() == path)
+
+}
+
+/* children with content that confuses a naive split - tags in CDATA, comments and attribute values, mixed text */
+oatpp::String generateTrickyDocument(v_int32 recordsCount) {
+  data::stream::BufferOutputStream ss;
+  ss << "<?xml version=\"1.0\"?>\n<!-- </records> -->\n<records xmlns:r=\"urn:r\" kind='a>b'>\n";
+  for(v_int32 i = 0; i < recordsCount; i ++) {
+    ss << "  <r:record id=\"" << i << "\" note='</r:record>' q=\"'\">";
+    ss << "<name>Record &amp; name " << i << "</name>";
+    ss << "<!-- </records><x> --><data><![CDATA[</r:record><y>]]></data>";
+    ss << "<nested><a><b/></a></nested>";
+    ss << "<?pi </records>?></r:record>";
+    if(i % 3 == 0) {
+      ss << "mixed text " << i;
+    }
+    if(i % 5 == 0) {
+      ss << "<empty a=\"/>\"/>";
+    }
+    ss << "\n";
+  }
+  ss << "tail text</records>\n<!-- epilog -->\n";
+  return ss.toString();
+}
+
+oatpp::String toXml(const data::mapping::Tree& tree) {
+  data::stream::BufferOutputStream stream;
+  Serializer::Config config;
+  Serializer::State state;
+  state.config = &config;
+  state.tree = &tree;
+  state.stream = &stream;
+  Serializer::serialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return stream.toString();
+}
+
+}
+
+void DeserializerTest::onRun() {
+
+  {
+    auto result = parse("<root><a x='1'>text</a><b/></root>");
+    OATPP_ASSERT(!result.error.isSet())
+    OATPP_ASSERT(result.errorText == nullptr)
+  }
+
+  checkError(TAG, "<root>\n  <a>text</b>\n</root>", Error::Code::INVALID_CLOSING_TAG, 2, 10, "/root/a");
+  checkError(TAG, "<root>\n  <a x=1/>\n</root>", Error::Code::ATTRIBUTE_QUOTE_EXPECTED, 2, 8, "/root/a/@x");
+  checkError(TAG, "<root><a x='1/></root>", Error::Code::UNTERMINATED_ATTRIBUTE_VALUE, 1, 12, "/root/a/@x");
+  checkError(TAG, "<root>\n<a#/></root>", Error::Code::INVALID_ELEMENT_NAME, 2, 3, "/root");
+  checkError(TAG, "<root><!-- comment</root>", Error::Code::UNTERMINATED_COMMENT, 1, 7, "/root");
+  checkError(TAG, "<root><![CDATA[ data</root>", Error::Code::UNTERMINATED_CDATA, 1, 7, "/root");
+  checkError(TAG, "<root></root  x>", Error::Code::CLOSING_TAG_END_EXPECTED, 1, 15, "/root");
+  checkError(TAG, "text", Error::Code::ELEMENT_START_EXPECTED, 1, 1, "");
+
+  /* leaf elements */
+  {
+    auto result = parse("<r><a> x &amp; y </a><b>  </b><c>1</c  ><d></d></r>");
+    OATPP_ASSERT(!result.error.isSet())
+    auto& nodes = result.tree.getPairs()[0].second.getPairs();
+    OATPP_ASSERT(nodes[0].second.getString() == " x & y ")
+    OATPP_ASSERT(nodes[1].second.getType() == data::mapping::Tree::Type::UNDEFINED)
+    OATPP_ASSERT(nodes[2].second.getString() == "1")
+    OATPP_ASSERT(nodes[3].second.getType() == data::mapping::Tree::Type::UNDEFINED)
+
+    checkError(TAG, "<r><a>1</ab></r>", Error::Code::CLOSING_TAG_END_EXPECTED, 1, 11, "/r/a");
+    checkError(TAG, "<r><a>1</a x></r>", Error::Code::CLOSING_TAG_END_EXPECTED, 1, 12, "/r/a");
+  }
+
+  /* mixed content - whitespace between child nodes is not a text node */
+  {
+    auto result = parse("<m>t1<x/>t2<![CDATA[c]]> <y/> </m>");
+    OATPP_ASSERT(!result.error.isSet())
+    auto& nodes = result.tree.getPairs()[0].second.getPairs();
+    OATPP_ASSERT(nodes.size() == 5)
+    OATPP_ASSERT(nodes[0].first == "!TEXT")
+    OATPP_ASSERT(nodes[2].first == "!TEXT")
+    OATPP_ASSERT(nodes[3].first == "!CDATA")
+    OATPP_ASSERT(nodes[4].first == "y")
+  }
+
+  /* spill oversized content */
+  {
+    auto sink = std::make_shared<MemorySpillSink>();
+
+    Deserializer::Config config;
+    config.spillThreshold = 8;
+    config.spillSink = sink;
+
+    auto result = parse("<r><a>small</a><b>big &amp; text</b><c>mixed big text<x/>tail</c><![CDATA[big <cdata>]]></r>", config);
+    OATPP_ASSERT(!result.error.isSet())
+
+    auto& nodes = result.tree.getPairs()[0].second.getPairs();
+    OATPP_ASSERT(nodes[0].second.getString() == "small")
+
+    OATPP_ASSERT(nodes[1].second.getPairs()[0].first == "!SPILL")
+    OATPP_ASSERT(nodes[1].second.getPairs()[0].second.getString() == "0")
+    OATPP_ASSERT(sink->streams[0]->toString() == "big & text")
+
+    auto& mixed = nodes[2].second.getPairs();
+    OATPP_ASSERT(mixed[0].first == "!SPILL")
+    OATPP_ASSERT(sink->streams[1]->toString() == "mixed big text")
+    OATPP_ASSERT(mixed[2].first == "!TEXT")
+
+    OATPP_ASSERT(nodes[3].first == "!SPILL")
+    OATPP_ASSERT(sink->streams[2]->toString() == "big <cdata>")
+
+    OATPP_ASSERT(sink->streams.size() == 3)
+
+    /* sink which can't read content back */
+    data::stream::BufferOutputStream stream;
+    Serializer::Config serializerConfig;
+    serializerConfig.spillSink = sink;
+    Serializer::State state;
+    state.config = &serializerConfig;
+    state.tree = &result.tree;
+    state.stream = &stream;
+    Serializer::serialize(state);
+    OATPP_ASSERT(state.error.getCode() == Error::Code::SPILL_FAILED)
+
+    sink->fail = true;
+    checkError(TAG, "<r><b>big &amp; text</b></r>", Error::Code::SPILL_FAILED, 1, 7, "/r/b", config);
+  }
+
+  /* default sink - temp files */
+  {
+    Deserializer::Config config;
+    config.spillThreshold = 4;
+
+    auto result = parse("<a>text &lt;to spill&gt;</a>", config);
+    OATPP_ASSERT(!result.error.isSet())
+
+    auto path = result.tree.getPairs()[0].second.getPairs()[0].second.getString();
+    std::stringstream content;
+    {
+      std::ifstream file(path->c_str(), std::ios::binary);
+      content << file.rdbuf();
+    }
+    OATPP_ASSERT(content.str() == "text <to spill>")
+
+    /* spilled content is written back */
+    OATPP_ASSERT(toXml(result.tree) == toXml(parse("<a>text &lt;to spill&gt;</a>").tree))
+    std::remove(path->c_str());
+
+    /* content bigger than the read buffer with multibyte chars across the piece boundaries */
+    std::string text = "<a>";
+    for(v_int32 i = 0; i < 3000; i ++) text += "\xC3\xA9\xE2\x82\xAC &amp; ";
+    text += "</a>";
+    result = parse(text.c_str(), config);
+    OATPP_ASSERT(!result.error.isSet())
+    OATPP_ASSERT(toXml(result.tree) == toXml(parse(text.c_str()).tree))
+    std::remove(result.tree.getPairs()[0].second.getPairs()[0].second.getString()->c_str());
+  }
+
+  /* limits */
+  {
+    Deserializer::Config config;
+    config.maxDepth = 2;
+    OATPP_ASSERT(!parse("<a><b/></a>", config).error.isSet())
+    checkError(TAG, "<a><b><c/></b></a>", Error::Code::DEPTH_LIMIT_EXCEEDED, 1, 7, "/a/b", config);
+  }
+
+  /* no depth limit by default - a configured limit protects against deeply nested documents */
+  {
+    data::stream::BufferOutputStream ss;
+    for(v_int32 i = 0; i < 300; i ++) ss << "<a>";
+    for(v_int32 i = 0; i < 300; i ++) ss << "</a>";
+    OATPP_ASSERT(!parse(ss.toString()).error.isSet())
+
+    data::stream::BufferOutputStream deep;
+    for(v_int32 i = 0; i < 10000; i ++) deep << "<a>";
+    Deserializer::Config config;
+    config.maxDepth = 256;
+    OATPP_ASSERT(parse(deep.toString(), config).error.getCode() == Error::Code::DEPTH_LIMIT_EXCEEDED)
+  }
+
+  {
+    Deserializer::Config config;
+    config.maxNodes = 3;
+    OATPP_ASSERT(!parse("<a><b>text</b></a>", config).error.isSet())
+    checkError(TAG, "<a><b>text</b><c/></a>", Error::Code::NODES_LIMIT_EXCEEDED, 1, 15, "/a", config);
+  }
+
+  {
+    Deserializer::Config config;
+    config.maxAttributes = 2;
+    OATPP_ASSERT(!parse("<a x='1' y='2'/>", config).error.isSet())
+    checkError(TAG, "<a x='1' y='2' z='3'/>", Error::Code::ATTRIBUTES_LIMIT_EXCEEDED, 1, 16, "/a", config);
+  }
+
+  {
+    Deserializer::Config config;
+    config.maxNameLength = 4;
+    OATPP_ASSERT(!parse("<abcd abcd='1'/>", config).error.isSet())
+    checkError(TAG, "<abcde/>", Error::Code::NAME_LENGTH_LIMIT_EXCEEDED, 1, 2, "", config);
+    checkError(TAG, "<a abcde='1'/>", Error::Code::NAME_LENGTH_LIMIT_EXCEEDED, 1, 4, "/a", config);
+  }
+
+  {
+    Deserializer::Config config;
+    config.maxTextSize = 4;
+    OATPP_ASSERT(!parse("<a x='1234'>1234<![CDATA[1234]]><!--1234--></a>", config).error.isSet())
+    checkError(TAG, "<a>12345</a>", Error::Code::TEXT_SIZE_LIMIT_EXCEEDED, 1, 4, "/a", config);
+    checkError(TAG, "<a x='12345'/>", Error::Code::TEXT_SIZE_LIMIT_EXCEEDED, 1, 6, "/a/@x", config);
+    checkError(TAG, "<a><![CDATA[12345]]></a>", Error::Code::TEXT_SIZE_LIMIT_EXCEEDED, 1, 4, "/a", config);
+    checkError(TAG, "<a><!--12345--></a>", Error::Code::TEXT_SIZE_LIMIT_EXCEEDED, 1, 4, "/a", config);
+  }
+
+  {
+    Deserializer::Config config;
+    config.maxDocumentSize = 8;
+    OATPP_ASSERT(!parse("<a></a>", config).error.isSet())
+    OATPP_ASSERT(parse("<a>text</a>", config).error.getCode() == Error::Code::DOCUMENT_SIZE_LIMIT_EXCEEDED)
+  }
+
+  /* UTF-8 validation */
+  {
+    Deserializer::Config config;
+    config.validateUtf8 = true;
+    OATPP_ASSERT(!parse("<r x='\xC3\xA9t\xC3\xA9'><n\xC3\xA9>caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80</n\xC3\xA9>"
+                        "<![CDATA[\xC3\xA9]]><!--\xC3\xA9--><?pi \xC3\xA9?></r>", config).error.isSet())
+    /* not validated by default */
+    OATPP_ASSERT(!parse("<n\xC3\xA9>\xC3(</n\xC3\xA9>").error.isSet())
+    checkError(TAG, "<r><a>ab\xC3(</a></r>", Error::Code::INVALID_UTF8_SEQUENCE, 1, 9, "/r/a", config);
+    checkError(TAG, "<r>x\xED\xA0\x80<a/></r>", Error::Code::INVALID_UTF8_SEQUENCE, 1, 5, "/r", config);
+    checkError(TAG, "<r><a x='\xC0\xAF'/></r>", Error::Code::INVALID_UTF8_SEQUENCE, 1, 10, "/r/a/@x", config);
+    checkError(TAG, "<r><a\xFF/></r>", Error::Code::INVALID_UTF8_SEQUENCE, 1, 6, "/r", config);
+    checkError(TAG, "<r><![CDATA[ab\xF0\x9F]]></r>", Error::Code::INVALID_UTF8_SEQUENCE, 1, 15, "/r", config);
+    checkError(TAG, "<r><!--\x80--></r>", Error::Code::INVALID_UTF8_SEQUENCE, 1, 8, "/r", config);
+  }
+
+  /* error messages are valid UTF-8 - the excerpt isn't cut inside a sequence, invalid bytes are escaped */
+  {
+    for(v_int32 k = 0; k < 16; k ++) {
+      auto text = "<a></" + std::string(static_cast<size_t>(k), 'x') + "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\xC3\xA9\xC3\xA9\xC3\xA9>";
+      auto result = parse(text.c_str());
+      OATPP_ASSERT(result.error.isSet())
+      OATPP_ASSERT(Scanner::findInvalidUtf8(result.errorText->data(), static_cast<v_buff_size>(result.errorText->size())) == -1)
+    }
+    Deserializer::Config config;
+    config.validateUtf8 = true;
+    auto result = parse("<r>\xFF\xC3</r>", config);
+    OATPP_ASSERT(Scanner::findInvalidUtf8(result.errorText->data(), static_cast<v_buff_size>(result.errorText->size())) == -1)
+    OATPP_ASSERT(result.errorText->find("near '\\xFF\\xC3</r>'") != std::string::npos)
+  }
+
+  /* node filtering */
+  {
+    auto same = [](const char* text, const char* expected, const Deserializer::Config& config) {
+      auto result = parse(text, config);
+      OATPP_ASSERT(!result.error.isSet())
+      return toXml(result.tree) == toXml(parse(expected).tree);
+    };
+
+    Deserializer::Config config;
+    config.skipComments = true;
+    config.skipPIs = true;
+    OATPP_ASSERT(same("<?xml version='1.0'?><!--a--><r><!--b--><a>1<!--c-->2</a><?pi x?><b/></r><!--d-->",
+                      "<r><a>12</a><b/></r>", config))
+    OATPP_ASSERT(same("<r><a>x<!--c-->  <!--d-->y</a><b> <!--c--> </b></r>", "<r><a>x  y</a><b/></r>", config))
+    OATPP_ASSERT(same("<r><a>x<!--c--><i/>y</a></r>", "<r><a>x<i/>y</a></r>", config))
+    OATPP_ASSERT(!same("<r><!--b--><a/></r>", "<r><a/></r>", Deserializer::Config()))
+    checkError(TAG, "<r><!-- x</r>", Error::Code::UNTERMINATED_COMMENT, 1, 4, "/r", config);
+    checkError(TAG, "<?pi x", Error::Code::UNTERMINATED_PI, 1, 1, "", config);
+
+    /* skipped nodes are not counted */
+    config.maxNodes = 2;
+    OATPP_ASSERT(same("<r><!--a--><!--b--><!--c--><a/></r>", "<r><a/></r>", config))
+
+    Deserializer::Config merge;
+    merge.mergeCData = true;
+    OATPP_ASSERT(same("<r><a>x &amp; <![CDATA[<y>]]> z</a><b><![CDATA[only]]></b><c><![CDATA[1]]><![CDATA[2]]></c></r>",
+                      "<r><a>x &amp; &lt;y&gt; z</a><b>only</b><c>12</c></r>", merge))
+    OATPP_ASSERT(same("<r><a><![CDATA[x]]><i/></a></r>", "<r><a>x<i/></a></r>", merge))
+    OATPP_ASSERT(same("<r><a>x<![CDATA[y]]><i/>z<![CDATA[w]]><!--c-->v</a></r>", "<r><a>xy<i/>zw<!--c-->v</a></r>", merge))
+
+    /* long runs of merged pieces */
+    data::stream::BufferOutputStream ss;
+    data::stream::BufferOutputStream expected;
+    ss << "<r>";
+    for(v_int32 i = 0; i < 20000; i ++) {
+      ss << "x" << i << "<!--c--><![CDATA[&]]>";
+      expected << "x" << i << "&";
+    }
+    ss << "</r>";
+    merge.skipComments = true;
+    auto result = parse(ss.toString(), merge);
+    OATPP_ASSERT(!result.error.isSet())
+    OATPP_ASSERT(result.tree.getPairs()[0].second.getString() == expected.toString())
+  }
+
+  /* namespaces */
+  {
+    oatpp::String text =
+      "<soap:Envelope xmlns:soap='urn:soap' xmlns='urn:default'>"
+        "<soap:Body><item a:id='1' xmlns:a='urn:a' name='x'/></soap:Body>"
+      "</soap:Envelope>";
+
+    {
+      auto result = parse(text);
+      OATPP_ASSERT(!result.error.isSet())
+      OATPP_ASSERT(result.tree.getPairs()[0].first == "soap:Envelope")
+    }
+
+    {
+      Deserializer::Config config;
+      config.namespaceMode = Deserializer::NamespaceMode::LOCAL_NAME;
+      auto result = parse(text, config);
+      OATPP_ASSERT(!result.error.isSet())
+
+      auto& envelope = result.tree.getPairs()[0];
+      OATPP_ASSERT(envelope.first == "Envelope")
+      OATPP_ASSERT(envelope.second.attributes()["xmlns:soap"] == "urn:soap")
+
+      auto& body = envelope.second.getPairs()[0];
+      OATPP_ASSERT(body.first == "Body")
+
+      auto& item = body.second.getPairs()[0];
+      OATPP_ASSERT(item.first == "item")
+      OATPP_ASSERT(item.second.attributes()["id"] == "1")
+      OATPP_ASSERT(item.second.attributes()["name"] == "x")
+    }
+
+    {
+      Deserializer::Config config;
+      config.namespaceMode = Deserializer::NamespaceMode::EXPANDED_NAME;
+      auto result = parse(text, config);
+      OATPP_ASSERT(!result.error.isSet())
+
+      auto& envelope = result.tree.getPairs()[0];
+      OATPP_ASSERT(envelope.first == "{urn:soap}Envelope")
+
+      auto& body = envelope.second.getPairs()[0];
+      OATPP_ASSERT(body.first == "{urn:soap}Body")
+
+      auto& item = body.second.getPairs()[0];
+      OATPP_ASSERT(item.first == "{urn:default}item")
+      OATPP_ASSERT(item.second.attributes()["{urn:a}id"] == "1")
+      OATPP_ASSERT(item.second.attributes()["name"] == "x")
+
+      oatpp::String uri, localName;
+      NamespaceScope::splitExpandedName(item.first, uri, localName);
+      OATPP_ASSERT(uri == "urn:default")
+      OATPP_ASSERT(localName == "item")
+    }
+
+    {
+      Deserializer::Config config;
+      config.namespaceMode = Deserializer::NamespaceMode::EXPANDED_NAME;
+
+      /* prefix declared in the sibling scope is not visible */
+      checkError(TAG, "<r><a xmlns:p='urn:p'/><p:b/></r>", Error::Code::UNBOUND_NAMESPACE_PREFIX, 1, 25, "/r/p:b", config);
+      checkError(TAG, "<r><a p:x='1'/></r>", Error::Code::UNBOUND_NAMESPACE_PREFIX, 1, 5, "/r/a/@p:x", config);
+
+      /* default namespace undeclared */
+      auto result = parse("<a xmlns='urn:d'><b xmlns=''/></a>", config);
+      OATPP_ASSERT(!result.error.isSet())
+      OATPP_ASSERT(result.tree.getPairs()[0].first == "{urn:d}a")
+      OATPP_ASSERT(result.tree.getPairs()[0].second.getPairs()[0].first == "b")
+    }
+
+    /* attributes resolved to the same name */
+    {
+      Deserializer::Config config;
+      config.namespaceMode = Deserializer::NamespaceMode::LOCAL_NAME;
+      checkError(TAG, "<r xmlns:a='urn:a' xmlns:b='urn:b'><x a:id='1' b:id='2'/></r>", Error::Code::DUPLICATE_ATTRIBUTE, 1, 37, "/r/x/@b:id", config);
+      checkError(TAG, "<r xmlns:a='urn:a'><x id='1' a:id='2'/></r>", Error::Code::DUPLICATE_ATTRIBUTE, 1, 21, "/r/x/@a:id", config);
+
+      config.namespaceMode = Deserializer::NamespaceMode::EXPANDED_NAME;
+      OATPP_ASSERT(!parse("<r xmlns:a='urn:a' xmlns:b='urn:b'><x a:id='1' b:id='2'/></r>", config).error.isSet())
+      checkError(TAG, "<r xmlns:a='urn:a' xmlns:b='urn:a'><x a:id='1' b:id='2'/></r>", Error::Code::DUPLICATE_ATTRIBUTE, 1, 37, "/r/x/@b:id", config);
+    }
+
+    /* attribute order is kept when only some attributes are prefixed */
+    {
+      Deserializer::Config config;
+      config.namespaceMode = Deserializer::NamespaceMode::LOCAL_NAME;
+      auto result = parse("<x p='1' a:q='2' xmlns:a='urn:a' r='3'/>", config);
+      OATPP_ASSERT(!result.error.isSet())
+      auto& attributes = result.tree.getPairs()[0].second.attributes();
+      OATPP_ASSERT(attributes.size() == 4)
+      OATPP_ASSERT(attributes[0].first == "p")
+      OATPP_ASSERT(attributes[1].first == "q")
+      OATPP_ASSERT(attributes[2].first == "xmlns:a")
+      OATPP_ASSERT(attributes[3].first == "r")
+    }
+  }
+
+  /* typed leaves */
+  {
+    TypeHints hints(oatpp::Object<RecordsDto>::Class::getType());
+
+    oatpp::String text =
+      "<records>"
+        "<record><id> -42 </id><value>2.5</value><flag>true</flag><count>300</count><name>7</name></record>"
+        "<record><id>1<b/></id><value>x</value><flag>1</flag><count>&#50;</count></record>"
+      "</records>";
+
+    Deserializer::Config config;
+    config.parseTypedLeaves = true;
+
+    auto result = parse(text, config, hints.getRoot());
+    OATPP_ASSERT(!result.error.isSet())
+
+    auto& first = result.tree.getPairs()[0].second.getPairs()[0].second.getPairs();
+    OATPP_ASSERT(first[0].second.getType() == data::mapping::Tree::Type::INT_64)
+    OATPP_ASSERT(first[0].second.getPrimitive<v_int64>() == -42)
+    OATPP_ASSERT(first[1].second.getType() == data::mapping::Tree::Type::FLOAT_64)
+    OATPP_ASSERT(first[1].second.getPrimitive<v_float64>() == 2.5)
+    OATPP_ASSERT(first[2].second.getType() == data::mapping::Tree::Type::BOOL)
+    OATPP_ASSERT(first[2].second.getPrimitive<bool>() == true)
+
+    /* out of range for UInt8 - kept as string */
+    OATPP_ASSERT(first[3].second.getType() == data::mapping::Tree::Type::STRING)
+    OATPP_ASSERT(first[3].second.getString() == "300")
+
+    /* not a numeric field */
+    OATPP_ASSERT(first[4].second.getType() == data::mapping::Tree::Type::STRING)
+
+    auto& second = result.tree.getPairs()[0].second.getPairs()[1].second.getPairs();
+
+    /* mixed content */
+    OATPP_ASSERT(second[0].second.getType() == data::mapping::Tree::Type::PAIRS)
+    OATPP_ASSERT(second[0].second.getPairs()[0].first == "!TEXT")
+    OATPP_ASSERT(second[0].second.getPairs()[0].second.getString() == "1")
+
+    /* not a number */
+    OATPP_ASSERT(second[1].second.getType() == data::mapping::Tree::Type::STRING)
+    OATPP_ASSERT(second[1].second.getString() == "x")
+
+    OATPP_ASSERT(second[2].second.getType() == data::mapping::Tree::Type::BOOL)
+
+    /* entities are not parsed as numbers - kept as unescaped string */
+    OATPP_ASSERT(second[3].second.getType() == data::mapping::Tree::Type::STRING)
+    OATPP_ASSERT(second[3].second.getString() == "2")
+
+    /* option is off - all text is kept as strings */
+    auto plain = parse(text, Deserializer::Config(), hints.getRoot());
+    OATPP_ASSERT(plain.tree.getPairs()[0].second.getPairs()[0].second.getPairs()[0].second.getString() == " -42 ")
+  }
+
+  /* binary leaves are decoded without parseTypedLeaves */
+  {
+    TypeHints hints(oatpp::Object<BlobDto>::Class::getType());
+    OATPP_ASSERT(hints.hasBinary())
+
+    auto result = parse("<name>Zm9v</name><data>\n  Zm9v\n  YmFy\n</data>", Deserializer::Config(), hints.getRoot());
+    OATPP_ASSERT(!result.error.isSet())
+
+    auto& nodes = result.tree.getPairs();
+    OATPP_ASSERT(nodes[0].second.getString() == "Zm9v")
+    OATPP_ASSERT(nodes[1].second.getType() == data::mapping::Tree::Type::PAIRS)
+    OATPP_ASSERT(nodes[1].second.getPairs()[0].first == "!BASE64")
+    OATPP_ASSERT(nodes[1].second.getPairs()[0].second.getString() == "foobar")
+
+    /* entities - kept as string, decoded by the mapper */
+    result = parse("<data>Zm9v&#10;YmFy</data>", Deserializer::Config(), hints.getRoot());
+    OATPP_ASSERT(result.tree.getPairs()[0].second.getString() == "Zm9v\nYmFy")
+  }
+
+  /* element-name dispatch */
+  {
+    TypeHints hints(oatpp::Object<RecordsDto>::Class::getType());
+    auto records = hints.getRoot()->getChild("records");
+    OATPP_ASSERT(records != nullptr)
+    auto record = records->getChild("record");
+    OATPP_ASSERT(record != nullptr && record == records->getChild("any"))
+    OATPP_ASSERT(record->getChild("id")->getLeafType() == data::mapping::Tree::Type::INT_64)
+    OATPP_ASSERT(record->getChild("count")->getLeafType() == data::mapping::Tree::Type::UINT_8)
+    OATPP_ASSERT(record->getChild("name")->getLeafType() == data::mapping::Tree::Type::UNDEFINED)
+    OATPP_ASSERT(record->getChild("ids") == nullptr)
+    OATPP_ASSERT(record->getChild("") == nullptr)
+    OATPP_ASSERT(hints.getRoot()->getChild("record") == nullptr)
+  }
+
+  /* element-name dispatch - DTO fields of the object mapper */
+  {
+    ObjectMapper mapper;
+    mapper.deserializerConfig().xml.parseTypedLeaves = true;
+
+    oatpp::String text = "<id>7</id><note>skipped</note><value>2.5</value><flag>true</flag><count>3</count><name>seven</name>";
+    auto record = mapper.readFromString<oatpp::Object<RecordDto>>(text);
+    OATPP_ASSERT(record)
+    OATPP_ASSERT(record->id && *record->id == 7)
+    OATPP_ASSERT(record->value && *record->value == 2.5)
+    OATPP_ASSERT(record->flag && *record->flag == true)
+    OATPP_ASSERT(record->count && *record->count == 3)
+    OATPP_ASSERT(record->name == "seven")
+
+    mapper.deserializerConfig().mapper.allowUnknownFields = false;
+    utils::parser::Caret caret(text);
+    data::mapping::ErrorStack errorStack;
+    OATPP_ASSERT(!mapper.read(caret, oatpp::Object<RecordDto>::Class::getType(), errorStack))
+    OATPP_ASSERT(errorStack.stacktrace()->find("Unknown field 'note'") != std::string::npos)
+  }
+
+  /* parallel parsing - same tree as the serial parser */
+  {
+    auto text = generateTrickyDocument(2000);
+    auto expected = toXml(parse(text).tree);
+
+    for(v_int32 threads : {2, 3, 4, 7, 16}) {
+      Deserializer::Config config;
+      config.parallelThreads = threads;
+      config.parallelThreshold = 0;
+      for(auto mode : {Deserializer::NamespaceMode::NONE, Deserializer::NamespaceMode::EXPANDED_NAME}) {
+        config.namespaceMode = mode;
+        Deserializer::Config serial;
+        serial.namespaceMode = mode;
+        auto result = parse(text, config);
+        OATPP_ASSERT(!result.error.isSet())
+        OATPP_ASSERT(toXml(result.tree) == toXml(parse(text, serial).tree))
+      }
+    }
+
+    /* documents which can't be split are parsed serially */
+    Deserializer::Config config;
+    config.parallelThreads = 4;
+    config.parallelThreshold = 0;
+    OATPP_ASSERT(toXml(parse("<a>text</a>", config).tree) == "<a>text</a>")
+    OATPP_ASSERT(toXml(parse("<a/>", config).tree) == "<a></a>")
+    OATPP_ASSERT(toXml(parse("<a><b/></a>", config).tree) == "<a><b></b></a>")
+
+    OATPP_ASSERT(toXml(parse(text, config).tree) == expected)
+  }
+
+  /* parallel parsing - errors are reported as by the serial parser */
+  {
+    auto text = generateTrickyDocument(200);
+    auto position = text->find("<name>Record &amp; name 150<");
+    OATPP_ASSERT(position != std::string::npos)
+    std::string broken = *text;
+    broken.replace(position, 6, "<name ");
+
+    Deserializer::Config config;
+    config.parallelThreads = 4;
+    config.parallelThreshold = 0;
+
+    auto serial = parse(oatpp::String(broken));
+    auto parallel = parse(oatpp::String(broken), config);
+    OATPP_ASSERT(serial.error.isSet())
+    OATPP_ASSERT(parallel.error.getCode() == serial.error.getCode())
+    OATPP_ASSERT(parallel.error.getPosition() == serial.error.getPosition())
+    OATPP_ASSERT(parallel.error.getPath() == serial.error.getPath())
+    OATPP_ASSERT(parallel.errorText == serial.errorText)
+
+    /* unclosed root */
+    auto unclosed = oatpp::String(text->substr(0, text->find("tail text")));
+    OATPP_ASSERT(parse(unclosed, config).errorText == parse(unclosed).errorText)
+  }
+
+  /* parallel parsing - exceptions thrown in worker threads reach the caller */
+  {
+    auto text = generateTrickyDocument(200);
+
+    Deserializer::Config config;
+    config.parallelThreads = 4;
+    config.parallelThreshold = 0;
+    config.spillThreshold = 8;
+    config.spillSink = std::make_shared<AbortingSpillSink>();
+
+    bool thrown = false;
+    try {
+      parse(text, config);
+    } catch (SpillAbort&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown)
+
+    /* workers are still usable - also from concurrent callers */
+    config.spillThreshold = 0;
+    auto expected = toXml(parse(text).tree);
+    std::vector<std::thread> callers;
+    std::atomic<v_int32> matched(0);
+    for(v_int32 i = 0; i < 4; i ++) {
+      callers.emplace_back([&] {
+        for(v_int32 j = 0; j < 5; j ++) {
+          if(toXml(parse(text, config).tree) == expected) matched ++;
+        }
+      });
+    }
+    for(auto& caller : callers) {
+      caller.join();
+    }
+    OATPP_ASSERT(matched == 20)
+  }
+
+  /* parallel parsing - same tree for any count of threads */
+  {
+    auto text = generateRecordsDocument(200);
+    auto expected = toXml(parse(text).tree);
+
+    for(v_int32 threads : {1, 2, 4, 8}) {
+      Deserializer::Config config;
+      config.parallelThreads = threads;
+      config.parallelThreshold = 0;
+      OATPP_ASSERT(toXml(parse(text, config).tree) == expected)
+    }
+  }
+
+}
+
+}}
@@ -0,0 +1,80 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "DocumentBenchmark.hpp"
+#include "TestDocuments.hpp"
+
+#include "oatpp-xml/Document.hpp"
+
+#include "oatpp/utils/parser/Caret.hpp"
+
+#include <chrono>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+data::mapping::Tree parseTree(const oatpp::String& text, const Deserializer::Config& config) {
+  data::mapping::Tree tree;
+  utils::parser::Caret caret(text);
+  Deserializer::State state;
+  state.tree = &tree;
+  state.caret = &caret;
+  state.config = &config;
+  Deserializer::deserialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return tree;
+}
+
+Document parseDocument(const oatpp::String& text, const Deserializer::Config& config) {
+  Document document;
+  Error error;
+  OATPP_ASSERT(document.parse(text->data(), static_cast<v_buff_size>(text->size()), config, error))
+  return document;
+}
+
+}
+
+void DocumentBenchmark::onRun() {
+
+  /* tree vs document - parse time and memory */
+  {
+    auto text = generateRecordsDocument(50000);
+    Deserializer::Config config;
+
+    auto start = std::chrono::steady_clock::now();
+    auto tree = parseTree(text, config);
+    auto timeTree = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    auto document = parseDocument(text, config);
+    auto timeDocument = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_LOGd(TAG, "parse {} bytes: tree - {} us, document - {} us, document - {} nodes, {} bytes",
+               text->size(), timeTree, timeDocument, document.getNodesCount(), document.getMemoryUsage())
+  }
+
+}
+
+}}
@@ -0,0 +1,235 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "DocumentTest.hpp"
+#include "TestDocuments.hpp"
+
+#include "oatpp-xml/Document.hpp"
+#include "oatpp-xml/Serializer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/utils/parser/Caret.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+typedef data::mapping::Tree Tree;
+
+bool equals(const data::share::StringKeyLabel& label, const char* text) {
+  return label.getData() != nullptr &&
+         label.getSize() == static_cast<v_buff_size>(std::strlen(text)) &&
+         std::memcmp(label.getData(), text, static_cast<size_t>(label.getSize())) == 0;
+}
+
+Tree parseTree(const oatpp::String& text, const Deserializer::Config& config = {}) {
+  Tree tree;
+  utils::parser::Caret caret(text);
+  Deserializer::State state;
+  state.tree = &tree;
+  state.caret = &caret;
+  state.config = &config;
+  Deserializer::deserialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return tree;
+}
+
+Document parseDocument(const oatpp::String& text, const Deserializer::Config& config = {}) {
+  Document document;
+  Error error;
+  OATPP_ASSERT(document.parse(text->data(), static_cast<v_buff_size>(text->size()), config, error))
+  return document;
+}
+
+oatpp::String toXml(const Tree& tree) {
+  data::stream::BufferOutputStream stream;
+  Serializer::Config config;
+  Serializer::State state;
+  state.config = &config;
+  state.tree = &tree;
+  state.stream = &stream;
+  Serializer::serialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return stream.toString();
+}
+
+oatpp::String toXml(const Document& document) {
+  Tree tree;
+  document.toTree(tree);
+  return toXml(tree);
+}
+
+}
+
+void DocumentTest::onRun() {
+
+  /* navigation */
+  {
+    auto document = parseDocument("<?xml version=\"1.0\"?>"
+                                  "<root a=\"1\" long-attribute-name='x &lt; y'>"
+                                  "<leaf>text &amp; more</leaf><empty/>"
+                                  "<element-with-a-long-name>a long text which is not inlined</element-with-a-long-name>"
+                                  "<mixed>a<b/>c</mixed><![CDATA[<raw>]]><!--note-->"
+                                  "</root>");
+
+    auto pi = document.getFirstChild(Document::ROOT);
+    OATPP_ASSERT(equals(document.getName(pi), "?xml"))
+    OATPP_ASSERT(equals(document.getString(pi), "version=\"1.0\""))
+
+    auto root = document.getNextSibling(pi);
+    OATPP_ASSERT(equals(document.getName(root), "root"))
+    OATPP_ASSERT(document.getNextSibling(root) == Document::NONE)
+    OATPP_ASSERT(document.getType(root) == Tree::Type::PAIRS)
+    OATPP_ASSERT(document.getAttributesCount(root) == 2)
+    OATPP_ASSERT(equals(document.getAttributeName(root, 1), "long-attribute-name"))
+    OATPP_ASSERT(equals(document.getAttributeValue(root, 1), "x < y"))
+    OATPP_ASSERT(equals(document.getAttributeValue(root, "a"), "1"))
+    OATPP_ASSERT(document.getAttributeValue(root, "b").getData() == nullptr)
+
+    auto leaf = document.findChild(root, "leaf");
+    OATPP_ASSERT(document.getType(leaf) == Tree::Type::STRING)
+    OATPP_ASSERT(equals(document.getString(leaf), "text & more"))
+    OATPP_ASSERT(document.getFirstChild(leaf) == Document::NONE)
+    OATPP_ASSERT(document.getAttributesCount(leaf) == 0)
+
+    OATPP_ASSERT(document.getType(document.findChild(root, "empty")) == Tree::Type::UNDEFINED)
+    OATPP_ASSERT(equals(document.getString(document.findChild(root, "element-with-a-long-name")), "a long text which is not inlined"))
+    OATPP_ASSERT(document.findChild(root, "missing") == Document::NONE)
+
+    auto mixed = document.findChild(root, "mixed");
+    auto text = document.getFirstChild(mixed);
+    OATPP_ASSERT(equals(document.getName(text), "!TEXT"))
+    OATPP_ASSERT(equals(document.getString(text), "a"))
+    OATPP_ASSERT(equals(document.getName(document.getNextSibling(text)), "b"))
+
+    OATPP_ASSERT(equals(document.getString(document.findChild(root, "!CDATA")), "<raw>"))
+    OATPP_ASSERT(equals(document.getString(document.findChild(root, "!COMMENT")), "note"))
+  }
+
+  /* same tree as the deserializer */
+  {
+    const char* texts[] = {
+      "<a/>",
+      "<a></a>",
+      "<a>  </a>",
+      "<a>  text  </a>",
+      "<a x='1' y=\"&amp;\"><b>1</b><b>2</b><c><d>deep</d></c></a>",
+      "<?xml version='1.0'?>\n<!-- prolog -->\n<a>x <b/> y<![CDATA[z]]><?pi data?></a>\n<!-- epilog -->",
+      "<a><b>text &#x41;&#66;</b>\n  <c/>\n</a>"
+    };
+    for(auto text : texts) {
+      OATPP_ASSERT(toXml(parseDocument(text)) == toXml(parseTree(text)))
+    }
+
+    auto text = generateRecordsDocument(100);
+    OATPP_ASSERT(toXml(parseDocument(text)) == toXml(parseTree(text)))
+
+    Deserializer::Config config;
+    config.skipComments = true;
+    config.skipPIs = true;
+    config.mergeCData = true;
+    const char* filtered[] = {
+      "<?xml version='1.0'?><!--a--><r><a>1<!--c-->2</a><?pi x?><b/></r>",
+      "<r><a>x &amp; <![CDATA[<y>]]> z</a><b><![CDATA[only]]></b><c><![CDATA[1]]><![CDATA[2]]></c></r>"
+    };
+    for(auto filteredText : filtered) {
+      OATPP_ASSERT(toXml(parseDocument(filteredText, config)) == toXml(parseTree(filteredText, config)))
+    }
+  }
+
+  /* merged text grows in place */
+  {
+    std::string text = "<r>";
+    std::string expected;
+    for(v_int32 i = 0; i < 20000; i ++) {
+      text += "piece <!--c-->";
+      expected += "piece ";
+    }
+    text += "</r>";
+
+    Deserializer::Config config;
+    config.skipComments = true;
+    auto document = parseDocument(oatpp::String(text), config);
+    auto root = document.getFirstChild(Document::ROOT);
+    OATPP_ASSERT(document.getType(root) == Tree::Type::STRING)
+    OATPP_ASSERT(equals(document.getString(root), expected.c_str()))
+    OATPP_ASSERT(document.getMemoryUsage() < static_cast<v_buff_size>(expected.size() * 2))
+  }
+
+  /* tree round trip */
+  {
+    Tree tree;
+    tree.setPairs({});
+    tree.getPairs().emplace_back("root", Tree());
+    auto& root = tree.getPairs().back().second;
+    root.attributes()["id"] = "42";
+    root.setPairs({});
+    root.getPairs().emplace_back("int", Tree());
+    root.getPairs().back().second.setPrimitive<v_int32>(-7);
+    root.getPairs().emplace_back("float", Tree());
+    root.getPairs().back().second.setPrimitive<v_float64>(2.5);
+    root.getPairs().emplace_back("bool", Tree());
+    root.getPairs().back().second.setPrimitive<bool>(true);
+    root.getPairs().emplace_back("string", Tree());
+    root.getPairs().back().second.setString("a string which is longer than inline size");
+    root.getPairs().emplace_back("empty", Tree());
+
+    auto document = Document::fromTree(tree);
+    auto node = document.findChild(document.getFirstChild(Document::ROOT), "int");
+    OATPP_ASSERT(document.getType(node) == Tree::Type::INT_32)
+    OATPP_ASSERT(document.getInteger(node) == -7)
+
+    Tree result;
+    document.toTree(result);
+    OATPP_ASSERT(toXml(result) == toXml(tree))
+    OATPP_ASSERT(result.getPairs()[0].second.getPairs()[0].second.getType() == Tree::Type::INT_32)
+
+    Tree vector;
+    vector.setVector(2);
+    bool thrown = false;
+    try {
+      Document::fromTree(vector);
+    } catch (std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown)
+  }
+
+  /* errors */
+  {
+    Document document;
+    Error error;
+    oatpp::String text = "<a>\n  <b>text</ab>\n</a>";
+    OATPP_ASSERT(!document.parse(text->data(), static_cast<v_buff_size>(text->size()), {}, error))
+    OATPP_ASSERT(error.getCode() == Error::Code::INVALID_CLOSING_TAG)
+    OATPP_ASSERT(error.getPath() == "/a/b")
+    OATPP_ASSERT(document.getNodesCount() == 1)
+  }
+
+}
+
+}}
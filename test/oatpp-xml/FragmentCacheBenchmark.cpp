@@ -0,0 +1,111 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "FragmentCacheBenchmark.hpp"
+
+#include "oatpp-xml/FragmentCache.hpp"
+#include "oatpp-xml/Serializer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <chrono>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+typedef data::mapping::Tree Tree;
+
+oatpp::String toXml(const Tree& tree, const Serializer::Config& config) {
+  data::stream::BufferOutputStream stream;
+  Serializer::State state;
+  state.config = &config;
+  state.tree = &tree;
+  state.stream = &stream;
+  Serializer::serialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return stream.toString();
+}
+
+Tree makeSection(v_int32 itemsCount, const char* suffix) {
+  Tree section;
+  section.setPairs({});
+  for(v_int32 i = 0; i < itemsCount; i ++) {
+    Tree item;
+    item.setPairs({{"name", Tree(oatpp::String("item <" + std::to_string(i) + "> & " + suffix))}, {"price", Tree(i)}});
+    section.getPairs().emplace_back("item", item);
+  }
+  return section;
+}
+
+Tree makeDocument(const Tree& section, bool asFragment, v_uint64 version) {
+  Tree response;
+  response.setPairs({{"user", Tree("john")}});
+  if(asFragment) {
+    Tree catalog;
+    catalog.setPairs({{FragmentCache::NODE_NAME, FragmentCache::makeNode("catalog", version, section)}});
+    response.getPairs().emplace_back("catalog", catalog);
+  } else {
+    response.getPairs().emplace_back("catalog", section);
+  }
+  Tree document;
+  document.setPairs({{"response", response}});
+  return document;
+}
+
+}
+
+void FragmentCacheBenchmark::onRun() {
+
+  /* serialize vs cached */
+  {
+    auto section = makeSection(2000, "static");
+    auto document = makeDocument(section, true, 1);
+
+    Serializer::Config plain;
+    Serializer::Config cached;
+    cached.fragmentCache = std::make_shared<FragmentCache>();
+
+    const v_int32 iterations = 50;
+
+    auto start = std::chrono::steady_clock::now();
+    for(v_int32 i = 0; i < iterations; i ++) {
+      toXml(document, plain);
+    }
+    auto timePlain = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for(v_int32 i = 0; i < iterations; i ++) {
+      toXml(document, cached);
+    }
+    auto timeCached = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_ASSERT(toXml(document, plain) == toXml(document, cached))
+    OATPP_LOGd(TAG, "serialize {} bytes x {}: plain - {} us, fragment cache - {} us", toXml(document, plain)->size(), iterations, timePlain, timeCached)
+  }
+
+}
+
+}}
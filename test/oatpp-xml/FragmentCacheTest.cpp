@@ -0,0 +1,236 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "FragmentCacheTest.hpp"
+
+#include "oatpp-xml/FragmentCache.hpp"
+#include "oatpp-xml/ObjectMapper.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/macro/codegen.hpp"
+
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+class ItemDto : public oatpp::DTO {
+
+  DTO_INIT(ItemDto, DTO)
+
+  DTO_FIELD(String, name);
+  DTO_FIELD(String, description);
+
+};
+
+class CatalogDto : public oatpp::DTO {
+
+  DTO_INIT(CatalogDto, DTO)
+
+  DTO_FIELD(String, title);
+  DTO_FIELD(Object<ItemDto>, first);
+  DTO_FIELD(Object<ItemDto>, second);
+
+};
+
+class PlainResponseDto : public oatpp::DTO {
+
+  DTO_INIT(PlainResponseDto, DTO)
+
+  DTO_FIELD(String, user);
+  DTO_FIELD(Object<CatalogDto>, catalog);
+
+};
+
+class ResponseDto : public oatpp::DTO {
+
+  DTO_INIT(ResponseDto, DTO)
+
+  DTO_FIELD(String, user);
+  DTO_FIELD(Fragment, catalog);
+
+};
+
+#include OATPP_CODEGEN_END(DTO)
+
+typedef data::mapping::Tree Tree;
+
+oatpp::String toXml(const Tree& tree, const Serializer::Config& config) {
+  data::stream::BufferOutputStream stream;
+  Serializer::State state;
+  state.config = &config;
+  state.tree = &tree;
+  state.stream = &stream;
+  Serializer::serialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return stream.toString();
+}
+
+Tree makeSection(v_int32 itemsCount, const char* suffix) {
+  Tree section;
+  section.setPairs({});
+  for(v_int32 i = 0; i < itemsCount; i ++) {
+    Tree item;
+    item.setPairs({{"name", Tree(oatpp::String("item <" + std::to_string(i) + "> & " + suffix))}, {"price", Tree(i)}});
+    section.getPairs().emplace_back("item", item);
+  }
+  return section;
+}
+
+Tree makeDocument(const Tree& section, bool asFragment, v_uint64 version) {
+  Tree response;
+  response.setPairs({{"user", Tree("john")}});
+  if(asFragment) {
+    Tree catalog;
+    catalog.setPairs({{FragmentCache::NODE_NAME, FragmentCache::makeNode("catalog", version, section)}});
+    response.getPairs().emplace_back("catalog", catalog);
+  } else {
+    response.getPairs().emplace_back("catalog", section);
+  }
+  Tree document;
+  document.setPairs({{"response", response}});
+  return document;
+}
+
+oatpp::Object<ItemDto> makeItem(const oatpp::String& name, const oatpp::String& description) {
+  auto item = ItemDto::createShared();
+  item->name = name;
+  item->description = description;
+  return item;
+}
+
+oatpp::Object<CatalogDto> makeCatalog() {
+  auto catalog = CatalogDto::createShared();
+  catalog->title = "catalog & more";
+  catalog->first = makeItem("item <1>", "first & cheapest");
+  catalog->second = makeItem("item <2>", nullptr);
+  return catalog;
+}
+}
+
+void FragmentCacheTest::onRun() {
+
+  /* tree fragments */
+  {
+    auto section = makeSection(3, "a");
+    auto expected = toXml(makeDocument(section, false, 1), {});
+
+    /* no cache - content is written in place */
+    Serializer::Config config;
+    OATPP_ASSERT(toXml(makeDocument(section, true, 1), config) == expected)
+
+    config.fragmentCache = std::make_shared<FragmentCache>();
+    auto& cache = *config.fragmentCache;
+
+    OATPP_ASSERT(toXml(makeDocument(section, true, 1), config) == expected)
+    OATPP_ASSERT(cache.getStats().misses == 1 && cache.getStats().entries == 1)
+    OATPP_ASSERT(toXml(makeDocument(section, true, 1), config) == expected)
+    OATPP_ASSERT(cache.getStats().hits == 1)
+
+    /* same version - cached bytes are written */
+    auto changed = makeSection(3, "b");
+    OATPP_ASSERT(toXml(makeDocument(changed, true, 1), config) == expected)
+
+    /* new version */
+    OATPP_ASSERT(toXml(makeDocument(changed, true, 2), config) == toXml(makeDocument(changed, false, 2), {}))
+    OATPP_ASSERT(cache.getStats().entries == 2)
+
+    /* changed options - not served from the cache */
+    config.includeNullElements = false;
+    auto misses = cache.getStats().misses;
+    OATPP_ASSERT(toXml(makeDocument(section, true, 1), config) == toXml(makeDocument(section, false, 1), config))
+    OATPP_ASSERT(cache.getStats().misses == misses + 1)
+
+    /* no id - written in place, not cached */
+    Tree anonymous;
+    anonymous.setPairs({{FragmentCache::NODE_NAME, section}});
+    OATPP_ASSERT(toXml(anonymous, config) == toXml(section, config))
+    OATPP_ASSERT(cache.getStats().misses == misses + 1)
+  }
+
+  /* bounded size */
+  {
+    FragmentCache cache(100, 100, 1);
+    oatpp::String bytes(std::string(40, 'x'));
+    FragmentCache::OutputKey key{};
+    FragmentCache::OutputKey other{};
+    other.escapeFlags = 1;
+    cache.put("a", 1, key, bytes);
+    cache.put("b", 1, key, bytes);
+    OATPP_ASSERT(cache.get("a", 1, key))
+    cache.put("c", 1, key, bytes);
+
+    /* "b" is the least recently used */
+    OATPP_ASSERT(!cache.get("b", 1, key))
+    OATPP_ASSERT(cache.get("a", 1, key) && cache.get("c", 1, key))
+    OATPP_ASSERT(!cache.get("a", 2, key) && !cache.get("a", 1, other))
+
+    /* options are compared by value */
+    other = key;
+    OATPP_ASSERT(cache.get("a", 1, other))
+    other.useBeautifier = true;
+    other.beautifierIndent = "\t";
+    OATPP_ASSERT(!cache.get("a", 1, other))
+
+    auto stats = cache.getStats();
+    OATPP_ASSERT(stats.evictions == 1 && stats.entries == 2 && stats.size == 80)
+
+    /* too big */
+    cache.put("d", 1, key, oatpp::String(std::string(101, 'x')));
+    OATPP_ASSERT(!cache.get("d", 1, key))
+
+    cache.clear();
+    OATPP_ASSERT(cache.getStats().entries == 0 && cache.getStats().size == 0)
+  }
+
+  /* DTO fragments */
+  {
+    ObjectMapper mapper;
+    mapper.serializerConfig().xml.fragmentCache = std::make_shared<FragmentCache>();
+
+    auto catalog = makeCatalog();
+
+    auto plain = PlainResponseDto::createShared();
+    plain->user = "john";
+    plain->catalog = catalog;
+    auto expected = mapper.writeToString(plain);
+
+    auto response = ResponseDto::createShared();
+    response->user = "john";
+    response->catalog = Fragment("catalog", 1, catalog);
+
+    OATPP_ASSERT(mapper.writeToString(response) == expected)
+    OATPP_ASSERT(mapper.writeToString(response) == expected)
+    OATPP_ASSERT(mapper.serializerConfig().xml.fragmentCache->getStats().hits == 1)
+
+    /* fragment as the top-level value */
+    OATPP_ASSERT(mapper.writeToString(Fragment("top", 1, catalog)) == mapper.writeToString(catalog))
+  }
+
+}
+
+}}
@@ -0,0 +1,105 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "NameIndexBenchmark.hpp"
+
+#include "oatpp-xml/Deserializer.hpp"
+#include "oatpp-xml/NameIndex.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/utils/parser/Caret.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+typedef data::mapping::Tree Tree;
+
+Tree parseTree(const oatpp::String& text) {
+  Deserializer::Config config;
+  Tree tree;
+  utils::parser::Caret caret(text);
+  Deserializer::State state;
+  state.tree = &tree;
+  state.caret = &caret;
+  state.config = &config;
+  Deserializer::deserialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return tree;
+}
+
+oatpp::String generateRecord(v_int32 fieldsCount, v_int32 itemsCount) {
+  data::stream::BufferOutputStream ss;
+  ss << "<record>";
+  for(v_int32 i = 0; i < fieldsCount; i ++) {
+    ss << "<field" << i << ">" << i << "</field" << i << ">";
+    if(i < itemsCount) {
+      ss << "<item>" << i << "</item>";
+    }
+  }
+  ss << "</record>";
+  return ss.toString();
+}
+
+}
+
+void NameIndexBenchmark::onRun() {
+
+  /* linear scan vs index on a wide record */
+  {
+    const v_int32 fieldsCount = 2000;
+    auto tree = parseTree(generateRecord(fieldsCount, 0));
+    auto& record = tree.getPairs()[0].second;
+
+    std::vector<oatpp::String> names;
+    for(v_int32 i = 0; i < fieldsCount; i ++) {
+      names.push_back("field" + std::to_string(i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    v_int64 sum = 0;
+    for(auto& name : names) {
+      sum += NameIndex::findFirst(record, name, nullptr)->getString()->size();
+    }
+    auto timeLinear = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    NameIndex::Registry registry;
+    start = std::chrono::steady_clock::now();
+    v_int64 indexedSum = 0;
+    for(auto& name : names) {
+      indexedSum += NameIndex::findFirst(record, name, &registry)->getString()->size();
+    }
+    auto timeIndexed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_ASSERT(sum == indexedSum)
+    OATPP_LOGd(TAG, "lookup of {} fields: linear scan - {} us, index - {} us (including build)", fieldsCount, timeLinear, timeIndexed)
+  }
+
+}
+
+}}
@@ -0,0 +1,223 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "NameIndexTest.hpp"
+
+#include "oatpp-xml/Deserializer.hpp"
+#include "oatpp-xml/NameIndex.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/utils/parser/Caret.hpp"
+
+#include <string>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+typedef data::mapping::Tree Tree;
+
+Tree parseTree(const oatpp::String& text) {
+  Deserializer::Config config;
+  Tree tree;
+  utils::parser::Caret caret(text);
+  Deserializer::State state;
+  state.tree = &tree;
+  state.caret = &caret;
+  state.config = &config;
+  Deserializer::deserialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return tree;
+}
+
+oatpp::String generateRecord(v_int32 fieldsCount, v_int32 itemsCount) {
+  data::stream::BufferOutputStream ss;
+  ss << "<record>";
+  for(v_int32 i = 0; i < fieldsCount; i ++) {
+    ss << "<field" << i << ">" << i << "</field" << i << ">";
+    if(i < itemsCount) {
+      ss << "<item>" << i << "</item>";
+    }
+  }
+  ss << "</record>";
+  return ss.toString();
+}
+
+}
+
+void NameIndexTest::onRun() {
+
+  /* lookup */
+  {
+    Tree node;
+    node.setPairs({{"a", Tree("1")}, {"b", Tree("2")}, {"a", Tree("3")}, {"c", Tree("4")}, {"a", Tree("5")}, {"", Tree("6")}});
+
+    NameIndex index(node);
+    OATPP_ASSERT(index.getNamesCount() == 4)
+
+    auto range = index.find("a");
+    OATPP_ASSERT(range.count == 3)
+    std::vector<v_uint32> positions(range.begin(), range.end());
+    OATPP_ASSERT((positions == std::vector<v_uint32>{0, 2, 4}))
+
+    OATPP_ASSERT(index.find("b").count == 1 && index.find("b").positions[0] == 1)
+    OATPP_ASSERT(index.find("c").positions[0] == 3)
+    OATPP_ASSERT(index.find("", 0).positions[0] == 5)
+    OATPP_ASSERT(index.find("d").empty())
+    OATPP_ASSERT(index.find("ab").empty())
+    OATPP_ASSERT(index.find(oatpp::String(nullptr)).empty())
+
+    Tree empty;
+    empty.setPairs({});
+    OATPP_ASSERT(NameIndex(empty).find("a").empty())
+
+    bool thrown = false;
+    try {
+      NameIndex leafIndex(Tree("text"));
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown)
+  }
+
+  /* lazy indexing */
+  {
+    auto tree = parseTree(generateRecord(100, 10));
+    auto& record = tree.getPairs()[0].second;
+
+    NameIndex::Registry registry(50);
+    OATPP_ASSERT(registry.get(tree) == nullptr)
+    OATPP_ASSERT(registry.get(record.getPairs()[0].second) == nullptr)
+    OATPP_ASSERT(registry.size() == 0)
+
+    auto index = registry.get(record);
+    OATPP_ASSERT(index != nullptr)
+    OATPP_ASSERT(registry.get(record) == index)
+    OATPP_ASSERT(registry.size() == 1)
+    OATPP_ASSERT(index->find("item").count == 10)
+    OATPP_ASSERT(record.getPairs()[index->find("item").positions[9]].second.getString() == "9")
+
+    auto field = NameIndex::findFirst(record, "field42", &registry);
+    OATPP_ASSERT(field && field->getString() == "42")
+    field = NameIndex::findFirst(record, "field42", nullptr);
+    OATPP_ASSERT(field && field->getString() == "42")
+    OATPP_ASSERT(NameIndex::findFirst(record, "missing", &registry) == nullptr)
+    OATPP_ASSERT(NameIndex::findFirst(record, "missing", nullptr) == nullptr)
+
+    registry.clear();
+    OATPP_ASSERT(registry.size() == 0)
+  }
+
+  /* indexing the whole tree */
+  {
+    NameIndex::Registry registry(50);
+    data::stream::BufferOutputStream ss;
+    ss << "<root>" << generateRecord(100, 0) << generateRecord(10, 0) << generateRecord(60, 60) << "</root>";
+    auto tree = parseTree(ss.toString());
+    registry.build(tree);
+    OATPP_ASSERT(registry.size() == 2)
+
+    auto& root = tree.getPairs()[0].second;
+    auto index = registry.get(root.getPairs()[2].second);
+    OATPP_ASSERT(index != nullptr && index->find("item").count == 60)
+    OATPP_ASSERT(registry.size() == 2)
+  }
+
+  /* stale indices are rebuilt */
+  {
+    NameIndex::Registry registry(50);
+
+    /* node changed */
+    auto tree = parseTree(generateRecord(100, 0));
+    auto& record = tree.getPairs()[0].second;
+    auto index = registry.get(record);
+    OATPP_ASSERT(index->getChildrenCount() == 100)
+    record.getPairs().emplace_back("extra", Tree("x"));
+    auto field = NameIndex::findFirst(record, "extra", &registry);
+    OATPP_ASSERT(field && field->getString() == "x")
+    OATPP_ASSERT(registry.get(record)->getChildrenCount() == 101)
+    OATPP_ASSERT(index->getChildrenCount() == 100)
+
+    /* keys renamed in place - positions are checked */
+    record.getPairs()[0].first = "renamed";
+    OATPP_ASSERT(NameIndex::findFirst(record, "field0", &registry) == nullptr)
+    OATPP_ASSERT(NameIndex::findFirst(record, "renamed", nullptr) != nullptr)
+
+    /* other document at the same address */
+    tree = parseTree(generateRecord(100, 100));
+    auto& other = tree.getPairs()[0].second;
+    auto otherIndex = registry.get(other);
+    OATPP_ASSERT(otherIndex->find("item").count == 100)
+
+    /* moved tree */
+    Tree moved = std::move(other);
+    field = NameIndex::findFirst(moved, "item", &registry);
+    OATPP_ASSERT(field && field->getString() == "0")
+    OATPP_ASSERT(registry.get(moved)->find("field99").count == 1)
+  }
+
+  /* bounded registry */
+  {
+    NameIndex::Registry registry(50, 2);
+    OATPP_ASSERT(registry.getMaxEntries() == 2)
+
+    std::vector<Tree> trees;
+    for(v_int32 i = 0; i < 5; i ++) {
+      trees.push_back(parseTree(generateRecord(100, i)));
+    }
+    for(auto& tree : trees) {
+      OATPP_ASSERT(registry.get(tree.getPairs()[0].second))
+      OATPP_ASSERT(registry.size() <= 2)
+    }
+
+    /* recently used index is kept, least recently used is evicted */
+    auto& last = trees[4].getPairs()[0].second;
+    auto lastIndex = registry.get(last);
+    registry.get(trees[3].getPairs()[0].second);
+    OATPP_ASSERT(registry.get(last) == lastIndex)
+    registry.get(trees[0].getPairs()[0].second);
+    OATPP_ASSERT(registry.size() == 2)
+    OATPP_ASSERT(registry.get(last) == lastIndex)
+
+    /* evicted node is indexed again */
+    auto& first = trees[1].getPairs()[0].second;
+    auto field = NameIndex::findFirst(first, "item", &registry);
+    OATPP_ASSERT(field && field->getString() == "0")
+    OATPP_ASSERT(registry.size() == 2)
+
+    /* build keeps the cap */
+    Tree root;
+    root.setPairs({});
+    for(v_int32 i = 0; i < 5; i ++) {
+      root.getPairs().emplace_back("record", parseTree(generateRecord(100, 0)).getPairs()[0].second);
+    }
+    registry.clear();
+    registry.build(root);
+    OATPP_ASSERT(registry.size() == 2)
+  }
+
+}
+
+}}
@@ -0,0 +1,79 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#include "NameTableBenchmark.hpp"
+
+#include "oatpp-xml/NameTable.hpp"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+void NameTableBenchmark::onRun() {
+
+  /* 60 DTO-like field names - perfect table vs std::unordered_map */
+  {
+    std::vector<std::pair<std::string, v_int32>> fields;
+    const char* words[] = {"id", "name", "title", "description", "createdAt", "updatedAt", "owner", "status",
+                           "priority", "type", "value", "amount", "currency", "country", "city", "street",
+                           "zip", "phone", "email", "url", "tags", "notes", "flags", "count", "total"};
+    for(v_int32 i = 0; i < 60; i ++) {
+      fields.emplace_back(std::string(words[i % 25]) + (i < 25 ? "" : std::to_string(i / 25)), i);
+    }
+    NameTable<v_int32> fieldsTable(fields);
+    OATPP_ASSERT(fieldsTable.isPerfect())
+    std::unordered_map<std::string, v_int32> fieldsMap(fields.begin(), fields.end());
+
+    std::vector<oatpp::String> names;
+    for(auto& field : fields) {
+      names.push_back(field.first);
+    }
+
+    v_int64 sumTable = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(v_int32 k = 0; k < 20000; k ++) {
+      for(auto& name : names) {
+        sumTable += *fieldsTable.find(*name);
+      }
+    }
+    auto timeTable = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    v_int64 sumMap = 0;
+    start = std::chrono::steady_clock::now();
+    for(v_int32 k = 0; k < 20000; k ++) {
+      for(auto& name : names) {
+        sumMap += fieldsMap.find(*name)->second;
+      }
+    }
+    auto timeMap = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_ASSERT(sumTable == sumMap)
+    OATPP_LOGd(TAG, "resolve 60 field names x 20000: name table - {} us, std::unordered_map - {} us", timeTable, timeMap)
+  }
+
+}
+
+}}
@@ -0,0 +1,115 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#include "NameTableTest.hpp"
+
+#include "oatpp-xml/NameTable.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+void NameTableTest::onRun() {
+
+  /* empty table */
+  {
+    NameTable<v_int32> table;
+    OATPP_ASSERT(table.empty() && table.size() == 0)
+    OATPP_ASSERT(table.find("a") == nullptr)
+    OATPP_ASSERT(table.find("", 0) == nullptr)
+
+    NameTable<v_int32> built(std::vector<std::pair<std::string, v_int32>>{});
+    OATPP_ASSERT(built.empty() && built.find("a") == nullptr)
+  }
+
+  /* single name */
+  {
+    NameTable<v_int32> table({{"a", 1}});
+    OATPP_ASSERT(table.isPerfect() && table.size() == 1)
+    OATPP_ASSERT(*table.find("a") == 1)
+    OATPP_ASSERT(table.find("b") == nullptr)
+    OATPP_ASSERT(table.find("aa") == nullptr)
+    OATPP_ASSERT(table.find("", 0) == nullptr)
+  }
+
+  /* DTO-like field names - perfect table */
+  {
+    std::vector<std::pair<std::string, v_int32>> items;
+    const char* words[] = {"id", "name", "title", "description", "createdAt", "updatedAt", "owner", "status",
+                           "priority", "type", "value", "amount", "currency", "country", "city", "street",
+                           "zip", "phone", "email", "url", "tags", "notes", "flags", "count", "total"};
+    for(v_int32 i = 0; i < 60; i ++) {
+      items.emplace_back(std::string(words[i % 25]) + (i < 25 ? "" : std::to_string(i / 25)), i);
+    }
+    NameTable<v_int32> table(items);
+    OATPP_ASSERT(table.isPerfect() && table.size() == 60)
+    for(auto& item : items) {
+      OATPP_ASSERT(*table.find(item.first) == item.second)
+    }
+
+    /* misses - other names, prefixes, case */
+    OATPP_ASSERT(table.find("ids") == nullptr)
+    OATPP_ASSERT(table.find("nam") == nullptr)
+    OATPP_ASSERT(table.find("Name") == nullptr)
+    OATPP_ASSERT(table.find("total3") == nullptr)
+    OATPP_ASSERT(table.find("", 0) == nullptr)
+  }
+
+  /* names sharing length, first, middle and last characters - fall back to the full hash */
+  {
+    std::vector<std::pair<std::string, v_int32>> items;
+    for(v_int32 i = 0; i < 200; i ++) {
+      char name[16];
+      std::snprintf(name, sizeof(name), "f_%03d_x", i);
+      items.emplace_back(name, i);
+    }
+    items.emplace_back("f_000_x", -1);
+    NameTable<v_int32> table(items);
+    OATPP_ASSERT(table.size() == 200)
+    OATPP_ASSERT(*table.find("f_000_x") == -1)
+    for(v_int32 i = 1; i < 200; i ++) {
+      OATPP_ASSERT(*table.find(items[i].first) == i)
+    }
+    OATPP_ASSERT(table.find("f_200_x") == nullptr)
+    OATPP_ASSERT(table.find("f_00_x") == nullptr)
+  }
+
+  /* full hashes collide too - imperfect table with linear probing */
+  {
+    /* "axxb" and "ayxb" share the sampled hash, "costarring" and "liquid" share FNV-1a */
+    NameTable<v_int32> table({{"axxb", 1}, {"ayxb", 2}, {"costarring", 3}, {"liquid", 4}});
+    OATPP_ASSERT(!table.isPerfect() && table.size() == 4)
+    OATPP_ASSERT(*table.find("axxb") == 1)
+    OATPP_ASSERT(*table.find("ayxb") == 2)
+    OATPP_ASSERT(*table.find("costarring") == 3)
+    OATPP_ASSERT(*table.find("liquid") == 4)
+    OATPP_ASSERT(table.find("azxb") == nullptr)
+    OATPP_ASSERT(table.find("liquids") == nullptr)
+    OATPP_ASSERT(table.find("", 0) == nullptr)
+  }
+
+}
+
+}}
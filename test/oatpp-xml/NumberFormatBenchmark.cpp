@@ -0,0 +1,101 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "NumberFormatBenchmark.hpp"
+
+#include "oatpp-xml/NumberFormat.hpp"
+
+#include "oatpp/utils/Conversion.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+void NumberFormatBenchmark::onRun() {
+
+  /* format and parse against utils::Conversion and the standard library */
+  {
+    const v_int32 count = 1000000;
+
+    std::mt19937_64 random(42);
+    std::vector<v_int64> integers(count);
+    std::vector<v_float64> floats(count);
+    for(v_int32 i = 0; i < count; i ++) {
+      integers[i] = static_cast<v_int64>(random() >> (random() % 64));
+      floats[i] = static_cast<v_float64>(integers[i] % 1000000) / 1000.0;
+    }
+
+    char buffer[100];
+    v_buff_size total = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for(auto value : integers) total += utils::Conversion::int64ToCharSequence(value, reinterpret_cast<p_char8>(buffer), 100);
+    auto timeConversionInt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for(auto value : integers) total += NumberFormat::formatInt64(value, buffer);
+    auto timeFormatInt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for(auto value : floats) total += utils::Conversion::float64ToCharSequence(value, reinterpret_cast<p_char8>(buffer), 100);
+    auto timeConversionFloat = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for(auto value : floats) total += NumberFormat::formatFloat64(value, buffer);
+    auto timeFormatFloat = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<std::string> texts(count);
+    for(v_int32 i = 0; i < count; i ++) {
+      texts[i] = std::to_string(integers[i]);
+    }
+
+    v_int64 sum = 0;
+
+    start = std::chrono::steady_clock::now();
+    for(auto& text : texts) sum += std::strtoll(text.c_str(), nullptr, 10);
+    auto timeStrtoll = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for(auto& text : texts) {
+      v_int64 value;
+      NumberFormat::parseInt64(text.data(), static_cast<v_buff_size>(text.size()), value);
+      sum -= value;
+    }
+    auto timeParseInt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_ASSERT(sum == 0)
+
+    OATPP_LOGd(TAG, "{} integers: Conversion - {} us, NumberFormat - {} us", count, timeConversionInt, timeFormatInt)
+    OATPP_LOGd(TAG, "{} integers parse: strtoll - {} us, NumberFormat - {} us", count, timeStrtoll, timeParseInt)
+    OATPP_LOGd(TAG, "{} floats: Conversion - {} us, NumberFormat - {} us", count, timeConversionFloat, timeFormatFloat)
+    OATPP_LOGd(TAG, "total size {}", total)
+  }
+
+}
+
+}}
@@ -0,0 +1,221 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "NumberFormatTest.hpp"
+
+#include "oatpp-xml/NumberFormat.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+std::string formatInt64(v_int64 value) {
+  char buffer[NumberFormat::MAX_SIZE];
+  return std::string(buffer, static_cast<size_t>(NumberFormat::formatInt64(value, buffer)));
+}
+
+std::string formatUInt64(v_uint64 value) {
+  char buffer[NumberFormat::MAX_SIZE];
+  return std::string(buffer, static_cast<size_t>(NumberFormat::formatUInt64(value, buffer)));
+}
+
+void checkFloat64(v_float64 value) {
+  char buffer[NumberFormat::MAX_SIZE + 1];
+  auto size = NumberFormat::formatFloat64(value, buffer);
+  OATPP_ASSERT(size > 0 && size <= NumberFormat::MAX_SIZE)
+  buffer[size] = 0;
+  auto parsed = std::strtod(buffer, nullptr);
+  OATPP_ASSERT(std::memcmp(&parsed, &value, sizeof(value)) == 0)
+}
+
+void checkFloat32(v_float32 value) {
+  char buffer[NumberFormat::MAX_SIZE + 1];
+  auto size = NumberFormat::formatFloat32(value, buffer);
+  OATPP_ASSERT(size > 0 && size <= NumberFormat::MAX_SIZE)
+  buffer[size] = 0;
+  auto parsed = std::strtof(buffer, nullptr);
+  OATPP_ASSERT(std::memcmp(&parsed, &value, sizeof(value)) == 0)
+}
+
+bool parseUInt64(const std::string& text, v_uint64& value) {
+  return NumberFormat::parseUInt64(text.data(), static_cast<v_buff_size>(text.size()), value);
+}
+
+bool parseInt64(const std::string& text, v_int64& value) {
+  return NumberFormat::parseInt64(text.data(), static_cast<v_buff_size>(text.size()), value);
+}
+
+}
+
+void NumberFormatTest::onRun() {
+
+  /* integers */
+  {
+    OATPP_ASSERT(formatInt64(0) == "0")
+    OATPP_ASSERT(formatInt64(-1) == "-1")
+    OATPP_ASSERT(formatInt64(std::numeric_limits<v_int64>::min()) == "-9223372036854775808")
+    OATPP_ASSERT(formatInt64(std::numeric_limits<v_int64>::max()) == "9223372036854775807")
+    OATPP_ASSERT(formatUInt64(std::numeric_limits<v_uint64>::max()) == "18446744073709551615")
+
+    /* every digit count and its boundaries */
+    v_uint64 power = 1;
+    for(v_int32 i = 0; i < 20; i ++) {
+      OATPP_ASSERT(formatUInt64(power) == std::to_string(power))
+      OATPP_ASSERT(formatUInt64(power - 1) == std::to_string(power - 1))
+      OATPP_ASSERT(formatUInt64(power + 1) == std::to_string(power + 1))
+      OATPP_ASSERT(formatInt64(-static_cast<v_int64>(power / 2)) == std::to_string(-static_cast<v_int64>(power / 2)))
+      if(i < 19) power *= 10;
+    }
+
+    std::mt19937_64 random(42);
+    for(v_int32 i = 0; i < 1000000; i ++) {
+      auto bits = random();
+      /* spread values across all magnitudes */
+      auto value = bits >> (random() % 64);
+      OATPP_ASSERT(formatUInt64(value) == std::to_string(value))
+      OATPP_ASSERT(formatInt64(static_cast<v_int64>(bits)) == std::to_string(static_cast<v_int64>(bits)))
+    }
+  }
+
+  /* floats - round-trip */
+  {
+    checkFloat64(0.0);
+    checkFloat64(-0.0);
+    checkFloat64(std::numeric_limits<v_float64>::min());
+    checkFloat64(std::numeric_limits<v_float64>::denorm_min());
+    checkFloat64(std::numeric_limits<v_float64>::max());
+    checkFloat64(std::numeric_limits<v_float64>::lowest());
+    checkFloat64(std::numeric_limits<v_float64>::epsilon());
+    checkFloat64(0.1);
+    checkFloat64(1.0 / 3.0);
+
+    checkFloat32(0.0f);
+    checkFloat32(std::numeric_limits<v_float32>::min());
+    checkFloat32(std::numeric_limits<v_float32>::denorm_min());
+    checkFloat32(std::numeric_limits<v_float32>::max());
+    checkFloat32(std::numeric_limits<v_float32>::lowest());
+    checkFloat32(0.1f);
+
+    char buffer[NumberFormat::MAX_SIZE];
+    OATPP_ASSERT(std::string(buffer, static_cast<size_t>(NumberFormat::formatFloat64(0.1, buffer))) == "0.1")
+    OATPP_ASSERT(std::string(buffer, static_cast<size_t>(NumberFormat::formatFloat32(0.1f, buffer))) == "0.1")
+
+    /* random bit patterns cover the full range of exponents */
+    std::mt19937_64 random(42);
+    for(v_int32 i = 0; i < 1000000; i ++) {
+
+      auto bits64 = random();
+      v_float64 value64;
+      std::memcpy(&value64, &bits64, sizeof(value64));
+      if(std::isfinite(value64)) {
+        checkFloat64(value64);
+      }
+
+      auto bits32 = static_cast<v_uint32>(bits64 >> 32);
+      v_float32 value32;
+      std::memcpy(&value32, &bits32, sizeof(value32));
+      if(std::isfinite(value32)) {
+        checkFloat32(value32);
+      }
+
+    }
+  }
+
+  /* integers - parse */
+  {
+    v_uint64 u;
+    v_int64 s;
+
+    OATPP_ASSERT(parseUInt64("0", u) && u == 0)
+    OATPP_ASSERT(parseUInt64("00000000000000000001", u) && u == 1)
+    OATPP_ASSERT(parseUInt64("18446744073709551615", u) && u == std::numeric_limits<v_uint64>::max())
+    OATPP_ASSERT(!parseUInt64("18446744073709551616", u))
+    OATPP_ASSERT(!parseUInt64("99999999999999999999", u))
+    OATPP_ASSERT(!parseUInt64("100000000000000000000", u))
+    OATPP_ASSERT(!parseUInt64("", u))
+    OATPP_ASSERT(!parseUInt64("-1", u))
+    OATPP_ASSERT(!parseUInt64("1 ", u))
+
+    /* non-digit at every position of the eight-digit blocks */
+    for(size_t i = 0; i < 16; i ++) {
+      for(char c : {'/', ':', ' ', 'a', '\x80'}) {
+        std::string text(16, '5');
+        text[i] = c;
+        OATPP_ASSERT(!parseUInt64(text, u))
+      }
+    }
+
+    OATPP_ASSERT(parseInt64("-9223372036854775808", s) && s == std::numeric_limits<v_int64>::min())
+    OATPP_ASSERT(parseInt64("+9223372036854775807", s) && s == std::numeric_limits<v_int64>::max())
+    OATPP_ASSERT(!parseInt64("9223372036854775808", s))
+    OATPP_ASSERT(!parseInt64("-9223372036854775809", s))
+    OATPP_ASSERT(!parseInt64("-", s))
+    OATPP_ASSERT(!parseInt64("--1", s))
+
+    std::mt19937_64 random(42);
+    for(v_int32 i = 0; i < 1000000; i ++) {
+      auto bits = random();
+      auto value = bits >> (random() % 64);
+      OATPP_ASSERT(parseUInt64(std::to_string(value), u) && u == value)
+      OATPP_ASSERT(parseInt64(std::to_string(static_cast<v_int64>(bits)), s) && s == static_cast<v_int64>(bits))
+    }
+  }
+
+  /* floats - parse */
+  {
+    v_float64 d;
+    v_float32 f;
+
+    OATPP_ASSERT(NumberFormat::parseFloat64("2.5", 3, d) && d == 2.5)
+    OATPP_ASSERT(NumberFormat::parseFloat64("-1e10", 5, d) && d == -1e10)
+    OATPP_ASSERT(NumberFormat::parseFloat32("0.1", 3, f) && f == 0.1f)
+    OATPP_ASSERT(!NumberFormat::parseFloat64("", 0, d))
+    OATPP_ASSERT(!NumberFormat::parseFloat64("1.5x", 4, d))
+    OATPP_ASSERT(!NumberFormat::parseFloat64("x", 1, d))
+
+    /* formatted values parse back to the same bits */
+    std::mt19937_64 random(42);
+    char buffer[NumberFormat::MAX_SIZE];
+    for(v_int32 i = 0; i < 100000; i ++) {
+      auto bits = random();
+      v_float64 value;
+      std::memcpy(&value, &bits, sizeof(value));
+      if(std::isfinite(value)) {
+        auto size = NumberFormat::formatFloat64(value, buffer);
+        OATPP_ASSERT(NumberFormat::parseFloat64(buffer, size, d))
+        OATPP_ASSERT(std::memcmp(&d, &value, sizeof(value)) == 0)
+      }
+    }
+  }
+
+}
+
+}}
@@ -0,0 +1,182 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ObjectSerializerTest.hpp"
+
+#include "oatpp-xml/ObjectMapper.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/macro/codegen.hpp"
+#include "oatpp/utils/Conversion.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+class InnerDto : public oatpp::DTO {
+
+  DTO_INIT(InnerDto, DTO)
+
+  DTO_FIELD(String, name);
+  DTO_FIELD(Int32, value);
+
+};
+
+class OuterDto : public oatpp::DTO {
+
+  DTO_INIT(OuterDto, DTO)
+
+  DTO_FIELD(String, title);
+  DTO_FIELD(Object<InnerDto>, inner);
+  DTO_FIELD(List<Object<InnerDto>>, list);
+  DTO_FIELD(Fields<String>, map);
+
+};
+
+class BlobDto : public oatpp::DTO {
+
+  DTO_INIT(BlobDto, DTO)
+
+  DTO_FIELD(String, name);
+  DTO_FIELD(Binary, data);
+
+};
+
+#include OATPP_CODEGEN_END(DTO)
+
+oatpp::Object<InnerDto> createInner(const oatpp::String& name, v_int32 value) {
+  auto inner = InnerDto::createShared();
+  inner->name = name;
+  inner->value = value;
+  return inner;
+}
+
+oatpp::Object<OuterDto> createOuter(v_int32 index) {
+  auto outer = OuterDto::createShared();
+  outer->title = "title <" + utils::Conversion::int32ToStr(index) + "> & \"quoted\"";
+  outer->inner = createInner("inner", index);
+  outer->list = {createInner("a", 1), nullptr, createInner(nullptr, 3)};
+  outer->map = {{"key1", "value1"}, {"key2", nullptr}};
+  return outer;
+}
+
+/* reference output - map to tree first, then serialize the tree */
+oatpp::String writeThroughTree(const ObjectMapper& mapper, const oatpp::Void& value) {
+
+  data::mapping::Tree tree;
+  data::mapping::ObjectToTreeMapper objectToTreeMapper;
+  data::mapping::ObjectToTreeMapper::State mapperState;
+  mapperState.config = &mapper.serializerConfig().mapper;
+  mapperState.tree = &tree;
+  objectToTreeMapper.map(mapperState, value);
+  OATPP_ASSERT(mapperState.errorStack.empty())
+
+  data::stream::BufferOutputStream stream;
+  Serializer::State state;
+  state.config = &mapper.serializerConfig().xml;
+  state.tree = &tree;
+  state.stream = &stream;
+  Serializer::serialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+
+  return stream.toString();
+
+}
+
+}
+
+void ObjectSerializerTest::onRun() {
+
+  /* same output as through the tree */
+  for(bool includeNullFields : {true, false}) {
+    for(bool includeNullElements : {true, false}) {
+
+      ObjectMapper mapper;
+      mapper.serializerConfig().mapper.includeNullFields = includeNullFields;
+      mapper.serializerConfig().xml.includeNullElements = includeNullElements;
+
+      auto object = createOuter(1);
+      auto list = oatpp::List<oatpp::Object<OuterDto>>({createOuter(1), nullptr, createOuter(2)});
+
+      auto xml = mapper.writeToString(object);
+      OATPP_LOGd(TAG, "xml='{}'", xml)
+      OATPP_ASSERT(xml == writeThroughTree(mapper, object))
+
+      OATPP_ASSERT(mapper.writeToString(list) == writeThroughTree(mapper, list))
+
+    }
+  }
+
+  /* binary fields - base64 in, base64 out */
+  {
+    ObjectMapper mapper;
+
+    auto blob = BlobDto::createShared();
+    blob->name = "blob";
+    blob->data = Binary(std::string("foob\0ar", 7));
+
+    auto xml = mapper.writeToString(blob);
+    OATPP_ASSERT(xml == "<name>blob</name><data>Zm9vYgBhcg==</data>")
+
+    for(auto text : {xml, oatpp::String("<name>blob</name><data>\n Zm9vYgBh\n cg==\n</data>")}) {
+      auto result = mapper.readFromString<oatpp::Object<BlobDto>>(text);
+      OATPP_ASSERT(result->name == "blob")
+      OATPP_ASSERT(*result->data == std::string("foob\0ar", 7))
+    }
+
+    /* text with entities is kept as a string by the parser and decoded by the mapper */
+    auto result = mapper.readFromString<oatpp::Object<BlobDto>>("<data>Zm9vYgBh&#10;cg==</data>");
+    OATPP_ASSERT(*result->data == std::string("foob\0ar", 7))
+  }
+
+  /* tag cache shared between threads */
+  {
+    ObjectMapper mapper;
+
+    auto list = oatpp::List<oatpp::Object<OuterDto>>::createShared();
+    for(v_int32 i = 0; i < 100; i ++) {
+      list->push_back(createOuter(i));
+    }
+    auto expected = writeThroughTree(mapper, list);
+
+    std::vector<std::thread> threads;
+    for(v_int32 i = 0; i < 8; i ++) {
+      threads.emplace_back([&mapper, &list, &expected] {
+        for(v_int32 j = 0; j < 10; j ++) {
+          OATPP_ASSERT(mapper.writeToString(list) == expected)
+        }
+      });
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+}
+
+}}
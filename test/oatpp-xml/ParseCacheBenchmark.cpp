@@ -0,0 +1,124 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ParseCacheBenchmark.hpp"
+#include "TestDocuments.hpp"
+
+#include "oatpp-xml/ObjectMapper.hpp"
+#include "oatpp-xml/ParseCache.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/macro/codegen.hpp"
+
+#include <chrono>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+class LimitsDto : public oatpp::DTO {
+
+  DTO_INIT(LimitsDto, DTO)
+
+  DTO_FIELD(String, requests);
+  DTO_FIELD(String, storage);
+  DTO_FIELD(String, users);
+
+};
+
+class TenantDto : public oatpp::DTO {
+
+  DTO_INIT(TenantDto, DTO)
+
+  DTO_FIELD(String, id);
+  DTO_FIELD(String, name);
+  DTO_FIELD(String, region);
+  DTO_FIELD(String, description);
+  DTO_FIELD(Object<LimitsDto>, limits);
+
+};
+
+#include OATPP_CODEGEN_END(DTO)
+
+oatpp::String generateTenant(v_int32 descriptionLines) {
+  data::stream::BufferOutputStream ss;
+  ss << "<id>t-1</id><name>tenant &amp; co</name><region>eu-west</region><description>";
+  for(v_int32 i = 0; i < descriptionLines; i ++) {
+    ss << "line " << i << " of the tenant &lt;description&gt;\n";
+  }
+  ss << "</description><limits><requests>1000</requests><storage>10G</storage><users>50</users></limits>";
+  return ss.toString();
+}
+
+template<class T>
+v_int64 timeReads(const ObjectMapper& mapper, const oatpp::String& text, v_int32 iterations) {
+  auto start = std::chrono::steady_clock::now();
+  for(v_int32 i = 0; i < iterations; i ++) {
+    OATPP_ASSERT(mapper.readFromString<T>(text))
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+void ParseCacheBenchmark::onRun() {
+
+  /* tree - a hit makes the tree of the cached document */
+  {
+    const v_int32 iterations = 50;
+    auto text = generateRecordsDocument(500);
+
+    ObjectMapper plain;
+    ObjectMapper cached;
+    cached.deserializerConfig().cache = std::make_shared<ParseCache>();
+
+    auto timeParse = timeReads<oatpp::Tree>(plain, text, iterations);
+    auto timeCached = timeReads<oatpp::Tree>(cached, text, iterations);
+
+    OATPP_LOGd(TAG, "tree {} bytes x {}: parse - {} us, cache - {} us", text->size(), iterations, timeParse, timeCached)
+  }
+
+  /* DTO - a hit copies the value mapped before */
+  for(v_int32 lines : {1, 100}) {
+    const v_int32 iterations = 1000;
+    auto text = generateTenant(lines);
+
+    ObjectMapper plain;
+    ObjectMapper cached;
+    cached.deserializerConfig().cache = std::make_shared<ParseCache>();
+
+    auto timeParse = timeReads<oatpp::Object<TenantDto>>(plain, text, iterations);
+    auto timeCached = timeReads<oatpp::Object<TenantDto>>(cached, text, iterations);
+
+    auto stats = cached.deserializerConfig().cache->getStats();
+    OATPP_ASSERT(stats.hits == static_cast<v_uint64>(iterations - 1))
+
+    OATPP_LOGd(TAG, "DTO {} bytes x {}: parse and map - {} us, cache - {} us", text->size(), iterations, timeParse, timeCached)
+  }
+
+}
+
+}}
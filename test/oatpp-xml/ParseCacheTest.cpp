@@ -0,0 +1,332 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ParseCacheTest.hpp"
+
+#include "oatpp-xml/ObjectMapper.hpp"
+#include "oatpp-xml/ParseCache.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/macro/codegen.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+class FlagDto : public oatpp::DTO {
+
+  DTO_INIT(FlagDto, DTO)
+
+  DTO_FIELD(String, name);
+  DTO_FIELD(String, rollout);
+
+};
+
+#include OATPP_CODEGEN_END(DTO)
+
+oatpp::String generateConfig(v_int32 flagsCount) {
+  data::stream::BufferOutputStream ss;
+  ss << "<?xml version=\"1.0\"?>\n<flags>\n";
+  for(v_int32 i = 0; i < flagsCount; i ++) {
+    ss << "  <flag name=\"feature-" << i << "\" tenant=\"t" << i % 7 << "\"><enabled>" << (i % 2 == 0 ? "true" : "false")
+       << "</enabled><rollout>" << i % 100 << "</rollout><description>flag &amp; description " << i << "</description></flag>\n";
+  }
+  ss << "</flags>\n";
+  return ss.toString();
+}
+
+}
+
+void ParseCacheTest::onRun() {
+
+  auto treeType = oatpp::Tree::Class::getType();
+  auto stringType = oatpp::String::Class::getType();
+
+  /* hash */
+  {
+    std::string text = "<root><a>1</a><b>2</b><c>3</c><d>4</d><e>5</e></root>";
+    auto hash = ParseCache::hash(text.data(), static_cast<v_buff_size>(text.size()));
+    OATPP_ASSERT(hash == ParseCache::hash(text.data(), static_cast<v_buff_size>(text.size())))
+    OATPP_ASSERT(hash != ParseCache::hash(text.data(), static_cast<v_buff_size>(text.size()) - 1))
+    OATPP_ASSERT(ParseCache::hash("", 0) != ParseCache::hash("a", 1))
+
+    /* a change of any byte changes the hash */
+    for(size_t i = 0; i < text.size(); i ++) {
+      auto changed = text;
+      changed[i] ^= 1;
+      OATPP_ASSERT(hash != ParseCache::hash(changed.data(), static_cast<v_buff_size>(changed.size())))
+    }
+  }
+
+  /* get / put / LRU */
+  {
+    ParseCache cache(2, 1024, 1);
+    ParseCache::ConfigKey config;
+    oatpp::String a = "<a/>";
+    oatpp::String b = "<b/>";
+    oatpp::String c = "<c/>";
+    auto hashA = ParseCache::hash(a->data(), static_cast<v_buff_size>(a->size()));
+    auto hashB = ParseCache::hash(b->data(), static_cast<v_buff_size>(b->size()));
+    auto hashC = ParseCache::hash(c->data(), static_cast<v_buff_size>(c->size()));
+    auto documentA = std::make_shared<Document>();
+    auto documentB = std::make_shared<Document>();
+    auto documentC = std::make_shared<Document>();
+
+    OATPP_ASSERT(!cache.get(hashA, a->data(), static_cast<v_buff_size>(a->size()), treeType, config))
+
+    cache.put(hashA, a->data(), static_cast<v_buff_size>(a->size()), treeType, config, documentA);
+    cache.put(hashB, b->data(), static_cast<v_buff_size>(b->size()), treeType, config, documentB);
+
+    OATPP_ASSERT(cache.get(hashA, a->data(), static_cast<v_buff_size>(a->size()), treeType, config) == documentA)
+
+    /* same input, other type */
+    OATPP_ASSERT(!cache.get(hashA, a->data(), static_cast<v_buff_size>(a->size()), stringType, config))
+
+    /* same hash, other content */
+    OATPP_ASSERT(!cache.get(hashA, b->data(), static_cast<v_buff_size>(b->size()), treeType, config))
+
+    /* B is the least recently used */
+    cache.put(hashC, c->data(), static_cast<v_buff_size>(c->size()), treeType, config, documentC);
+    OATPP_ASSERT(!cache.get(hashB, b->data(), static_cast<v_buff_size>(b->size()), treeType, config))
+    OATPP_ASSERT(cache.get(hashA, a->data(), static_cast<v_buff_size>(a->size()), treeType, config))
+    OATPP_ASSERT(cache.get(hashC, c->data(), static_cast<v_buff_size>(c->size()), treeType, config))
+
+    auto stats = cache.getStats();
+    OATPP_ASSERT(stats.hits == 3)
+    OATPP_ASSERT(stats.misses == 4)
+    OATPP_ASSERT(stats.evictions == 1)
+    OATPP_ASSERT(stats.entries == 2)
+
+    cache.clear();
+    OATPP_ASSERT(cache.getStats().entries == 0)
+    OATPP_ASSERT(!cache.get(hashA, a->data(), static_cast<v_buff_size>(a->size()), treeType, config))
+
+    /* too big */
+    ParseCache small(16, 2);
+    small.put(hashA, a->data(), static_cast<v_buff_size>(a->size()), treeType, config, documentA);
+    OATPP_ASSERT(small.getStats().entries == 0)
+  }
+
+  /* config is a part of the key */
+  {
+    ParseCache cache;
+    oatpp::String text = "<a/>";
+    auto hash = ParseCache::hash(text->data(), static_cast<v_buff_size>(text->size()));
+    auto size = static_cast<v_buff_size>(text->size());
+
+    Deserializer::Config config;
+    auto key = ParseCache::getConfigKey(config);
+    auto document = std::make_shared<Document>();
+    cache.put(hash, text->data(), size, treeType, key, document);
+    OATPP_ASSERT(cache.get(hash, text->data(), size, treeType, ParseCache::getConfigKey(config)) == document)
+
+    /* options which don't change the tree */
+    config.parallelThreads = 4;
+    OATPP_ASSERT(cache.get(hash, text->data(), size, treeType, ParseCache::getConfigKey(config)) == document)
+
+    Deserializer::Config skip;
+    skip.skipComments = true;
+    OATPP_ASSERT(!cache.get(hash, text->data(), size, treeType, ParseCache::getConfigKey(skip)))
+
+    Deserializer::Config limited;
+    limited.maxDepth = 1;
+    OATPP_ASSERT(ParseCache::getConfigKey(limited) != key)
+    OATPP_ASSERT(!cache.get(hash, text->data(), size, treeType, ParseCache::getConfigKey(limited)))
+
+    Deserializer::Config namespaced;
+    namespaced.namespaceMode = Deserializer::NamespaceMode::LOCAL_NAME;
+    OATPP_ASSERT(!cache.get(hash, text->data(), size, treeType, ParseCache::getConfigKey(namespaced)))
+  }
+
+  /* object mapper */
+  {
+    auto mapper = std::make_shared<ObjectMapper>();
+    mapper->deserializerConfig().cache = std::make_shared<ParseCache>();
+    auto& cache = *mapper->deserializerConfig().cache;
+
+    oatpp::String text = "<config><a>1</a><b>2</b></config>";
+    auto first = mapper->readFromString<oatpp::Tree>(text);
+    auto second = mapper->readFromString<oatpp::Tree>(text);
+    OATPP_ASSERT(cache.getStats().hits == 1 && cache.getStats().misses == 1)
+    OATPP_ASSERT(mapper->writeToString(second) == mapper->writeToString(first))
+
+    /* every reader gets its own tree */
+    OATPP_ASSERT(first.get() != second.get())
+    second->getPairs()[0].second.getPairs()[0].second.setString("changed");
+    auto third = mapper->readFromString<oatpp::Tree>(oatpp::String(text->data(), static_cast<v_buff_size>(text->size())));
+    OATPP_ASSERT(mapper->writeToString(third) == mapper->writeToString(first))
+    OATPP_ASSERT(cache.getStats().hits == 2)
+
+    auto other = mapper->readFromString<oatpp::Tree>("<config><a>1</a><b>3</b></config>");
+    OATPP_ASSERT(mapper->writeToString(other) != mapper->writeToString(first))
+
+    /* errors are not cached */
+    for(v_int32 i = 0; i < 2; i ++) {
+      bool thrown = false;
+      try {
+        mapper->readFromString<oatpp::Tree>("<config><a></b></config>");
+      } catch (const std::runtime_error&) {
+        thrown = true;
+      }
+      OATPP_ASSERT(thrown)
+    }
+    OATPP_ASSERT(cache.getStats().entries == 2)
+  }
+
+  /* mapped values - returned to their owner only */
+  {
+    ParseCache cache;
+    ParseCache::ConfigKey config;
+    oatpp::String text = "<a/>";
+    auto hash = ParseCache::hash(text->data(), static_cast<v_buff_size>(text->size()));
+    auto size = static_cast<v_buff_size>(text->size());
+    auto document = std::make_shared<Document>();
+    auto owner = std::make_shared<v_uint8>(0);
+    auto other = std::make_shared<v_uint8>(0);
+    oatpp::Void mapped = oatpp::String("mapped");
+
+    cache.put(hash, text->data(), size, stringType, config, document, owner, mapped);
+
+    oatpp::Void value;
+    OATPP_ASSERT(cache.get(hash, text->data(), size, stringType, config, owner, value) == document)
+    OATPP_ASSERT(value.get() == mapped.get())
+
+    value = nullptr;
+    OATPP_ASSERT(cache.get(hash, text->data(), size, stringType, config, other, value) == document)
+    OATPP_ASSERT(!value)
+    OATPP_ASSERT(cache.get(hash, text->data(), size, stringType, config, nullptr, value) == document)
+    OATPP_ASSERT(!value)
+
+    /* owner is gone - a new owner at the same address doesn't get the value */
+    owner.reset();
+    owner = std::make_shared<v_uint8>(0);
+    OATPP_ASSERT(cache.get(hash, text->data(), size, stringType, config, owner, value) == document)
+    OATPP_ASSERT(!value)
+  }
+
+  /* object mapper - DTOs are not shared */
+  {
+    ObjectMapper mapper;
+    mapper.deserializerConfig().cache = std::make_shared<ParseCache>();
+
+    oatpp::String text = "<name>flag</name><rollout>10</rollout>";
+    auto first = mapper.readFromString<oatpp::Object<FlagDto>>(text);
+    auto second = mapper.readFromString<oatpp::Object<FlagDto>>(text);
+    OATPP_ASSERT(mapper.deserializerConfig().cache->getStats().hits == 1)
+    OATPP_ASSERT(first.get() != second.get())
+    OATPP_ASSERT(first->name == "flag" && second->name == "flag")
+    OATPP_ASSERT(first->name.get() != second->name.get())
+    first->name = "changed";
+    *second->rollout = "20";
+    auto third = mapper.readFromString<oatpp::Object<FlagDto>>(text);
+    OATPP_ASSERT(third->name == "flag" && third->rollout == "10")
+    OATPP_ASSERT(mapper.deserializerConfig().cache->getStats().hits == 2)
+  }
+
+  /* object mapper - values are kept per mapper options */
+  {
+    auto cache = std::make_shared<ParseCache>();
+    ObjectMapper lenient;
+    lenient.deserializerConfig().cache = cache;
+    ObjectMapper strict;
+    strict.deserializerConfig().cache = cache;
+    strict.deserializerConfig().mapper.allowUnknownFields = false;
+
+    oatpp::String text = "<name>flag</name><extra>1</extra>";
+    OATPP_ASSERT(lenient.readFromString<oatpp::Object<FlagDto>>(text)->name == "flag")
+    OATPP_ASSERT(lenient.readFromString<oatpp::Object<FlagDto>>(text)->name == "flag")
+
+    utils::parser::Caret caret(text);
+    data::mapping::ErrorStack errorStack;
+    OATPP_ASSERT(!strict.read(caret, oatpp::Object<FlagDto>::Class::getType(), errorStack))
+    OATPP_ASSERT(!errorStack.empty())
+    OATPP_ASSERT(cache->getStats().hits == 2)
+
+    /* options changed */
+    lenient.deserializerConfig().mapper.allowUnknownFields = false;
+    utils::parser::Caret other(text);
+    errorStack = data::mapping::ErrorStack();
+    OATPP_ASSERT(!lenient.read(other, oatpp::Object<FlagDto>::Class::getType(), errorStack))
+  }
+
+  /* one cache shared by mappers with different configs */
+  {
+    auto cache = std::make_shared<ParseCache>();
+    ObjectMapper plain;
+    plain.deserializerConfig().cache = cache;
+    ObjectMapper filtering;
+    filtering.deserializerConfig().cache = cache;
+    filtering.deserializerConfig().xml.skipComments = true;
+
+    oatpp::String text = "<a>1<!--note-->2</a>";
+    auto withComments = plain.readFromString<oatpp::Tree>(text);
+    auto withoutComments = filtering.readFromString<oatpp::Tree>(text);
+    OATPP_ASSERT(withComments->getPairs()[0].second.getType() == data::mapping::Tree::Type::PAIRS)
+    OATPP_ASSERT(withoutComments->getPairs()[0].second.getString() == "12")
+    OATPP_ASSERT(cache->getStats().hits == 0 && cache->getStats().entries == 2)
+  }
+
+  /* concurrent readers */
+  {
+    auto mapper = std::make_shared<ObjectMapper>();
+    mapper->deserializerConfig().cache = std::make_shared<ParseCache>();
+
+    std::vector<oatpp::String> texts;
+    for(v_int32 i = 0; i < 32; i ++) {
+      texts.push_back(generateConfig(i + 1));
+    }
+
+    std::atomic<v_int32> failures(0);
+    std::vector<std::thread> threads;
+    for(v_int32 t = 0; t < 4; t ++) {
+      threads.emplace_back([&, t] {
+        for(v_int32 k = 0; k < 200; k ++) {
+          auto& text = texts[static_cast<size_t>((k + t) % 32)];
+          auto tree = mapper->readFromString<oatpp::Tree>(text);
+          if(!tree || tree->getPairs().size() != 2) {
+            failures ++;
+          }
+        }
+      });
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+
+    OATPP_ASSERT(failures == 0)
+    auto stats = mapper->deserializerConfig().cache->getStats();
+    OATPP_ASSERT(stats.hits + stats.misses == 800)
+    OATPP_ASSERT(stats.entries == 32)
+  }
+
+}
+
+}}
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "PullReaderBenchmark.hpp"
+
+#include "oatpp-xml/PullReader.hpp"
+#include "oatpp-xml/Deserializer.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+typedef PullReader::Token Token;
+
+bool equals(const data::share::StringKeyLabel& label, const char* text) {
+  return label.getSize() == static_cast<v_buff_size>(std::strlen(text)) &&
+         std::memcmp(label.getData(), text, static_cast<size_t>(label.getSize())) == 0;
+}
+
+/* envelope with a small header and a big body */
+oatpp::String generateEnvelope(v_int32 itemsCount) {
+  std::string data = "<?xml version=\"1.0\"?>"
+                     "<Envelope><Header><route id=\"r-1\" target=\"orders&amp;billing\"/><priority>7</priority></Header><Body>";
+  for(v_int32 i = 0; i < itemsCount; i ++) {
+    data += "<item id=\"" + std::to_string(i) + "\"><name>item-" + std::to_string(i) + "</name><price>" + std::to_string(i * 10) + "</price></item>";
+  }
+  data += "</Body></Envelope>";
+  return oatpp::String(data);
+}
+
+}
+
+void PullReaderBenchmark::onRun() {
+
+  /* peek at the header of a big envelope vs full tree parse */
+  {
+    auto text = generateEnvelope(100000);
+
+    auto start = std::chrono::steady_clock::now();
+    oatpp::String target;
+    oatpp::String priority;
+    {
+      PullReader reader(text);
+      /* stop as soon as the header is read - the body is never scanned */
+      for(auto token = reader.next(); token != Token::END_DOCUMENT && !priority; token = reader.next()) {
+        OATPP_ASSERT(token != Token::FAILURE)
+        if(token != Token::START_ELEMENT) {
+          continue;
+        }
+        if(equals(reader.getName(), "route")) {
+          target = reader.getAttributeValue("target");
+        } else if(equals(reader.getName(), "priority")) {
+          OATPP_ASSERT(reader.next() == Token::TEXT)
+          priority = reader.getText();
+        }
+      }
+    }
+    auto timePeek = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_ASSERT(target == "orders&billing")
+    OATPP_ASSERT(priority == "7")
+
+    start = std::chrono::steady_clock::now();
+    v_int64 count = 0;
+    {
+      PullReader reader(text);
+      for(auto token = reader.next(); token != Token::END_DOCUMENT; token = reader.next()) {
+        OATPP_ASSERT(token != Token::FAILURE)
+        count ++;
+      }
+    }
+    auto timePull = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    {
+      Deserializer::Config config;
+      data::mapping::Tree tree;
+      utils::parser::Caret caret(text);
+      Deserializer::State state;
+      state.tree = &tree;
+      state.caret = &caret;
+      state.config = &config;
+      Deserializer::deserialize(state);
+      OATPP_ASSERT(!state.error.isSet())
+    }
+    auto timeTree = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_LOGd(TAG, "{} bytes: peek header - {} us, pull all {} tokens - {} us, tree - {} us",
+               text->size(), timePeek, count, timePull, timeTree)
+  }
+
+}
+
+}}
@@ -0,0 +1,222 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "PullReaderTest.hpp"
+
+#include "oatpp-xml/PullReader.hpp"
+#include "oatpp-xml/Deserializer.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+typedef PullReader::Token Token;
+
+bool equals(const data::share::StringKeyLabel& label, const char* text) {
+  return label.getSize() == static_cast<v_buff_size>(std::strlen(text)) &&
+         std::memcmp(label.getData(), text, static_cast<size_t>(label.getSize())) == 0;
+}
+
+/* envelope with a small header and a big body */
+oatpp::String generateEnvelope(v_int32 itemsCount) {
+  std::string data = "<?xml version=\"1.0\"?>"
+                     "<Envelope><Header><route id=\"r-1\" target=\"orders&amp;billing\"/><priority>7</priority></Header><Body>";
+  for(v_int32 i = 0; i < itemsCount; i ++) {
+    data += "<item id=\"" + std::to_string(i) + "\"><name>item-" + std::to_string(i) + "</name><price>" + std::to_string(i * 10) + "</price></item>";
+  }
+  data += "</Body></Envelope>";
+  return oatpp::String(data);
+}
+
+}
+
+void PullReaderTest::onRun() {
+
+  /* token sequence */
+  {
+    PullReader reader("<?xml version=\"1.0\"?>\n"
+                      "<root a=\"1\" b='x &lt; y'>\n"
+                      "  <!--note-->\n"
+                      "  <text>a &amp; b</text>\n"
+                      "  <empty/>\n"
+                      "  <![CDATA[<raw>]]>\n"
+                      "</root>");
+
+    OATPP_ASSERT(reader.next() == Token::PI)
+    OATPP_ASSERT(equals(reader.getName(), "xml"))
+    OATPP_ASSERT(equals(reader.getRawText(), "version=\"1.0\""))
+
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "root"))
+    OATPP_ASSERT(reader.getDepth() == 1)
+    OATPP_ASSERT(reader.getAttributes().size() == 2)
+    OATPP_ASSERT(equals(reader.getAttributes()[1].name, "b"))
+    OATPP_ASSERT(equals(reader.getAttributes()[1].rawValue, "x &lt; y"))
+    OATPP_ASSERT(reader.getAttributeValue("a") == "1")
+    OATPP_ASSERT(reader.getAttributeValue(1) == "x < y")
+    OATPP_ASSERT(reader.getAttributeValue("c") == nullptr)
+
+    OATPP_ASSERT(reader.next() == Token::COMMENT)
+    OATPP_ASSERT(reader.getText() == "note")
+
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "text"))
+    OATPP_ASSERT(reader.getDepth() == 2)
+    OATPP_ASSERT(reader.getAttributes().empty())
+    OATPP_ASSERT(reader.next() == Token::TEXT)
+    OATPP_ASSERT(equals(reader.getRawText(), "a &amp; b"))
+    OATPP_ASSERT(reader.getText() == "a & b")
+    OATPP_ASSERT(reader.next() == Token::END_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "text"))
+    OATPP_ASSERT(reader.getDepth() == 2)
+
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "empty"))
+    OATPP_ASSERT(reader.isEmptyElement())
+    OATPP_ASSERT(reader.next() == Token::END_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "empty"))
+    OATPP_ASSERT(!reader.isEmptyElement())
+
+    OATPP_ASSERT(reader.next() == Token::CDATA)
+    OATPP_ASSERT(reader.getText() == "<raw>")
+
+    OATPP_ASSERT(reader.next() == Token::END_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "root"))
+    OATPP_ASSERT(reader.getDepth() == 1)
+
+    OATPP_ASSERT(reader.next() == Token::END_DOCUMENT)
+    OATPP_ASSERT(reader.getDepth() == 0)
+    OATPP_ASSERT(reader.next() == Token::END_DOCUMENT)
+    OATPP_ASSERT(!reader.getError().isSet())
+  }
+
+  /* skipped comments and PIs */
+  {
+    Deserializer::Config config;
+    config.skipComments = true;
+    config.skipPIs = true;
+    PullReader reader("<?xml version=\"1.0\"?><!--a--><r><!--b--><?pi x?><e/></r><!--c-->", config);
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "r"))
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "e"))
+    OATPP_ASSERT(reader.next() == Token::END_ELEMENT)
+    OATPP_ASSERT(reader.next() == Token::END_ELEMENT)
+    OATPP_ASSERT(reader.next() == Token::END_DOCUMENT)
+    OATPP_ASSERT(!reader.getError().isSet())
+  }
+
+  /* skip element */
+  {
+    PullReader reader("<a><b><c>1</c><c/></b><d>2</d></a>");
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "b"))
+    OATPP_ASSERT(reader.skipElement())
+    OATPP_ASSERT(reader.getToken() == Token::END_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "b"))
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(equals(reader.getName(), "d"))
+    OATPP_ASSERT(reader.next() == Token::TEXT)
+    OATPP_ASSERT(reader.getText() == "2")
+  }
+
+  /* errors */
+  {
+    PullReader reader("<a>\n  <b>text</ab>\n</a>");
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(reader.next() == Token::TEXT)
+    OATPP_ASSERT(reader.next() == Token::FAILURE)
+    OATPP_ASSERT(reader.next() == Token::FAILURE)
+    OATPP_ASSERT(reader.getError().getCode() == Error::Code::INVALID_CLOSING_TAG)
+    OATPP_ASSERT(reader.getError().getPath() == "/a/b")
+    OATPP_LOGd(TAG, "{}", reader.getErrorMessage())
+  }
+
+  {
+    PullReader reader("<a><b attr=1/></a>");
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(reader.next() == Token::FAILURE)
+    OATPP_ASSERT(reader.getError().getCode() == Error::Code::ATTRIBUTE_QUOTE_EXPECTED)
+    OATPP_ASSERT(reader.getError().getPath() == "/a/b/@attr")
+  }
+
+  {
+    PullReader reader("<a><b>text</b>");
+    while(reader.next() != Token::FAILURE) {
+      OATPP_ASSERT(reader.getToken() != Token::END_DOCUMENT)
+    }
+    OATPP_ASSERT(reader.getError().getCode() == Error::Code::INVALID_CLOSING_TAG)
+  }
+
+  {
+    PullReader reader("text<a/>");
+    OATPP_ASSERT(reader.next() == Token::FAILURE)
+    OATPP_ASSERT(reader.getError().getCode() == Error::Code::ELEMENT_START_EXPECTED)
+  }
+
+  {
+    Deserializer::Config config;
+    config.maxDepth = 2;
+    PullReader reader("<a><b><c/></b></a>", config);
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(reader.next() == Token::START_ELEMENT)
+    OATPP_ASSERT(reader.next() == Token::FAILURE)
+    OATPP_ASSERT(reader.getError().getCode() == Error::Code::DEPTH_LIMIT_EXCEEDED)
+  }
+
+  /* peek at the header of an envelope - the body is never scanned */
+  {
+    auto text = generateEnvelope(100);
+
+    oatpp::String target;
+    oatpp::String priority;
+    v_int64 count = 0;
+    PullReader reader(text);
+    for(auto token = reader.next(); token != Token::END_DOCUMENT && !priority; token = reader.next()) {
+      OATPP_ASSERT(token != Token::FAILURE)
+      count ++;
+      if(token != Token::START_ELEMENT) {
+        continue;
+      }
+      if(equals(reader.getName(), "route")) {
+        target = reader.getAttributeValue("target");
+      } else if(equals(reader.getName(), "priority")) {
+        OATPP_ASSERT(reader.next() == Token::TEXT)
+        priority = reader.getText();
+      }
+    }
+
+    OATPP_ASSERT(target == "orders&billing")
+    OATPP_ASSERT(priority == "7")
+    OATPP_ASSERT(count < 10)
+  }
+
+}
+
+}}
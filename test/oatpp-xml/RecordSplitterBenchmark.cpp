@@ -0,0 +1,131 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "RecordSplitterBenchmark.hpp"
+
+#include "oatpp-xml/ParserPool.hpp"
+#include "oatpp-xml/RecordSplitter.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/* documents with markup which looks like document boundaries */
+std::vector<std::string> generateRecords(v_int32 count) {
+  std::vector<std::string> records;
+  records.reserve(static_cast<size_t>(count));
+  for(v_int32 i = 0; i < count; i ++) {
+    std::string record;
+    if(i % 4 == 0) {
+      record += "<?xml version=\"1.0\"?>\n<!-- </event> -->\n";
+    }
+    record += "<event id=\"" + std::to_string(i) + "\" note='a>b' q=\"'</event>\">";
+    record += "<name>event &amp; " + std::to_string(i) + "</name>";
+    record += "<data><![CDATA[</event><event>]]></data>";
+    record += "<?pi </event> ?><empty a=\"/>\"/>";
+    record += "</event>";
+    if(i % 7 == 0) {
+      record = "<single id=\"" + std::to_string(i) + "\"/>";
+    }
+    records.push_back(record);
+  }
+  return records;
+}
+
+std::string concat(const std::vector<std::string>& records) {
+  std::string stream;
+  for(size_t i = 0; i < records.size(); i ++) {
+    stream += records[i];
+    stream += i % 3 == 0 ? "\n" : (i % 3 == 1 ? "" : " \r\n\t");
+  }
+  return stream;
+}
+
+}
+
+void RecordSplitterBenchmark::onRun() {
+
+  auto mapper = std::make_shared<ObjectMapper>();
+
+  /* split + parse in a single thread vs split + parser pool */
+  {
+    auto batch = concat(generateRecords(50000));
+
+    auto start = std::chrono::steady_clock::now();
+    v_int64 count = 0;
+    {
+      RecordSplitter splitter;
+      splitter.feed(batch.data(), static_cast<v_buff_size>(batch.size()));
+      oatpp::String record;
+      while(splitter.next(record)) {
+        count ++;
+      }
+    }
+    auto timeSplit = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    {
+      RecordSplitter splitter;
+      splitter.feed(batch.data(), static_cast<v_buff_size>(batch.size()));
+      oatpp::String record;
+      while(splitter.next(record)) {
+        OATPP_ASSERT(mapper->readFromString<oatpp::Tree>(record))
+      }
+    }
+    auto timeSerial = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_LOGd(TAG, "{} records, {} bytes: split - {} us, split + parse - {} us", count, batch.size(), timeSplit, timeSerial)
+
+    for(v_int32 threads : {1, 2, 4, 8}) {
+      start = std::chrono::steady_clock::now();
+      {
+        ParserPool pool(mapper, oatpp::Tree::Class::getType(), threads, 1024, false);
+        std::thread producer([&] {
+          RecordSplitter splitter;
+          splitter.feed(batch.data(), static_cast<v_buff_size>(batch.size()));
+          oatpp::String record;
+          while(splitter.next(record)) {
+            pool.submit(record);
+          }
+          pool.close();
+        });
+        ParserPool::Result result;
+        while(pool.take(result)) {
+          OATPP_ASSERT(result.value)
+        }
+        producer.join();
+      }
+      auto timePool = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+      OATPP_LOGd(TAG, "split + parser pool, {} threads - {} us", threads, timePool)
+    }
+  }
+
+}
+
+}}
@@ -0,0 +1,244 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "RecordSplitterTest.hpp"
+
+#include "oatpp-xml/ParserPool.hpp"
+#include "oatpp-xml/RecordSplitter.hpp"
+#include "oatpp-xml/Serializer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/* documents with markup which looks like document boundaries */
+std::vector<std::string> generateRecords(v_int32 count) {
+  std::vector<std::string> records;
+  records.reserve(static_cast<size_t>(count));
+  for(v_int32 i = 0; i < count; i ++) {
+    std::string record;
+    if(i % 4 == 0) {
+      record += "<?xml version=\"1.0\"?>\n<!-- </event> -->\n";
+    }
+    record += "<event id=\"" + std::to_string(i) + "\" note='a>b' q=\"'</event>\">";
+    record += "<name>event &amp; " + std::to_string(i) + "</name>";
+    record += "<data><![CDATA[</event><event>]]></data>";
+    record += "<?pi </event> ?><empty a=\"/>\"/>";
+    record += "</event>";
+    if(i % 7 == 0) {
+      record = "<single id=\"" + std::to_string(i) + "\"/>";
+    }
+    records.push_back(record);
+  }
+  return records;
+}
+
+std::string concat(const std::vector<std::string>& records) {
+  std::string stream;
+  for(size_t i = 0; i < records.size(); i ++) {
+    stream += records[i];
+    stream += i % 3 == 0 ? "\n" : (i % 3 == 1 ? "" : " \r\n\t");
+  }
+  return stream;
+}
+
+oatpp::String toXml(const oatpp::Void& value) {
+  OATPP_ASSERT(value.getValueType() == oatpp::Tree::Class::getType())
+  data::stream::BufferOutputStream stream;
+  Serializer::Config config;
+  Serializer::State state;
+  state.config = &config;
+  state.tree = static_cast<const data::mapping::Tree*>(value.get());
+  state.stream = &stream;
+  Serializer::serialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return stream.toString();
+}
+
+}
+
+void RecordSplitterTest::onRun() {
+
+  auto records = generateRecords(1000);
+  auto stream = concat(records);
+
+  /* stream fed in pieces of random size */
+  {
+    std::mt19937 random(42);
+    for(v_int32 maxPiece : {1, 3, 17, 256, 100000}) {
+      RecordSplitter splitter;
+      std::vector<std::string> result;
+      size_t position = 0;
+      while(position < stream.size()) {
+        auto piece = std::min(stream.size() - position, static_cast<size_t>(random() % maxPiece + 1));
+        splitter.feed(stream.data() + position, static_cast<v_buff_size>(piece));
+        position += piece;
+        oatpp::String record;
+        while(splitter.next(record)) {
+          result.push_back(*record);
+        }
+      }
+      OATPP_ASSERT(!splitter.getError().isSet())
+      OATPP_ASSERT(splitter.getPendingSize() == 0)
+      OATPP_ASSERT(result == records)
+    }
+  }
+
+  /* long markup fed in small pieces */
+  {
+    std::string record = "<r a='" + std::string(64 * 1024, '>') + "'><![CDATA[" + std::string(64 * 1024, ']') + "]]><!--" +
+                         std::string(64 * 1024, '-') + "-></r>";
+    RecordSplitter splitter;
+    std::vector<std::string> result;
+    for(size_t position = 0; position < record.size(); position += 16) {
+      auto piece = std::min<size_t>(16, record.size() - position);
+      splitter.feed(record.data() + position, static_cast<v_buff_size>(piece));
+      oatpp::String next;
+      while(splitter.next(next)) {
+        result.push_back(*next);
+      }
+    }
+    OATPP_ASSERT(!splitter.getError().isSet())
+    OATPP_ASSERT(result.size() == 1 && result[0] == record)
+  }
+
+  /* incomplete record */
+  {
+    RecordSplitter splitter;
+    splitter.feed("<a/><b><c/>", 11);
+    oatpp::String record;
+    OATPP_ASSERT(splitter.next(record) && record == "<a/>")
+    OATPP_ASSERT(!splitter.next(record))
+    OATPP_ASSERT(splitter.getPendingSize() == 7)
+    splitter.feed("</b>", 4);
+    OATPP_ASSERT(splitter.next(record) && record == "<b><c/></b>")
+  }
+
+  /* errors */
+  {
+    RecordSplitter splitter;
+    splitter.feed("<a/>\n</a>", 9);
+    oatpp::String record;
+    OATPP_ASSERT(splitter.next(record))
+    OATPP_ASSERT(!splitter.next(record))
+    OATPP_ASSERT(splitter.getError().getCode() == Error::Code::INVALID_CLOSING_TAG)
+    OATPP_ASSERT(splitter.getError().getPosition() == 5)
+  }
+
+  {
+    RecordSplitter splitter(16);
+    splitter.feed("<a>0123456789</a><b>", 20);
+    oatpp::String record;
+    OATPP_ASSERT(!splitter.next(record))
+    OATPP_ASSERT(splitter.getError().getCode() == Error::Code::DOCUMENT_SIZE_LIMIT_EXCEEDED)
+  }
+
+  auto mapper = std::make_shared<ObjectMapper>();
+
+  /* ordered results */
+  {
+    ParserPool pool(mapper, oatpp::Tree::Class::getType(), 4, 8);
+    std::thread producer([&] {
+      RecordSplitter splitter;
+      splitter.feed(stream.data(), static_cast<v_buff_size>(stream.size()));
+      oatpp::String record;
+      while(splitter.next(record)) {
+        pool.submit(record);
+      }
+      pool.submit("<broken attr=1/>");
+      pool.close();
+    });
+
+    ParserPool::Result result;
+    v_int64 index = 0;
+    while(pool.take(result)) {
+      OATPP_ASSERT(result.index == index)
+      if(index < static_cast<v_int64>(records.size())) {
+        OATPP_ASSERT(result.error == nullptr)
+        OATPP_ASSERT(toXml(result.value) == toXml(mapper->readFromString<oatpp::Tree>(records[static_cast<size_t>(index)].c_str())))
+      } else {
+        OATPP_ASSERT(result.value == nullptr)
+        OATPP_ASSERT(result.error != nullptr)
+      }
+      index ++;
+    }
+    producer.join();
+    OATPP_ASSERT(index == static_cast<v_int64>(records.size()) + 1)
+    OATPP_ASSERT(pool.submit("<a/>") == -1)
+  }
+
+  /* unordered results */
+  {
+    ParserPool pool(mapper, oatpp::Tree::Class::getType(), 4, 8, false);
+    std::thread producer([&] {
+      for(auto& record : records) {
+        pool.submit(oatpp::String(record));
+      }
+      pool.close();
+    });
+
+    std::vector<bool> seen(records.size(), false);
+    ParserPool::Result result;
+    while(pool.take(result)) {
+      auto index = static_cast<size_t>(result.index);
+      OATPP_ASSERT(!seen[index])
+      seen[index] = true;
+    }
+    producer.join();
+    for(auto flag : seen) {
+      OATPP_ASSERT(flag)
+    }
+  }
+
+  /* backpressure - submit blocks while capacity records are in flight */
+  {
+    ParserPool pool(mapper, oatpp::Tree::Class::getType(), 2, 2);
+    std::atomic<v_int32> submitted(0);
+    std::thread producer([&] {
+      for(v_int32 i = 0; i < 3; i ++) {
+        pool.submit("<a/>");
+        submitted ++;
+      }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    OATPP_ASSERT(submitted == 2)
+    ParserPool::Result result;
+    OATPP_ASSERT(pool.take(result))
+    producer.join();
+    OATPP_ASSERT(submitted == 3)
+    pool.close();
+    OATPP_ASSERT(pool.take(result))
+    OATPP_ASSERT(pool.take(result))
+    OATPP_ASSERT(!pool.take(result))
+  }
+
+}
+
+}}
@@ -0,0 +1,115 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ScannerBenchmark.hpp"
+
+#include "oatpp-xml/Scanner.hpp"
+#include "oatpp-xml/Deserializer.hpp"
+
+#include "oatpp/utils/parser/Caret.hpp"
+
+#include <chrono>
+#include <random>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/* CDATA of the given size filled with base64-like data with a lot of near-terminators */
+oatpp::String generateCData(v_buff_size size) {
+  static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/]>";
+  std::string data = "<![CDATA[";
+  data.reserve(static_cast<size_t>(size) + 16);
+  std::mt19937 random(42);
+  for(v_buff_size i = 0; i < size; i ++) {
+    data.push_back(alphabet[random() % 66]);
+  }
+  /* "]]>" must not appear inside */
+  for(size_t pos = data.find("]]>"); pos != std::string::npos; pos = data.find("]]>", pos)) {
+    data[pos] = 'A';
+  }
+  data += "]]>";
+  return oatpp::String(data);
+}
+
+}
+
+void ScannerBenchmark::onRun() {
+
+  /* UTF-8 validation */
+  {
+    const v_buff_size size = 100 * 1024 * 1024;
+    for(const std::string piece : {"ascii text ", "\xD1\x82\xD0\xB5\xD0\xBA\xD1\x81\xD1\x82 ", "\xE6\x96\x87\xE6\x9C\xAC"}) {
+      std::string data;
+      data.reserve(static_cast<size_t>(size) + piece.size());
+      while(static_cast<v_buff_size>(data.size()) < size) {
+        data += piece;
+      }
+      auto start = std::chrono::steady_clock::now();
+      OATPP_ASSERT(Scanner::findInvalidUtf8(data.data(), static_cast<v_buff_size>(data.size())) == -1)
+      auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+      OATPP_LOGd(TAG, "validate UTF-8 {} bytes of '{}': {} us", data.size(), piece, time)
+    }
+  }
+
+  /* large CDATA sections */
+  {
+    for(v_buff_size size : {1024 * 1024, 10 * 1024 * 1024, 100 * 1024 * 1024}) {
+
+      auto text = generateCData(size);
+
+      utils::parser::Caret caret(text);
+      caret.inc(9);
+      auto start = std::chrono::steady_clock::now();
+      OATPP_ASSERT(caret.findText("]]>", 3))
+      auto timeCaret = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+      start = std::chrono::steady_clock::now();
+      auto offset = Scanner::findText(text->data(), static_cast<v_buff_size>(text->size()), "]]>", 3);
+      auto timeScanner = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+      OATPP_ASSERT(offset == caret.getPosition())
+
+      Deserializer::Config config;
+      data::mapping::Tree tree;
+      utils::parser::Caret documentCaret(text);
+      Deserializer::State state;
+      state.tree = &tree;
+      state.caret = &documentCaret;
+      state.config = &config;
+      start = std::chrono::steady_clock::now();
+      Deserializer::deserialize(state);
+      auto timeParse = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+      OATPP_ASSERT(!state.error.isSet())
+
+      OATPP_LOGd(TAG, "CDATA {} bytes: Caret::findText - {} us, Scanner::findText - {} us, parse - {} us",
+                 size, timeCaret, timeScanner, timeParse)
+
+    }
+  }
+
+}
+
+}}
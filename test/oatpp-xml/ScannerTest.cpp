@@ -0,0 +1,198 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ScannerTest.hpp"
+
+#include "oatpp-xml/Scanner.hpp"
+#include "oatpp-xml/Deserializer.hpp"
+
+#include "oatpp/utils/parser/Caret.hpp"
+
+#include <random>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+v_buff_size find(const std::string& data, const std::string& text) {
+  return Scanner::findText(data.data(), static_cast<v_buff_size>(data.size()), text.data(), static_cast<v_buff_size>(text.size()));
+}
+
+v_buff_size expected(const std::string& data, const std::string& text) {
+  auto result = data.find(text);
+  return result == std::string::npos ? -1 : static_cast<v_buff_size>(result);
+}
+
+/* straightforward decoder - offset of the first invalid sequence or -1 */
+v_buff_size expectedInvalidUtf8(const std::string& data) {
+  size_t i = 0;
+  while(i < data.size()) {
+    auto c = static_cast<v_uint8>(data[i]);
+    size_t length;
+    v_uint32 code;
+    if(c < 0x80) { i ++; continue; }
+    else if(c >= 0xC2 && c <= 0xDF) { length = 2; code = c & 0x1F; }
+    else if(c >= 0xE0 && c <= 0xEF) { length = 3; code = c & 0x0F; }
+    else if(c >= 0xF0 && c <= 0xF4) { length = 4; code = c & 0x07; }
+    else return static_cast<v_buff_size>(i);
+    for(size_t j = 1; j < length; j ++) {
+      if(i + j >= data.size() || (static_cast<v_uint8>(data[i + j]) & 0xC0) != 0x80) {
+        return static_cast<v_buff_size>(i);
+      }
+      code = (code << 6) | (static_cast<v_uint8>(data[i + j]) & 0x3F);
+    }
+    bool overlong = (length == 3 && code < 0x800) || (length == 4 && code < 0x10000);
+    if(overlong || (code >= 0xD800 && code <= 0xDFFF) || code > 0x10FFFF) {
+      return static_cast<v_buff_size>(i);
+    }
+    i += length;
+  }
+  return -1;
+}
+
+v_buff_size findInvalidUtf8(const std::string& data) {
+  return Scanner::findInvalidUtf8(data.data(), static_cast<v_buff_size>(data.size()));
+}
+
+/* CDATA of the given size filled with base64-like data with a lot of near-terminators */
+oatpp::String generateCData(v_buff_size size) {
+  static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/]>";
+  std::string data = "<![CDATA[";
+  data.reserve(static_cast<size_t>(size) + 16);
+  std::mt19937 random(42);
+  for(v_buff_size i = 0; i < size; i ++) {
+    data.push_back(alphabet[random() % 66]);
+  }
+  /* "]]>" must not appear inside */
+  for(size_t pos = data.find("]]>"); pos != std::string::npos; pos = data.find("]]>", pos)) {
+    data[pos] = 'A';
+  }
+  data += "]]>";
+  return oatpp::String(data);
+}
+
+}
+
+void ScannerTest::onRun() {
+
+  /* correctness against std::string::find */
+  {
+    OATPP_ASSERT(find("", "]]>") == -1)
+    OATPP_ASSERT(find("]]", "]]>") == -1)
+    OATPP_ASSERT(find("]]>", "]]>") == 0)
+    OATPP_ASSERT(find("a?>", "?>") == 1)
+    OATPP_ASSERT(find("-", "-") == 0)
+
+    std::mt19937 random(42);
+    for(const std::string text : {"?>", "-->", "]]>", "x", "<!DOCTYPE"}) {
+      for(v_int32 i = 0; i < 20000; i ++) {
+        std::string data(random() % 100, 'a');
+        /* small alphabet made of the pattern chars produces lots of partial matches */
+        for(auto& c : data) {
+          c = text[random() % text.size()];
+          if(random() % 4 == 0) c = 'a';
+        }
+        OATPP_ASSERT(find(data, text) == expected(data, text))
+      }
+    }
+  }
+
+  /* match at every position of a vector block, including the tail */
+  {
+    for(size_t size = 3; size < 80; size ++) {
+      for(size_t pos = 0; pos + 3 <= size; pos ++) {
+        std::string data(size, ']');
+        data[size - 1] = 'a';
+        data.replace(pos, 3, "]]>");
+        OATPP_ASSERT(find(data, "]]>") == expected(data, "]]>"))
+      }
+    }
+  }
+
+  /* tag end - tag split at every position gives the same end */
+  {
+    std::string tag = "<a x=\"1>2\" y='\">' z=\"'\">tail";
+    OATPP_ASSERT(Scanner::findTagEnd(tag.data(), static_cast<v_buff_size>(tag.size())) == 24)
+    for(size_t split = 0; split <= tag.size(); split ++) {
+      char quote = 0;
+      auto end = Scanner::findTagEnd(tag.data(), static_cast<v_buff_size>(split), quote);
+      if(end < 0) {
+        end = Scanner::findTagEnd(tag.data() + split, static_cast<v_buff_size>(tag.size() - split), quote);
+        end += static_cast<v_buff_size>(split);
+      }
+      OATPP_ASSERT(end == 24)
+    }
+  }
+
+  /* UTF-8 validation */
+  {
+    OATPP_ASSERT(findInvalidUtf8("") == -1)
+    OATPP_ASSERT(findInvalidUtf8("plain ascii text which is longer than a vector block") == -1)
+    OATPP_ASSERT(findInvalidUtf8("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\xF4\x8F\xBF\xBF") == -1)
+    OATPP_ASSERT(findInvalidUtf8("ab\x80") == 2)              // stray continuation byte
+    OATPP_ASSERT(findInvalidUtf8("ab\xC0\xAF") == 2)          // overlong '/'
+    OATPP_ASSERT(findInvalidUtf8("ab\xE0\x80\xAF") == 2)      // overlong '/'
+    OATPP_ASSERT(findInvalidUtf8("ab\xED\xA0\x80") == 2)      // surrogate
+    OATPP_ASSERT(findInvalidUtf8("ab\xF4\x90\x80\x80") == 2)  // > U+10FFFF
+    OATPP_ASSERT(findInvalidUtf8("ab\xF0\x9F\x98") == 2)      // truncated
+    OATPP_ASSERT(findInvalidUtf8("0123456789abcdef0123\xC3(") == 20)
+
+    /* random sequences of valid and broken chars at every alignment */
+    static const char* pieces[] = {"a", "0123456789", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xEF\xBF\xBF",
+                                   "\x80", "\xC3", "\xE0\x9F\x80", "\xED\xBF\xBF", "\xF8", "\xF0\x8F\xBF\xBF"};
+    std::mt19937 random(42);
+    for(v_int32 i = 0; i < 50000; i ++) {
+      std::string data;
+      auto count = random() % 24;
+      for(size_t j = 0; j < count; j ++) {
+        data += pieces[random() % (random() % 8 == 0 ? 12 : 6)];
+      }
+      OATPP_ASSERT(findInvalidUtf8(data) == expectedInvalidUtf8(data))
+    }
+  }
+
+  /* large CDATA section with a lot of near-terminators */
+  {
+    auto text = generateCData(64 * 1024);
+
+    utils::parser::Caret caret(text);
+    caret.inc(9);
+    OATPP_ASSERT(caret.findText("]]>", 3))
+    OATPP_ASSERT(Scanner::findText(text->data(), static_cast<v_buff_size>(text->size()), "]]>", 3) == caret.getPosition())
+
+    Deserializer::Config config;
+    data::mapping::Tree tree;
+    utils::parser::Caret documentCaret(text);
+    Deserializer::State state;
+    state.tree = &tree;
+    state.caret = &documentCaret;
+    state.config = &config;
+    Deserializer::deserialize(state);
+    OATPP_ASSERT(!state.error.isSet())
+  }
+
+}
+
+}}
@@ -0,0 +1,165 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#include "SerializerBenchmark.hpp"
+#include "TestDocuments.hpp"
+
+#include "oatpp-xml/Deserializer.hpp"
+#include "oatpp-xml/ObjectMapper.hpp"
+#include "oatpp-xml/Serializer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/**
+ * Unbuffered file-backed stream - every write is a syscall, just like a socket.
+ */
+class FileStream : public data::stream::ConsistentOutputStream {
+private:
+  std::FILE* m_file;
+  data::stream::IOMode m_ioMode;
+public:
+
+  FileStream()
+    : m_file(std::tmpfile())
+    , m_ioMode(data::stream::IOMode::BLOCKING)
+  {
+    OATPP_ASSERT(m_file != nullptr)
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+  }
+
+  ~FileStream() override {
+    std::fclose(m_file);
+  }
+
+  v_io_size write(const void *data, v_buff_size count, async::Action& action) override {
+    (void) action;
+    return static_cast<v_io_size>(std::fwrite(data, 1, static_cast<size_t>(count), m_file));
+  }
+
+  void setOutputStreamIOMode(data::stream::IOMode ioMode) override {
+    m_ioMode = ioMode;
+  }
+
+  data::stream::IOMode getOutputStreamIOMode() override {
+    return m_ioMode;
+  }
+
+  data::stream::Context& getOutputStreamContext() override {
+    static data::stream::DefaultInitializedContext context(data::stream::StreamType::STREAM_FINITE);
+    return context;
+  }
+
+};
+
+data::mapping::Tree parse(const oatpp::String& text) {
+  data::mapping::Tree tree;
+  utils::parser::Caret caret(text);
+  Deserializer::Config config;
+  Deserializer::State state;
+  state.tree = &tree;
+  state.caret = &caret;
+  state.config = &config;
+  Deserializer::deserialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return tree;
+}
+
+template<class StreamFactory>
+v_int64 benchmarkSerialize(const data::mapping::Tree& tree, const Serializer::Config& config, v_int32 iterations, StreamFactory factory) {
+  Serializer::Context context;
+  auto start = std::chrono::steady_clock::now();
+  for(v_int32 i = 0; i < iterations; i ++) {
+    auto stream = factory();
+    Serializer::State state;
+    state.config = &config;
+    state.tree = &tree;
+    state.stream = stream.get();
+    state.context = &context;
+    Serializer::serialize(state);
+    OATPP_ASSERT(!state.error.isSet())
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+v_int64 benchmarkWriteToString(const oatpp::Tree& tree, v_buff_size twoPassThreshold, v_int32 iterations) {
+  ObjectMapper mapper;
+  mapper.serializerConfig().xml.twoPassThreshold = twoPassThreshold;
+  auto start = std::chrono::steady_clock::now();
+  for(v_int32 i = 0; i < iterations; i ++) {
+    mapper.writeToString(tree);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+}
+
+void SerializerBenchmark::onRun() {
+
+  auto text = generateRecordsDocument(1000, false);
+  auto tree = parse(text);
+
+  /* write-combining buffer vs direct writes */
+  {
+    Serializer::Config direct;
+    direct.writeBufferSize = 0;
+
+    Serializer::Config buffered;
+
+    auto bufferStream = [] { return std::make_shared<data::stream::BufferOutputStream>(); };
+    auto fileStream = [] { return std::make_shared<FileStream>(); };
+
+    benchmarkSerialize(tree, direct, 5, bufferStream); // warm up
+
+    auto bufferDirect = benchmarkSerialize(tree, direct, 50, bufferStream);
+    auto bufferBuffered = benchmarkSerialize(tree, buffered, 50, bufferStream);
+    OATPP_LOGd(TAG, "BufferOutputStream {} bytes x 50: direct - {} us, buffered - {} us", text->size(), bufferDirect, bufferBuffered)
+
+    auto fileDirect = benchmarkSerialize(tree, direct, 5, fileStream);
+    auto fileBuffered = benchmarkSerialize(tree, buffered, 5, fileStream);
+    OATPP_LOGd(TAG, "unbuffered file stream {} bytes x 5: direct - {} us, buffered - {} us", text->size(), fileDirect, fileBuffered)
+  }
+
+  /* two-pass writeToString vs growing buffer */
+  {
+    for(v_int32 recordsCount : {10, 1000, 20000}) {
+      oatpp::Tree value(parse(generateRecordsDocument(recordsCount, false)));
+      auto iterations = 2000000 / (recordsCount * 160) + 1;
+      benchmarkWriteToString(value, 0, 1); // warm up
+      auto timeGrowing = benchmarkWriteToString(value, 0, iterations);
+      auto timeTwoPass = benchmarkWriteToString(value, 64 * 1024, iterations);
+      OATPP_LOGd(TAG, "writeToString {} records x {}: growing buffer - {} us, two-pass - {} us", recordsCount, iterations, timeGrowing, timeTwoPass)
+    }
+  }
+
+}
+
+}}
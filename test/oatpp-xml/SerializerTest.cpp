@@ -0,0 +1,140 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "SerializerTest.hpp"
+#include "TestDocuments.hpp"
+
+#include "oatpp-xml/Deserializer.hpp"
+#include "oatpp-xml/ObjectMapper.hpp"
+#include "oatpp-xml/Serializer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+data::mapping::Tree parse(const oatpp::String& text) {
+  data::mapping::Tree tree;
+  utils::parser::Caret caret(text);
+  Deserializer::Config config;
+  Deserializer::State state;
+  state.tree = &tree;
+  state.caret = &caret;
+  state.config = &config;
+  Deserializer::deserialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return tree;
+}
+
+void serialize(const data::mapping::Tree& tree, data::stream::ConsistentOutputStream* stream,
+               const Serializer::Config& config, Serializer::Context* context = nullptr)
+{
+  Serializer::State state;
+  state.config = &config;
+  state.tree = &tree;
+  state.stream = stream;
+  state.context = context;
+  Serializer::serialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+}
+
+}
+
+void SerializerTest::onRun() {
+
+  auto text = generateRecordsDocument(1000, false);
+  auto tree = parse(text);
+
+  /* output doesn't depend on the write buffer size */
+  {
+    Serializer::Config config;
+    config.writeBufferSize = 0;
+
+    data::stream::BufferOutputStream ss;
+    serialize(tree, &ss, config);
+    auto expected = ss.toString();
+    OATPP_ASSERT(expected == text)
+
+    for(v_buff_size bufferSize : {1, 7, 64, 4096, 1024 * 1024}) {
+      config.writeBufferSize = bufferSize;
+      data::stream::BufferOutputStream result;
+      serialize(tree, &result, config);
+      OATPP_ASSERT(result.toString() == expected)
+    }
+  }
+
+  /* escaping across buffer boundaries */
+  {
+    data::mapping::Tree node;
+    node.setString("a < b & \"c\" ❤ > d");
+
+    for(v_buff_size bufferSize : {0, 1, 2, 3, 5, 4096}) {
+      Serializer::Config config;
+      config.writeBufferSize = bufferSize;
+      data::stream::BufferOutputStream result;
+      serialize(node, &result, config);
+      OATPP_ASSERT(result.toString() == "a &lt; b &amp; \"c\" &#10084; &gt; d")
+    }
+  }
+
+  /* binary node */
+  {
+    data::mapping::Tree node;
+    node["data"].setPairs({});
+    node["data"].getPairs().emplace_back("!BASE64", data::mapping::Tree());
+    node["data"].getPairs().back().second.setString(oatpp::String("foob"));
+
+    Serializer::Config config;
+    data::stream::BufferOutputStream result;
+    serialize(node, &result, config);
+    OATPP_ASSERT(result.toString() == "<data>Zm9vYg==</data>")
+  }
+
+  /* two-pass writeToString */
+  {
+    oatpp::Tree value(parse(text));
+
+    ObjectMapper mapper;
+    auto expected = mapper.writeToString(value);
+    OATPP_ASSERT(expected == text)
+
+    for(v_buff_size threshold : {1, 64, 4096, 1024 * 1024}) {
+      mapper.serializerConfig().xml.twoPassThreshold = threshold;
+      OATPP_ASSERT(mapper.writeToString(value) == expected)
+    }
+  }
+
+  {
+    oatpp::Tree value;
+    value->setString("a < b & \"c\" \n ❤ > d");
+
+    ObjectMapper mapper;
+    mapper.serializerConfig().xml.twoPassThreshold = 2;
+    OATPP_ASSERT(mapper.writeToString(value) == "a &lt; b &amp; \"c\" &#10; &#10084; &gt; d")
+  }
+
+}
+
+}}
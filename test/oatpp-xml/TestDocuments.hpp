@@ -0,0 +1,62 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#ifndef OATPP_XML_TESTDOCUMENTS_HPP
+#define OATPP_XML_TESTDOCUMENTS_HPP
+
+#include "oatpp/data/stream/BufferStream.hpp"
+#include "oatpp/Types.hpp"
+
+namespace oatpp { namespace xml {
+
+/**
+ * Generate a document of `<record>` elements shared by tests and benchmarks. <br>
+ * Each record has attributes, entities, a comment and CDATA.
+ * @param recordsCount - count of records.
+ * @param indent - put the prolog and indented records on separate lines. <br>
+ * Without indentation the document is serialized back to the same text.
+ * @return - document text.
+ */
+inline oatpp::String generateRecordsDocument(v_int32 recordsCount, bool indent = true) {
+  const char* open = indent ? "\n  " : "";
+  const char* field = indent ? "\n    " : "";
+  data::stream::BufferOutputStream ss;
+  if(indent) {
+    ss << "<?xml version=\"1.0\"?>\n";
+  }
+  ss << "<records>";
+  for(v_int32 i = 0; i < recordsCount; i ++) {
+    ss << open << "<record id=\"" << i << "\" type=\"test &amp; &quot;quoted&quot;\">";
+    ss << field << "<name>Record &amp; name " << i << "</name>";
+    ss << field << "<value>" << i * 7 << "</value>";
+    ss << field << "<!-- comment -->";
+    ss << field << "<data><![CDATA[<raw data>]]></data>";
+    ss << open << "</record>";
+  }
+  ss << (indent ? "\n</records>\n" : "</records>");
+  return ss.toString();
+}
+
+}}
+
+#endif /* OATPP_XML_TESTDOCUMENTS_HPP */
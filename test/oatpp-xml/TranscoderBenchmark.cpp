@@ -0,0 +1,80 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "TranscoderBenchmark.hpp"
+
+#include "oatpp-xml/Transcoder.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <chrono>
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/* UTF-8 -> UTF-16LE, input is known to be valid and has no characters outside of the BMP */
+std::string toUtf16(const std::string& text) {
+  std::string result;
+  result.reserve(text.size() * 2);
+  for(size_t i = 0; i < text.size();) {
+    auto c = static_cast<v_uint8>(text[i]);
+    v_uint32 code;
+    size_t length;
+    if(c < 0x80) { code = c; length = 1; }
+    else if(c < 0xE0) { code = c & 0x1F; length = 2; }
+    else { code = c & 0x0F; length = 3; }
+    for(size_t j = 1; j < length; j ++) {
+      code = (code << 6) | (static_cast<v_uint8>(text[i + j]) & 0x3F);
+    }
+    result.push_back(static_cast<char>(code & 0xFF));
+    result.push_back(static_cast<char>(code >> 8));
+    i += length;
+  }
+  return result;
+}
+
+}
+
+void TranscoderBenchmark::onRun() {
+
+  std::string document;
+  while(document.size() < 32 * 1024 * 1024) {
+    document += "<record id=\"1\"><name>some record name</name><note>caf\xC3\xA9</note></record>";
+  }
+  auto data = toUtf16(document);
+
+  data::stream::BufferOutputStream stream(static_cast<v_buff_size>(document.size()));
+  Transcoder transcoder(Transcoder::Encoding::UTF_16LE);
+  auto start = std::chrono::steady_clock::now();
+  OATPP_ASSERT(transcoder.transcode(data.data(), static_cast<v_buff_size>(data.size()), &stream) && transcoder.finish())
+  auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  OATPP_ASSERT(stream.getCurrentPosition() == static_cast<v_buff_size>(document.size()))
+
+  OATPP_LOGd(TAG, "transcode {} bytes of UTF-16LE: {} us", data.size(), time)
+
+}
+
+}}
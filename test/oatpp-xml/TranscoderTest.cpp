@@ -0,0 +1,225 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "TranscoderTest.hpp"
+
+#include "oatpp-xml/ObjectMapper.hpp"
+#include "oatpp-xml/Transcoder.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <string>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+/* UTF-8 -> UTF-16, input is known to be valid */
+std::string toUtf16(const std::string& text, bool bigEndian) {
+  std::string result;
+  auto putUnit = [&](v_uint32 unit) {
+    auto low = static_cast<char>(unit & 0xFF);
+    auto high = static_cast<char>(unit >> 8);
+    if(bigEndian) {
+      result.push_back(high);
+      result.push_back(low);
+    } else {
+      result.push_back(low);
+      result.push_back(high);
+    }
+  };
+  for(size_t i = 0; i < text.size();) {
+    auto c = static_cast<v_uint8>(text[i]);
+    v_uint32 code;
+    size_t length;
+    if(c < 0x80) { code = c; length = 1; }
+    else if(c < 0xE0) { code = c & 0x1F; length = 2; }
+    else if(c < 0xF0) { code = c & 0x0F; length = 3; }
+    else { code = c & 0x07; length = 4; }
+    for(size_t j = 1; j < length; j ++) {
+      code = (code << 6) | (static_cast<v_uint8>(text[i + j]) & 0x3F);
+    }
+    if(code >= 0x10000) {
+      putUnit(0xD800 + ((code - 0x10000) >> 10));
+      putUnit(0xDC00 + ((code - 0x10000) & 0x3FF));
+    } else {
+      putUnit(code);
+    }
+    i += length;
+  }
+  return result;
+}
+
+/* transcode feeding the data in pieces of the given size */
+bool transcode(Transcoder::Encoding encoding, const std::string& data, size_t pieceSize, std::string& result) {
+  data::stream::BufferOutputStream stream;
+  Transcoder transcoder(encoding);
+  for(size_t i = 0; i < data.size(); i += pieceSize) {
+    auto size = std::min(pieceSize, data.size() - i);
+    if(!transcoder.transcode(data.data() + i, static_cast<v_buff_size>(size), &stream)) {
+      return false;
+    }
+  }
+  if(!transcoder.finish()) {
+    return false;
+  }
+  result = stream.toString();
+  return true;
+}
+
+v_buff_size errorPosition(Transcoder::Encoding encoding, const std::string& data) {
+  data::stream::BufferOutputStream stream;
+  Transcoder transcoder(encoding);
+  if(transcoder.transcode(data.data(), static_cast<v_buff_size>(data.size()), &stream) && transcoder.finish()) {
+    return -1;
+  }
+  OATPP_ASSERT(transcoder.getError().getCode() == Error::Code::INVALID_CHARACTER)
+  return transcoder.getError().getPosition();
+}
+
+Transcoder::Encoding detect(const std::string& data, v_buff_size expectedBomSize = 0) {
+  v_buff_size bomSize;
+  auto encoding = Transcoder::detect(data.data(), static_cast<v_buff_size>(data.size()), bomSize);
+  OATPP_ASSERT(bomSize == expectedBomSize)
+  return encoding;
+}
+
+}
+
+void TranscoderTest::onRun() {
+
+  const std::string text =
+    "<?xml version=\"1.0\"?><r a='\xC3\xA9t\xC3\xA9'><t>plain ascii text which spans several vector blocks</t>"
+    "<t>caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 \xEF\xBF\xBF</t></r>";
+
+  /* detection */
+  {
+    OATPP_ASSERT(detect("<r/>") == Transcoder::Encoding::UTF_8)
+    OATPP_ASSERT(detect("") == Transcoder::Encoding::UTF_8)
+    OATPP_ASSERT(detect("\xEF\xBB\xBF<r/>", 3) == Transcoder::Encoding::UTF_8)
+    OATPP_ASSERT(detect("\xFF\xFE<\0r\0", 2) == Transcoder::Encoding::UTF_16LE)
+    OATPP_ASSERT(detect(std::string("\xFE\xFF\0<\0r", 6), 2) == Transcoder::Encoding::UTF_16BE)
+    OATPP_ASSERT(detect(toUtf16("<r/>", false)) == Transcoder::Encoding::UTF_16LE)
+    OATPP_ASSERT(detect(toUtf16("<r/>", true)) == Transcoder::Encoding::UTF_16BE)
+    OATPP_ASSERT(detect("<?xml version='1.0' encoding='ISO-8859-1'?><r/>") == Transcoder::Encoding::ISO_8859_1)
+    OATPP_ASSERT(detect("<?xml version=\"1.0\" encoding = \"latin1\" ?><r/>") == Transcoder::Encoding::ISO_8859_1)
+    OATPP_ASSERT(detect("<?xml version='1.0' encoding='utf-8'?><r/>") == Transcoder::Encoding::UTF_8)
+    OATPP_ASSERT(detect("<?xml version='1.0'?><r encoding='latin1'/>") == Transcoder::Encoding::UTF_8)
+    OATPP_ASSERT(detect("<?xml-stylesheet encoding='latin1'?><r/>") == Transcoder::Encoding::UTF_8)
+    OATPP_ASSERT(detect("<?xml version='1.0' encoding='KOI8-R'?><r/>") == Transcoder::Encoding::UNKNOWN)
+    OATPP_ASSERT(detect("<?xml version='1.0' encoding='UTF-16'?><r/>") == Transcoder::Encoding::UNKNOWN)
+  }
+
+  /* UTF-16 - every piece size, so that code units and surrogate pairs are split at every position */
+  {
+    for(bool bigEndian : {false, true}) {
+      auto encoding = bigEndian ? Transcoder::Encoding::UTF_16BE : Transcoder::Encoding::UTF_16LE;
+      auto data = toUtf16(text, bigEndian);
+      for(size_t pieceSize = 1; pieceSize <= data.size(); pieceSize += (pieceSize < 40 ? 1 : 37)) {
+        std::string result;
+        OATPP_ASSERT(transcode(encoding, data, pieceSize, result))
+        OATPP_ASSERT(result == text)
+      }
+    }
+  }
+
+  /* ISO-8859-1 */
+  {
+    std::string data;
+    std::string expected;
+    for(v_int32 c = 1; c < 256; c ++) {
+      data.push_back(static_cast<char>(c));
+      if(c < 0x80) {
+        expected.push_back(static_cast<char>(c));
+      } else {
+        expected.push_back(static_cast<char>(0xC0 | (c >> 6)));
+        expected.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+      }
+    }
+    for(size_t pieceSize : {1, 7, 16, 255}) {
+      std::string result;
+      OATPP_ASSERT(transcode(Transcoder::Encoding::ISO_8859_1, data, pieceSize, result))
+      OATPP_ASSERT(result == expected)
+    }
+  }
+
+  /* invalid UTF-16 */
+  {
+    auto le = Transcoder::Encoding::UTF_16LE;
+    OATPP_ASSERT(errorPosition(le, std::string("a\0\x00\xDC", 4)) == 2)       // unpaired low surrogate
+    OATPP_ASSERT(errorPosition(le, std::string("a\0\x00\xD8" "b\0", 6)) == 2) // high surrogate without low
+    OATPP_ASSERT(errorPosition(le, std::string("a\0\x00\xD8", 4)) == 2)       // high surrogate at the end
+    OATPP_ASSERT(errorPosition(le, std::string("a\0b", 3)) == 2)              // odd size
+  }
+
+  /* object mapper - non-UTF-8 input gives the same tree as UTF-8 */
+  {
+    ObjectMapper mapper;
+    auto expected = mapper.writeToString(mapper.readFromString<oatpp::Tree>(text.c_str()));
+
+    for(const auto& data : {"\xEF\xBB\xBF" + text, "\xFF\xFE" + toUtf16(text, false), toUtf16(text, true)}) {
+      utils::parser::Caret caret(data.data(), static_cast<v_buff_size>(data.size()));
+      data::mapping::ErrorStack errorStack;
+      auto result = mapper.read(caret, oatpp::Tree::Class::getType(), errorStack);
+      OATPP_ASSERT(errorStack.empty())
+      OATPP_ASSERT(mapper.writeToString(result) == expected)
+    }
+
+    {
+      std::string data = "<?xml version='1.0' encoding='ISO-8859-1'?><r>caf\xE9</r>";
+      utils::parser::Caret caret(data.data(), static_cast<v_buff_size>(data.size()));
+      data::mapping::ErrorStack errorStack;
+      auto result = mapper.read(caret, oatpp::Tree::Class::getType(), errorStack);
+      OATPP_ASSERT(errorStack.empty())
+      auto xml = mapper.writeToString(result);
+      /* serializer escapes non-ASCII chars */
+      OATPP_ASSERT(xml->find("<r>caf&#233;</r>") != std::string::npos)
+    }
+
+    {
+      std::string data = "<?xml version='1.0' encoding='KOI8-R'?><r/>";
+      utils::parser::Caret caret(data.data(), static_cast<v_buff_size>(data.size()));
+      data::mapping::ErrorStack errorStack;
+      OATPP_ASSERT(!mapper.read(caret, oatpp::Tree::Class::getType(), errorStack))
+      OATPP_ASSERT(!errorStack.empty())
+    }
+  }
+
+  /* a document of many output blocks */
+  {
+    std::string document;
+    while(document.size() < 64 * 1024) {
+      document += "<record id=\"1\"><name>some record name</name><note>caf\xC3\xA9</note></record>";
+    }
+    auto data = toUtf16(document, false);
+
+    data::stream::BufferOutputStream stream(static_cast<v_buff_size>(document.size()));
+    Transcoder transcoder(Transcoder::Encoding::UTF_16LE);
+    OATPP_ASSERT(transcoder.transcode(data.data(), static_cast<v_buff_size>(data.size()), &stream) && transcoder.finish())
+    OATPP_ASSERT(*stream.toString() == document)
+  }
+
+}
+
+}}
@@ -120,8 +120,8 @@ void UtilsTest::onRun() {
 
     Deserializer::parseAttributes(state);
 
-    if(!state.errorStack.empty()) {
-      OATPP_LOGe(TAG, "stacktrace:\n{}", state.errorStack.stacktrace())
+    if(state.error.isSet()) {
+      OATPP_LOGe(TAG, "error: {}", state.error.toString("parseAttributes", text->data(), static_cast<v_buff_size>(text->size())))
     }
 
     for(v_int32 i = 0; i < tree.attributes().size(); i ++) {
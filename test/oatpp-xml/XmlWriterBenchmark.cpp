@@ -0,0 +1,94 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "XmlWriterBenchmark.hpp"
+
+#include "oatpp-xml/XmlWriter.hpp"
+#include "oatpp-xml/Serializer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <chrono>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+void writeRecords(XmlWriter& writer, v_int32 recordsCount) {
+  writer.startElement("records");
+  for(v_int32 i = 0; i < recordsCount; i ++) {
+    writer.startElement("record");
+    writer.value(i);
+    writer.endElement("record");
+  }
+  writer.endElement("records");
+}
+
+}
+
+void XmlWriterBenchmark::onRun() {
+
+  /* stream records vs build a tree and serialize it */
+  {
+    v_int32 recordsCount = 100000;
+
+    data::stream::BufferOutputStream streamed;
+    auto start = std::chrono::steady_clock::now();
+    {
+      XmlWriter writer(&streamed);
+      writeRecords(writer, recordsCount);
+    }
+    auto timeWriter = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    data::stream::BufferOutputStream serialized;
+    start = std::chrono::steady_clock::now();
+    {
+      data::mapping::Tree tree;
+      tree.setPairs({});
+      auto& records = tree.getPairs();
+      records.emplace_back("records", data::mapping::Tree());
+      records.back().second.setPairs({});
+      auto& items = records.back().second.getPairs();
+      for(v_int32 i = 0; i < recordsCount; i ++) {
+        items.emplace_back("record", data::mapping::Tree());
+        items.back().second.setPrimitive<v_int32>(i);
+      }
+      Serializer::Config config;
+      Serializer::State state;
+      state.config = &config;
+      state.tree = &tree;
+      state.stream = &serialized;
+      Serializer::serialize(state);
+      OATPP_ASSERT(!state.error.isSet())
+    }
+    auto timeTree = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    OATPP_ASSERT(streamed.toString() == serialized.toString())
+
+    OATPP_LOGd(TAG, "{} records: XmlWriter - {} us, Tree + Serializer - {} us", recordsCount, timeWriter, timeTree)
+  }
+
+}
+
+}}
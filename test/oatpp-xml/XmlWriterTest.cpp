@@ -0,0 +1,234 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "XmlWriterTest.hpp"
+
+#include "oatpp-xml/XmlWriter.hpp"
+#include "oatpp-xml/Deserializer.hpp"
+#include "oatpp-xml/Serializer.hpp"
+
+#include "oatpp/data/stream/BufferStream.hpp"
+
+#include <stdexcept>
+
+namespace oatpp { namespace xml {
+
+namespace {
+
+void writeRecords(XmlWriter& writer, v_int32 recordsCount) {
+  writer.startElement("records");
+  for(v_int32 i = 0; i < recordsCount; i ++) {
+    writer.startElement("record");
+    writer.value(i);
+    writer.endElement("record");
+  }
+  writer.endElement("records");
+}
+
+void writeReport(XmlWriter& writer, v_int32 recordsCount) {
+  writer.pi("xml", "version=\"1.0\"");
+  writer.startElement("records");
+  for(v_int32 i = 0; i < recordsCount; i ++) {
+    auto id = std::to_string(i);
+    writer.startElement("record");
+    writer.attribute("id", id.data());
+    writer.attribute("type", "test & \"quoted\"");
+    writer.startElement("name");
+    writer.text("Record & name ");
+    writer.value(i);
+    writer.endElement("name");
+    writer.startElement("value");
+    writer.value(i * 7);
+    writer.endElement("value");
+    writer.comment(" comment ");
+    writer.startElement("data");
+    writer.cdata("<raw data>");
+    writer.endElement("data");
+    writer.endElement("record");
+  }
+  writer.endElement("records");
+}
+
+oatpp::String serializeTree(const oatpp::String& text) {
+
+  data::mapping::Tree tree;
+  {
+    utils::parser::Caret caret(text);
+    Deserializer::Config config;
+    Deserializer::State state;
+    state.tree = &tree;
+    state.caret = &caret;
+    state.config = &config;
+    Deserializer::deserialize(state);
+    OATPP_ASSERT(!state.error.isSet())
+  }
+
+  data::stream::BufferOutputStream stream;
+  Serializer::Config config;
+  Serializer::State state;
+  state.config = &config;
+  state.tree = &tree;
+  state.stream = &stream;
+  Serializer::serialize(state);
+  OATPP_ASSERT(!state.error.isSet())
+  return stream.toString();
+
+}
+
+}
+
+void XmlWriterTest::onRun() {
+
+  /* basic output */
+  {
+    data::stream::BufferOutputStream stream;
+    {
+      XmlWriter writer(&stream);
+      writer.startElement("a");
+      writer.attribute("x", "1 < 2");
+      writer.startElement("b");
+      writer.endElement("b");
+      writer.text("t&t");
+      writer.startElement(oatpp::String("c"));
+      writer.value(true);
+      writer.value(1.5);
+      writer.endElement(oatpp::String("c"));
+      writer.endElement("a");
+    }
+    OATPP_ASSERT(stream.toString() == "<a x=\"1 &lt; 2\"><b/>t&amp;t<c>true1.5</c></a>")
+  }
+
+  /* invalid characters are reported */
+  {
+    data::stream::BufferOutputStream stream;
+    XmlWriter writer(&stream, 0);
+    writer.startElement("a");
+    OATPP_ASSERT(!writer.attribute("x", "\xC3"))
+    OATPP_ASSERT(!writer.text("\xC3", 1))
+  }
+
+  /* terminators inside CDATA, comments and PIs */
+  {
+    data::stream::BufferOutputStream stream;
+    {
+      XmlWriter writer(&stream);
+      writer.startElement("a");
+      writer.cdata("x]]>y]]]>z]]");
+      OATPP_ASSERT(!writer.comment("a--b"))
+      OATPP_ASSERT(!writer.comment("ends with -"))
+      OATPP_ASSERT(writer.comment(" - ok - "))
+      OATPP_ASSERT(!writer.pi("pi", "x?>y"))
+      writer.endElement("a");
+    }
+    auto text = stream.toString();
+    OATPP_ASSERT(text == "<a><![CDATA[x]]]]><![CDATA[>y]]]]]><![CDATA[>z]]]]><!-- - ok - --></a>")
+
+    Deserializer::Config config;
+    config.mergeCData = true;
+    config.skipComments = true;
+    data::mapping::Tree tree;
+    utils::parser::Caret caret(text);
+    Deserializer::State state;
+    state.tree = &tree;
+    state.caret = &caret;
+    state.config = &config;
+    Deserializer::deserialize(state);
+    OATPP_ASSERT(!state.error.isSet())
+    OATPP_ASSERT(tree.getPairs()[0].second.getString() == "x]]>y]]]>z]]")
+  }
+
+  /* same output as the tree serializer */
+  {
+    data::stream::BufferOutputStream stream;
+    {
+      XmlWriter writer(&stream, 64);
+      writeReport(writer, 10);
+    }
+    auto text = stream.toString();
+    OATPP_ASSERT(text == serializeTree(text))
+  }
+
+#ifndef NDEBUG
+  /* nesting is checked in debug builds */
+  {
+    data::stream::BufferOutputStream stream;
+    XmlWriter writer(&stream);
+    writer.startElement("a");
+    writer.startElement("b");
+    bool thrown = false;
+    try {
+      writer.endElement("a");
+    } catch (std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown)
+
+    thrown = false;
+    try {
+      writer.text("t");
+      writer.attribute("x", "1");
+    } catch (std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown)
+  }
+#endif
+
+  /* streamed records are the same as the serialized tree */
+  {
+    v_int32 recordsCount = 100;
+
+    data::stream::BufferOutputStream streamed;
+    {
+      XmlWriter writer(&streamed);
+      writeRecords(writer, recordsCount);
+    }
+
+    data::stream::BufferOutputStream serialized;
+    {
+      data::mapping::Tree tree;
+      tree.setPairs({});
+      auto& records = tree.getPairs();
+      records.emplace_back("records", data::mapping::Tree());
+      records.back().second.setPairs({});
+      auto& items = records.back().second.getPairs();
+      for(v_int32 i = 0; i < recordsCount; i ++) {
+        items.emplace_back("record", data::mapping::Tree());
+        items.back().second.setPrimitive<v_int32>(i);
+      }
+      Serializer::Config config;
+      Serializer::State state;
+      state.config = &config;
+      state.tree = &tree;
+      state.stream = &serialized;
+      Serializer::serialize(state);
+      OATPP_ASSERT(!state.error.isSet())
+    }
+
+    OATPP_ASSERT(streamed.toString() == serialized.toString())
+  }
+
+}
+
+}}
@@ -0,0 +1,57 @@
+
+#include "Base64Benchmark.hpp"
+#include "DeserializerBenchmark.hpp"
+#include "DocumentBenchmark.hpp"
+#include "FragmentCacheBenchmark.hpp"
+#include "NameIndexBenchmark.hpp"
+#include "NameTableBenchmark.hpp"
+#include "NumberFormatBenchmark.hpp"
+#include "ObjectSerializerBenchmark.hpp"
+#include "ParseCacheBenchmark.hpp"
+#include "PullReaderBenchmark.hpp"
+#include "RecordSplitterBenchmark.hpp"
+#include "ScannerBenchmark.hpp"
+#include "SerializerBenchmark.hpp"
+#include "TranscoderBenchmark.hpp"
+#include "XmlWriterBenchmark.hpp"
+
+#include <iostream>
+
+namespace {
+
+void runBenchmarks() {
+  OATPP_RUN_TEST(oatpp::xml::Base64Benchmark);
+  OATPP_RUN_TEST(oatpp::xml::DeserializerBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::DocumentBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::FragmentCacheBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::NameIndexBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::NameTableBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::NumberFormatBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::ObjectSerializerBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::ParseCacheBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::PullReaderBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::RecordSplitterBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::ScannerBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::SerializerBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::TranscoderBenchmark);
+  OATPP_RUN_TEST(oatpp::xml::XmlWriterBenchmark);
+}
+
+}
+
+int main() {
+
+  oatpp::Environment::init();
+
+  runBenchmarks();
+
+  std::cout << "\nEnvironment:\n";
+  std::cout << "objectsCount = " << oatpp::Environment::getObjectsCount() << "\n";
+  std::cout << "objectsCreated = " << oatpp::Environment::getObjectsCreated() << "\n\n";
+
+  OATPP_ASSERT(oatpp::Environment::getObjectsCount() == 0);
+
+  oatpp::Environment::destroy();
+
+  return 0;
+}
@@ -1,12 +1,42 @@
 
+#include "Base64Test.hpp"
+#include "DeserializerTest.hpp"
+#include "DocumentTest.hpp"
+#include "FragmentCacheTest.hpp"
+#include "NameIndexTest.hpp"
+#include "NameTableTest.hpp"
+#include "NumberFormatTest.hpp"
+#include "ObjectSerializerTest.hpp"
+#include "ParseCacheTest.hpp"
+#include "PullReaderTest.hpp"
+#include "RecordSplitterTest.hpp"
+#include "ScannerTest.hpp"
+#include "SerializerTest.hpp"
+#include "TranscoderTest.hpp"
 #include "UtilsTest.hpp"
+#include "XmlWriterTest.hpp"
 
 #include <iostream>
 
 namespace {
 
 void runTests() {
+  OATPP_RUN_TEST(oatpp::xml::Base64Test);
+  OATPP_RUN_TEST(oatpp::xml::DeserializerTest);
+  OATPP_RUN_TEST(oatpp::xml::DocumentTest);
+  OATPP_RUN_TEST(oatpp::xml::FragmentCacheTest);
+  OATPP_RUN_TEST(oatpp::xml::NameIndexTest);
+  OATPP_RUN_TEST(oatpp::xml::NameTableTest);
+  OATPP_RUN_TEST(oatpp::xml::NumberFormatTest);
+  OATPP_RUN_TEST(oatpp::xml::ObjectSerializerTest);
+  OATPP_RUN_TEST(oatpp::xml::ParseCacheTest);
+  OATPP_RUN_TEST(oatpp::xml::PullReaderTest);
+  OATPP_RUN_TEST(oatpp::xml::RecordSplitterTest);
+  OATPP_RUN_TEST(oatpp::xml::ScannerTest);
+  OATPP_RUN_TEST(oatpp::xml::SerializerTest);
+  OATPP_RUN_TEST(oatpp::xml::TranscoderTest);
   OATPP_RUN_TEST(oatpp::xml::UtilsTest);
+  OATPP_RUN_TEST(oatpp::xml::XmlWriterTest);
 }
 
 }